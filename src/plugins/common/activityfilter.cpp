@@ -0,0 +1,91 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "activityfilter.h"
+#include "idlebackend.h"
+#include "idlestatistics.h"
+
+ActivityFilter::ActivityFilter(IdleActivitySink *engine, IdleClock *clock, int64_t quantum)
+    : m_engine(engine)
+    , m_clock(clock)
+    , m_statistics(0)
+    , m_quantum(quantum)
+    , m_lastForwarded(0)
+    , m_eventsSeen(0)
+    , m_inputEventsSeen(0)
+    , m_eventsForwarded(0)
+{
+}
+
+void ActivityFilter::setQuantum(int64_t msecs)
+{
+    m_quantum = msecs > 0 ? msecs : 0;
+}
+
+void ActivityFilter::setStatistics(IdleStatistics *statistics)
+{
+    m_statistics = statistics;
+}
+
+int64_t ActivityFilter::quantum() const
+{
+    return m_quantum;
+}
+
+bool ActivityFilter::event(EventClass eventClass, int64_t timestamp)
+{
+    ++m_eventsSeen;
+    if (m_statistics) {
+        m_statistics->increment(IdleStatistics::NativeEvents);
+    }
+    if (eventClass != InputEvent) {
+        return false;
+    }
+    ++m_inputEventsSeen;
+    if (m_eventsForwarded && timestamp - m_lastForwarded < m_quantum) {
+        return false;
+    }
+    m_lastForwarded = timestamp;
+    ++m_eventsForwarded;
+    if (m_statistics) {
+        m_statistics->increment(IdleStatistics::EventsActedOn);
+    }
+    m_engine->activityAt(timestamp);
+    return true;
+}
+
+bool ActivityFilter::event(EventClass eventClass)
+{
+    // don't read the clock for events that will be ignored anyway
+    return event(eventClass, eventClass == InputEvent ? m_clock->now() : 0);
+}
+
+int64_t ActivityFilter::eventsSeen() const
+{
+    return m_eventsSeen;
+}
+
+int64_t ActivityFilter::inputEventsSeen() const
+{
+    return m_inputEventsSeen;
+}
+
+int64_t ActivityFilter::eventsForwarded() const
+{
+    return m_eventsForwarded;
+}
@@ -0,0 +1,101 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef ACTIVITYFILTER_H
+#define ACTIVITYFILTER_H
+
+#include <stdint.h>
+
+class IdleActivitySink;
+class IdleClock;
+class IdleStatistics;
+
+/**
+ * Sits between a native event filter and the IdleTimeoutEngine. Native event filters
+ * tend to see every event the application receives, and input devices can generate
+ * hundreds of events per second; reporting each of them to the engine would mean as
+ * many idle time queries.
+ *
+ * The platform code classifies each event; only input events are considered. The first
+ * input event after a quiet period is forwarded immediately (so that resuming from idle
+ * is detected without delay), subsequent ones are dropped until the coalescing quantum
+ * has elapsed. The engine thus sees at most one "activity at time T" update per quantum.
+ * The activity that is dropped at the end of a burst only makes the engine's view of the
+ * last activity up to one quantum too old; the real idle time is verified against the
+ * system before a timeout is reported.
+ */
+class ActivityFilter
+{
+public:
+    enum EventClass {
+        /**
+         * keyboard, pointer, tablet or other user input
+         */
+        InputEvent,
+        /**
+         * anything else (paint, timer, window management, ...): not an indication of activity
+         */
+        OtherEvent
+    };
+
+    /**
+     * @param clock : the engine's clock, used to timestamp the events
+     * @param quantum : the minimum time between two updates sent to the engine, in milliseconds.
+     */
+    ActivityFilter(IdleActivitySink *engine, IdleClock *clock, int64_t quantum = 50);
+
+    void setQuantum(int64_t msecs);
+    /**
+     * also count the native events and the updates sent to the engine in @p statistics
+     * (typically the engine's), or stop doing so when null.
+     */
+    void setStatistics(IdleStatistics *statistics);
+    int64_t quantum() const;
+
+    /**
+     * to be called for each native event.
+     * @param eventClass : the classification of the event by the platform code
+     * @param timestamp : the time of the event on the engine's clock, in milliseconds
+     * @returns true if the event was forwarded to the engine
+     */
+    bool event(EventClass eventClass, int64_t timestamp);
+    /**
+     * overload for events that happened just now.
+     */
+    bool event(EventClass eventClass);
+
+    /**
+     * @returns the number of events seen, the number of input events among them,
+     * and the number of updates sent to the engine.
+     */
+    int64_t eventsSeen() const;
+    int64_t inputEventsSeen() const;
+    int64_t eventsForwarded() const;
+
+private:
+    IdleActivitySink *m_engine;
+    IdleClock *m_clock;
+    IdleStatistics *m_statistics;
+    int64_t m_quantum;
+    int64_t m_lastForwarded;
+    int64_t m_eventsSeen,
+        m_inputEventsSeen,
+        m_eventsForwarded;
+};
+
+#endif /* ACTIVITYFILTER_H */
@@ -0,0 +1,181 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "activitytrace.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+
+const char Magic[4] = { 'K', 'I', 'D', 'T' };
+const uint8_t Version = 1;
+const size_t HeaderSize = 16;
+
+}
+
+ActivityTraceWriter::ActivityTraceWriter(int64_t origin)
+{
+    clear(origin);
+}
+
+void ActivityTraceWriter::clear(int64_t origin)
+{
+    m_data.assign(Magic, Magic + 4);
+    m_data.push_back(Version);
+    m_data.resize(HeaderSize, 0);
+    for (int i = 0; i < 8; ++i) {
+        m_data[8 + i] = uint8_t(uint64_t(origin) >> (8 * i));
+    }
+    m_last = origin;
+    m_count = 0;
+}
+
+void ActivityTraceWriter::append(int64_t timestamp)
+{
+    uint64_t delta = timestamp > m_last ? uint64_t(timestamp - m_last) : 0;
+    m_last += int64_t(delta);
+    do {
+        uint8_t byte = delta & 0x7f;
+        delta >>= 7;
+        if (delta) {
+            byte |= 0x80;
+        }
+        m_data.push_back(byte);
+    } while (delta);
+    ++m_count;
+}
+
+int64_t ActivityTraceWriter::count() const
+{
+    return m_count;
+}
+
+const std::vector<uint8_t> &ActivityTraceWriter::data() const
+{
+    return m_data;
+}
+
+bool ActivityTraceWriter::save(const std::string &fileName) const
+{
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = fwrite(m_data.data(), 1, m_data.size(), file) == m_data.size();
+    return fclose(file) == 0 && written;
+}
+
+ActivityTraceReader::ActivityTraceReader()
+    : m_data(0)
+    , m_size(0)
+{
+    parseHeader();
+}
+
+ActivityTraceReader::ActivityTraceReader(const uint8_t *data, size_t size)
+    : m_data(data)
+    , m_size(size)
+{
+    parseHeader();
+}
+
+bool ActivityTraceReader::load(const std::string &fileName)
+{
+    m_buffer.clear();
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (file) {
+        uint8_t chunk[65536];
+        size_t length;
+        while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            m_buffer.insert(m_buffer.end(), chunk, chunk + length);
+        }
+        fclose(file);
+    }
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    parseHeader();
+    return m_valid;
+}
+
+void ActivityTraceReader::parseHeader()
+{
+    m_valid = m_size >= HeaderSize && memcmp(m_data, Magic, 4) == 0 && m_data[4] == Version;
+    uint64_t origin = 0;
+    if (m_valid) {
+        for (int i = 0; i < 8; ++i) {
+            origin |= uint64_t(m_data[8 + i]) << (8 * i);
+        }
+    }
+    m_origin = int64_t(origin);
+    rewind();
+}
+
+bool ActivityTraceReader::isValid() const
+{
+    return m_valid;
+}
+
+int64_t ActivityTraceReader::origin() const
+{
+    return m_origin;
+}
+
+bool ActivityTraceReader::next(int64_t &timestamp)
+{
+    if (!m_valid || m_position >= m_size) {
+        return false;
+    }
+    uint64_t delta = 0;
+    int shift = 0;
+    for (;;) {
+        if (m_position >= m_size || shift > 63) {
+            // truncated or corrupt record
+            m_position = m_size;
+            return false;
+        }
+        const uint8_t byte = m_data[m_position++];
+        delta |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+        shift += 7;
+    }
+    m_last += int64_t(delta);
+    timestamp = m_last;
+    return true;
+}
+
+void ActivityTraceReader::rewind()
+{
+    m_position = HeaderSize;
+    m_last = m_origin;
+}
+
+ActivityTraceRecorder::ActivityTraceRecorder(IdleActivitySink *target, ActivityTraceWriter *writer)
+    : m_target(target)
+    , m_writer(writer)
+{
+}
+
+void ActivityTraceRecorder::activityAt(int64_t time)
+{
+    m_writer->append(time);
+    m_target->activityAt(time);
+}
@@ -0,0 +1,121 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef ACTIVITYTRACE_H
+#define ACTIVITYTRACE_H
+
+#include "idlebackend.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * A compact binary trace of user input activity, for replaying real user behaviour
+ * against the idle detection policies (@see IdleTraceSimulator).
+ *
+ * Format (all integers little-endian):
+ *     "KIDT"             magic
+ *     uint8              version (1)
+ *     uint8[3]           reserved, 0
+ *     int64              origin: time of reference, in milliseconds
+ *     varint...          one record per activity: the delay since the previous activity
+ *                        (the origin for the first one) in milliseconds, as an unsigned
+ *                        LEB128 number
+ * A busy user produces one record per ActivityFilter quantum, mostly 1 byte each.
+ */
+class ActivityTraceWriter
+{
+public:
+    explicit ActivityTraceWriter(int64_t origin = 0);
+
+    /**
+     * appends an activity at @p timestamp; timestamps must not decrease.
+     */
+    void append(int64_t timestamp);
+    int64_t count() const;
+    const std::vector<uint8_t> &data() const;
+    /**
+     * starts a new, empty trace.
+     */
+    void clear(int64_t origin = 0);
+
+    bool save(const std::string &fileName) const;
+
+private:
+    std::vector<uint8_t> m_data;
+    int64_t m_last;
+    int64_t m_count;
+};
+
+class ActivityTraceReader
+{
+public:
+    ActivityTraceReader();
+    ActivityTraceReader(const uint8_t *data, size_t size);
+
+    bool load(const std::string &fileName);
+    /**
+     * @returns false if the data isn't a trace in a supported version.
+     */
+    bool isValid() const;
+    int64_t origin() const;
+
+    /**
+     * reads the next activity.
+     * @returns false at the end of the trace.
+     */
+    bool next(int64_t &timestamp);
+    /**
+     * goes back to the first activity.
+     */
+    void rewind();
+
+private:
+    ActivityTraceReader(const ActivityTraceReader &) = delete;
+    ActivityTraceReader &operator=(const ActivityTraceReader &) = delete;
+    void parseHeader();
+
+    std::vector<uint8_t> m_buffer;
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_position;
+    int64_t m_origin;
+    int64_t m_last;
+    bool m_valid;
+};
+
+/**
+ * Records the activity passing between an ActivityFilter and the engine: it is given to the
+ * filter in place of the engine, appends every update to a trace, and forwards it.
+ */
+class ActivityTraceRecorder : public IdleActivitySink
+{
+public:
+    ActivityTraceRecorder(IdleActivitySink *target, ActivityTraceWriter *writer);
+
+    void activityAt(int64_t time);
+
+private:
+    IdleActivitySink *m_target;
+    ActivityTraceWriter *m_writer;
+};
+
+#endif /* ACTIVITYTRACE_H */
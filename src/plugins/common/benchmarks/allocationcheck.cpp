@@ -0,0 +1,325 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Checks that the engine's steady state does not touch the heap: polling, reporting the
+// timeouts (one by one and several at once), re-arming the timer, activity events,
+// catching the end of the idle period, suspend, registering and unregistering within the
+// inline capacity, and reading the timeouts through their view. It also covers a
+// ThreadedIdleDetector exchanging commands and events with its detection thread.
+//
+// The global operator new is replaced by one that counts the allocations made while a
+// scenario runs, from any thread. Each scenario is run once to warm up (the scratch lists
+// reach their size, the detection thread starts), then many times under the counter. Any
+// allocation fails the check.
+
+#include "activityfilter.h"
+#include "idletimeoutengine.h"
+#include "monotonicclock.h"
+#include "threadedidledetector.h"
+#include "virtualclock.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+namespace
+{
+
+std::atomic<bool> counting(false);
+std::atomic<long> allocations(0);
+
+void *allocate(size_t size)
+{
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void *p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+}
+
+void *operator new(size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new[](size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return allocate(size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return allocate(size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+
+class Listener : public IdleEventListener
+{
+public:
+    Listener()
+        : reached(0)
+        , resumed(0)
+    {
+    }
+
+    void timeoutReached(int)
+    {
+        ++reached;
+    }
+
+    void timeoutsReached(const int *, size_t count)
+    {
+        reached += long(count);
+    }
+
+    void resumingFromIdle()
+    {
+        ++resumed;
+    }
+
+    long reached;
+    long resumed;
+};
+
+// the idle time since the last activity, on the real clock
+class ActivitySource : public IdleTimeSource
+{
+public:
+    ActivitySource()
+        : lastActivity(clock.now())
+    {
+    }
+
+    bool queryIdleTime(int64_t &idle)
+    {
+        idle = clock.now() - lastActivity.load();
+        return true;
+    }
+
+    MonotonicClock clock;
+    std::atomic<int64_t> lastActivity;
+};
+
+const int Thresholds[] = { 100, 250, 400, 1000, 3000, 5000 };
+
+/**
+ * runs @p scenario once to warm up, then @p rounds times while counting.
+ * @returns the number of allocations.
+ */
+template<typename Scenario>
+long check(const char *name, int rounds, Scenario scenario)
+{
+    scenario();
+    allocations.store(0);
+    counting.store(true);
+    for (int i = 0; i < rounds; ++i) {
+        scenario();
+    }
+    counting.store(false);
+    const long count = allocations.load();
+    printf("%-28s %8d %12ld\n", name, rounds, count);
+    return count;
+}
+
+struct VirtualSetup {
+    explicit VirtualSetup(bool singleShot)
+        : source(&clock)
+        , timer(&clock, singleShot)
+        , engine(&source, &timer, &listener, &clock)
+        , filter(&engine, &clock)
+    {
+        timer.setCallback([this]() { engine.timerFired(); });
+        for (int msecs : Thresholds) {
+            engine.addTimeout(msecs);
+        }
+    }
+
+    /**
+     * an idle period of @p length, ended by activity seen by the event filter.
+     */
+    void idlePeriod(int64_t length)
+    {
+        clock.advance(length);
+        source.userActivity();
+        filter.event(ActivityFilter::InputEvent, clock.now());
+    }
+
+    VirtualClock clock;
+    VirtualIdleSource source;
+    VirtualTimer timer;
+    Listener listener;
+    IdleTimeoutEngine engine;
+    ActivityFilter filter;
+};
+
+volatile long sink;
+
+}
+
+int main()
+{
+    long failures = 0;
+    printf("%-28s %8s %12s\n", "scenario", "rounds", "allocations");
+
+    {
+        VirtualSetup setup(false);
+        failures += check("adaptive/idle-periods", 1000, [&]() {
+            // past some of the timeouts, then all of them
+            setup.idlePeriod(300);
+            setup.idlePeriod(6000);
+        });
+    }
+    {
+        VirtualSetup setup(true);
+        setup.engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+        setup.engine.setLatenessBudget(20);
+        setup.engine.setLatenessBudget(5000, 500);
+        setup.engine.setActivityEventsAvailable(true);
+        failures += check("deadline/idle-periods", 1000, [&]() {
+            setup.idlePeriod(300);
+            setup.idlePeriod(6000);
+        });
+    }
+    {
+        VirtualSetup setup(true);
+        setup.engine.setPollResolution(50);
+        failures += check("fixed/idle-periods", 1000, [&]() {
+            setup.idlePeriod(300);
+            setup.idlePeriod(6000);
+        });
+    }
+    {
+        // every wake-up reports several timeouts at once
+        VirtualSetup setup(true);
+        setup.engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+        failures += check("poll/several-crossed", 1000, [&]() {
+            setup.source.userActivity();
+            setup.engine.activityAt(setup.clock.now());
+            setup.timer.stop();
+            setup.clock.advance(6000);
+            setup.engine.timerFired();
+        });
+    }
+    {
+        VirtualSetup setup(false);
+        setup.engine.setSuspendPolicy(IdleTimeoutEngine::CollapseSuspend);
+        failures += check("suspend/collapse", 1000, [&]() {
+            setup.clock.advance(150);
+            setup.clock.suspend(10000);
+            setup.engine.systemResumed();
+            setup.idlePeriod(10);
+        });
+    }
+    {
+        VirtualSetup setup(false);
+        failures += check("catch/resume", 1000, [&]() {
+            setup.clock.advance(1200);
+            setup.engine.catchIdleEvent();
+            setup.clock.advance(1200);
+            setup.idlePeriod(0);
+        });
+    }
+    {
+        // the inline capacity is 8 timeouts
+        VirtualSetup setup(false);
+        const int extra[] = { 50, 2000 };
+        IdleTimeoutEngine::Handle handles[2];
+        failures += check("register/add-remove", 1000, [&]() {
+            setup.engine.addTimeout(700);
+            setup.engine.removeTimeout(700);
+            setup.engine.addTimeouts(extra, 2, handles);
+            setup.engine.removeTimeouts(handles, 2);
+        });
+    }
+    {
+        VirtualSetup setup(false);
+        failures += check("timeouts/view", 1000, [&]() {
+            const IdleTimeoutList timeouts = setup.engine.timeouts();
+            for (IdleTimeoutList::const_iterator it = timeouts.begin(); it != timeouts.end(); ++it) {
+                sink += *it;
+            }
+        });
+    }
+    {
+        // in real time: the thread detects the 10ms timeout of each 15ms idle period
+        ActivitySource source;
+        Listener listener;
+        ThreadedIdleDetector detector(&source, &listener, &source.clock);
+        detector.addTimeout(10);
+        detector.addTimeout(20000);
+        detector.setActivityEventsAvailable(true);
+        detector.start();
+        failures += check("threaded/idle-periods", 50, [&]() {
+            source.lastActivity = source.clock.now();
+            detector.activityAt(source.lastActivity);
+            std::this_thread::sleep_for(std::chrono::milliseconds(15));
+            detector.forcePollRequest();
+            detector.deliverEvents();
+        });
+        detector.stop();
+    }
+
+    if (failures) {
+        printf("FAILED: %ld allocations in the steady state\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,374 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Checks the IdleAwaitables in virtual time, with coroutines resumed by a minimal executor
+// (advance the clock, then resumeReady()):
+//   idleFor        completes when the threshold is reached, and unregisters it;
+//   nextActivity   completes at the activity, and stops the engine catching it;
+//   firstOf        completes with either outcome and cancels the other alternative;
+//   cancellation   destroying a suspended coroutine leaves nothing behind in the engine;
+//   forwarding     the owner's listener sees its own timeouts and resumes, not the
+//                  coroutines' ones;
+//   allocations    a coroutine alternating idleFor() and nextActivity() allocates nothing
+//                  after its frame (the global operator new counts the allocations).
+// Any failure makes the program return 1.
+
+#include "activityfilter.h"
+#include "idleawaitables.h"
+#include "virtualclock.h"
+
+#include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <new>
+
+namespace
+{
+
+bool counting = false;
+long allocations = 0;
+
+void *allocate(size_t size)
+{
+    if (counting) {
+        ++allocations;
+    }
+    void *p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+}
+
+void *operator new(size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new[](size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+
+using namespace std::chrono_literals;
+
+/**
+ * a coroutine that starts at once and keeps its frame until the Task is destroyed.
+ */
+class Task
+{
+public:
+    struct promise_type {
+        Task get_return_object()
+        {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_never initial_suspend()
+        {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> coroutine)
+        : m_coroutine(coroutine)
+    {
+    }
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    ~Task()
+    {
+        destroy();
+    }
+
+    bool done() const
+    {
+        return !m_coroutine || m_coroutine.done();
+    }
+    /**
+     * destroys the frame, which cancels what the coroutine awaits.
+     */
+    void destroy()
+    {
+        if (m_coroutine) {
+            m_coroutine.destroy();
+            m_coroutine = nullptr;
+        }
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_coroutine;
+};
+
+class Listener : public IdleEventListener
+{
+public:
+    void timeoutReached(int msecs)
+    {
+        ++reached;
+        last = msecs;
+    }
+
+    void resumingFromIdle()
+    {
+        ++resumed;
+    }
+
+    int reached = 0;
+    int last = -1;
+    int resumed = 0;
+};
+
+struct Setup {
+    Setup()
+        : source(&clock)
+        , timer(&clock, true)
+        , awaitables(&listener)
+        , engine(&source, &timer, &awaitables, &clock)
+        , filter(&engine, &clock)
+    {
+        timer.setCallback([this]() { engine.timerFired(); });
+        engine.setActivityEventsAvailable(true);
+        awaitables.setEngine(&engine);
+        awaitables.setWakeUp([this]() { ++wakeUps; });
+    }
+
+    /**
+     * the executor: lets virtual time pass in steps, resuming the ready coroutines.
+     */
+    void runUntil(int64_t time)
+    {
+        while (clock.now() < time) {
+            clock.advance(10);
+            awaitables.resumeReady();
+        }
+    }
+
+    void activity()
+    {
+        source.userActivity();
+        filter.event(ActivityFilter::InputEvent, clock.now());
+        awaitables.resumeReady();
+    }
+
+    VirtualClock clock;
+    VirtualIdleSource source;
+    VirtualTimer timer;
+    Listener listener;
+    IdleAwaitables awaitables;
+    IdleTimeoutEngine engine;
+    ActivityFilter filter;
+    int wakeUps = 0;
+};
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    printf("%-60s %s\n", what, condition ? "ok" : "FAILED");
+    if (!condition) {
+        ++failures;
+    }
+}
+
+Task waitIdle(Setup &setup, std::chrono::milliseconds duration, int64_t &at)
+{
+    co_await setup.awaitables.idleFor(duration);
+    at = setup.clock.now();
+}
+
+Task waitActivity(Setup &setup, int64_t &at)
+{
+    co_await setup.awaitables.nextActivity();
+    at = setup.clock.now();
+}
+
+Task waitEither(Setup &setup, std::chrono::milliseconds duration, IdleAwaitables::Event &outcome, int64_t &at)
+{
+    outcome = co_await setup.awaitables.firstOf(setup.awaitables.idleFor(duration), setup.awaitables.nextActivity());
+    at = setup.clock.now();
+}
+
+Task dimmer(Setup &setup, int &dims, int &wakes)
+{
+    for (;;) {
+        co_await setup.awaitables.idleFor(100ms);
+        ++dims;
+        co_await setup.awaitables.nextActivity();
+        ++wakes;
+    }
+}
+
+void checkIdleFor()
+{
+    Setup setup;
+    int64_t at = -1;
+    Task task = waitIdle(setup, 300ms, at);
+    check(setup.engine.timeoutCount() == 1, "idleFor: threshold registered while awaited");
+    setup.runUntil(1000);
+    check(task.done() && at >= 300 && at <= 310, "idleFor: resumed when the threshold is reached");
+    check(setup.wakeUps == 1, "idleFor: one wake-up");
+    check(setup.engine.timeoutCount() == 0, "idleFor: threshold unregistered after completion");
+}
+
+void checkNextActivity()
+{
+    Setup setup;
+    int64_t at = -1;
+    Task task = waitActivity(setup, at);
+    check(setup.engine.isCatchingIdleEvents(), "nextActivity: engine catches the end of idle");
+    setup.runUntil(500);
+    check(!task.done(), "nextActivity: still waiting while idle");
+    setup.activity();
+    check(task.done() && at == 500, "nextActivity: resumed at the activity");
+    check(!setup.engine.isCatchingIdleEvents(), "nextActivity: catching stopped afterwards");
+    check(setup.listener.resumed == 0, "nextActivity: not passed on to the owner");
+}
+
+void checkFirstOf()
+{
+    Setup setup;
+    IdleAwaitables::Event outcome = IdleAwaitables::IdleReached;
+    int64_t at = -1;
+    {
+        Task task = waitEither(setup, 500ms, outcome, at);
+        setup.runUntil(200);
+        setup.activity();
+        check(task.done() && outcome == IdleAwaitables::ActivitySeen && at == 200, "firstOf: activity first");
+        check(setup.engine.timeoutCount() == 0, "firstOf: idle alternative cancelled");
+    }
+    {
+        Task task = waitEither(setup, 500ms, outcome, at);
+        setup.runUntil(1000);
+        check(task.done() && outcome == IdleAwaitables::IdleReached && at >= 700 && at <= 710, "firstOf: idle first");
+        check(!setup.engine.isCatchingIdleEvents(), "firstOf: activity alternative cancelled");
+        check(setup.awaitables.pendingCount() == 0, "firstOf: nothing pending");
+    }
+}
+
+void checkCancellation()
+{
+    Setup setup;
+    IdleAwaitables::Event outcome = IdleAwaitables::IdleReached;
+    int64_t at = -1;
+    Task either = waitEither(setup, 500ms, outcome, at);
+    Task idle = waitIdle(setup, 800ms, at);
+    check(setup.awaitables.pendingCount() == 2 && setup.engine.timeoutCount() == 2, "cancel: two awaits pending");
+    either.destroy();
+    idle.destroy();
+    check(setup.awaitables.pendingCount() == 0, "cancel: nothing pending after destruction");
+    check(setup.engine.timeoutCount() == 0 && !setup.engine.isCatchingIdleEvents(), "cancel: nothing left in the engine");
+    setup.runUntil(1000);
+    check(at == -1 && setup.wakeUps == 0, "cancel: destroyed coroutines never resumed");
+}
+
+void checkForwarding()
+{
+    Setup setup;
+    setup.engine.addTimeout(300);
+    int64_t shared = -1, own = -1;
+    Task sharedTask = waitIdle(setup, 300ms, shared);
+    Task ownTask = waitIdle(setup, 200ms, own);
+    setup.runUntil(1000);
+    check(sharedTask.done() && ownTask.done(), "forward: both coroutines resumed");
+    check(setup.listener.reached == 1 && setup.listener.last == 300, "forward: only the owner's timeout passed on");
+    check(setup.engine.timeoutCount() == 1 && setup.engine.registrations(300) == 1, "forward: the owner's registration kept");
+
+    setup.awaitables.catchIdleEvent();
+    int64_t at = -1;
+    Task task = waitActivity(setup, at);
+    setup.activity();
+    check(task.done() && setup.listener.resumed == 1, "forward: the owner's resume passed on");
+    Task again = waitActivity(setup, at);
+    setup.runUntil(1500);
+    setup.activity();
+    check(again.done() && setup.listener.resumed == 1, "forward: the coroutines' resume kept");
+}
+
+void checkAllocations()
+{
+    Setup setup;
+    int dims = 0, wakes = 0;
+    Task task = dimmer(setup, dims, wakes);
+    // warm up: the engine's scratch lists reach their size
+    setup.runUntil(200);
+    setup.activity();
+    const int rounds = 1000;
+    allocations = 0;
+    counting = true;
+    for (int i = 0; i < rounds; ++i) {
+        setup.runUntil(setup.clock.now() + 150);
+        setup.activity();
+    }
+    counting = false;
+    printf("%-60s %ld\n", "allocations: in 1000 idle periods", allocations);
+    check(dims == rounds + 1 && wakes == rounds + 1, "allocations: every period seen");
+    check(allocations == 0, "allocations: none per await");
+}
+
+}
+
+int main()
+{
+    checkIdleFor();
+    checkNextActivity();
+    checkFirstOf();
+    checkCancellation();
+    checkForwarding();
+    checkAllocations();
+    if (failures) {
+        printf("FAILED: %d checks\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Checks that the engine reports every threshold the idle time went past in a single
+// pass, and counts what that costs, for the cases where several are crossed at once:
+// a wake-up delayed by a suspend or a busy owner, and closely spaced thresholds that
+// share a coalesced wake-up. Exits with 1 if a case is not reported as expected.
+
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+class BatchListener : public IdleEventListener
+{
+public:
+    BatchListener() : engine(0), removeDuringBatch(-1) {}
+
+    void timeoutReached(int msecs)
+    {
+        batches.push_back(std::vector<int>(1, msecs));
+    }
+
+    void timeoutsReached(const int *msecs, size_t count)
+    {
+        batches.push_back(std::vector<int>(msecs, msecs + count));
+        if (removeDuringBatch >= 0) {
+            engine->removeTimeout(removeDuringBatch);
+            removeDuringBatch = -1;
+        }
+    }
+
+    void resumingFromIdle() {}
+
+    std::vector<std::vector<int> > batches;
+    IdleTimeoutEngine *engine;
+    int removeDuringBatch;
+};
+
+/**
+ * an engine on a virtual clock whose timer can be held back, as when the machine is
+ * suspended or the thread running the engine is busy.
+ */
+struct Setup {
+    Setup(const std::vector<int> &timeouts)
+        : source(&clock)
+        , timer(&clock, true)
+        , engine(&source, &timer, &listener, &clock)
+        , held(false)
+        , wakeups(0)
+    {
+        listener.engine = &engine;
+        timer.setCallback([this]() {
+            if (held) {
+                return;
+            }
+            ++wakeups;
+            engine.timerFired();
+        });
+        engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+        engine.setActivityEventsAvailable(true);
+        for (int timeout : timeouts) {
+            engine.addTimeout(timeout);
+        }
+        engine.activityAt(0);
+    }
+
+    /**
+     * holds the timer back until @p time, then delivers the overdue wake-up.
+     */
+    void wakeUpLate(int64_t time)
+    {
+        held = true;
+        clock.advanceTo(time);
+        held = false;
+        ++wakeups;
+        engine.timerFired();
+    }
+
+    VirtualClock clock;
+    VirtualIdleSource source;
+    VirtualTimer timer;
+    BatchListener listener;
+    IdleTimeoutEngine engine;
+    bool held;
+    int wakeups;
+};
+
+std::string format(const std::vector<std::vector<int> > &batches)
+{
+    std::string text;
+    for (const std::vector<int> &batch : batches) {
+        text += '[';
+        for (size_t i = 0; i < batch.size(); ++i) {
+            text += (i ? "," : "") + std::to_string(batch[i] / 1000);
+        }
+        text += ']';
+    }
+    return text;
+}
+
+bool report(const char *name, const Setup &setup, int queries, const std::vector<std::vector<int> > &expected)
+{
+    const bool ok = setup.listener.batches == expected;
+    printf("%-34s %8d %8d  %-26s %s\n", name, setup.wakeups, queries,
+           format(setup.listener.batches).c_str(), ok ? "ok" : ("EXPECTED " + format(expected)).c_str());
+    return ok;
+}
+
+}
+
+int main()
+{
+    const std::vector<int> thresholds = { 60000, 120000, 300000, 600000 };
+    bool ok = true;
+    printf("%-34s %8s %8s  %-26s\n", "case (thresholds in s)", "wakeups", "queries", "reported");
+
+    {
+        // asleep from 30s to 20min: all four thresholds went by during the suspend
+        Setup setup(thresholds);
+        setup.clock.advanceTo(30000);
+        const int queries = setup.source.queries();
+        setup.wakeUpLate(1200000);
+        ok &= report("suspend past all thresholds", setup, setup.source.queries() - queries,
+                     { { 60000, 120000, 300000, 600000 } });
+    }
+    {
+        // the first wake-up comes 4 minutes late; the last threshold is still ahead
+        Setup setup(thresholds);
+        const int queries = setup.source.queries();
+        setup.wakeUpLate(310000);
+        setup.clock.advanceTo(700000);
+        ok &= report("late wake-up, then on time", setup, setup.source.queries() - queries,
+                     { { 60000, 120000, 300000 }, { 600000 } });
+    }
+    {
+        // thresholds a few ms apart share one wake-up with a budget of 17ms, which leaves
+        // 16ms of slack once the timer granularity is taken off
+        Setup setup({ 60001, 60004, 60008, 60013, 120000 });
+        setup.engine.setLatenessBudget(17);
+        setup.engine.activityAt(0);
+        const int queries = setup.source.queries();
+        setup.clock.advanceTo(130000);
+        ok &= report("closely spaced, 17ms budget", setup, setup.source.queries() - queries,
+                     { { 60001, 60004, 60008, 60013 }, { 120000 } });
+    }
+    {
+        // the same thresholds are reported again after the user came back
+        Setup setup(thresholds);
+        setup.wakeUpLate(400000);
+        setup.clock.advanceTo(410000);
+        setup.source.userActivity();
+        setup.engine.activityAt(410000);
+        const int queries = setup.source.queries();
+        setup.wakeUpLate(410000 + 150000);
+        ok &= report("second idle period", setup, setup.source.queries() - queries,
+                     { { 60000, 120000, 300000 }, { 60000, 120000 } });
+    }
+    {
+        // the listener drops a threshold that is still ahead while handling a batch
+        Setup setup(thresholds);
+        setup.listener.removeDuringBatch = 600000;
+        const int queries = setup.source.queries();
+        setup.wakeUpLate(130000);
+        setup.clock.advanceTo(1200000);
+        ok &= report("registration changed in the batch", setup, setup.source.queries() - queries,
+                     { { 60000, 120000 }, { 300000 } });
+    }
+    return ok ? 0 : 1;
+}
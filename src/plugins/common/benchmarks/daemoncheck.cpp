@@ -0,0 +1,154 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Checks how daemons and clients share the socket path, in a single thread:
+//   takeover   a second daemon does not take the socket of a running one, whose client
+//              stays connected;
+//   stale      the socket file of a daemon that died without removing it is replaced;
+//   reconnect  a client whose daemon went away registers its timeouts and the catching of
+//              the idle period again with the next daemon;
+//   idle time  IdleDaemonClient::idleTime() answers at once, without a round trip to the
+//              daemon.
+// Exits with 1 if a check fails.
+
+#include "idledaemon.h"
+#include "idledaemonclient.h"
+#include "monotonicclock.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+
+const char *SocketPath = "/tmp/kidletime-daemoncheck.socket";
+
+class NullListener : public IdleEventListener
+{
+public:
+    void timeoutReached(int) {}
+    void resumingFromIdle() {}
+};
+
+class ZeroIdleSource : public IdleTimeSource
+{
+public:
+    bool queryIdleTime(int64_t &idle)
+    {
+        idle = 0;
+        return true;
+    }
+};
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    printf("%-64s %s\n", what, condition ? "ok" : "FAILED");
+    if (!condition) {
+        ++failures;
+    }
+}
+
+/**
+ * lets @p daemon handle what its clients sent.
+ */
+void serve(IdleDaemon &daemon)
+{
+    for (int i = 0; i < 5; ++i) {
+        daemon.processEvents(1);
+    }
+}
+
+/**
+ * leaves a socket file behind at @p path, as a daemon that crashed would.
+ */
+bool leaveStaleSocket(const char *path)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    const bool bound = fd >= 0 && bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0
+        && listen(fd, 1) == 0;
+    if (fd >= 0) {
+        close(fd);
+    }
+    return bound;
+}
+
+}
+
+int main()
+{
+    unlink(SocketPath);
+    MonotonicClock clock;
+    ZeroIdleSource source;
+    NullListener listener;
+    IdleDaemonClient client(&listener);
+    {
+        IdleDaemon first(&source, &clock);
+        check(first.listen(SocketPath), "takeover: the first daemon listens");
+        check(client.connectToDaemon(SocketPath), "takeover: a client connects");
+        client.addTimeout(60000);
+        client.addTimeout(300000);
+        client.catchIdleEvent();
+        serve(first);
+        {
+            IdleDaemon second(&source, &clock);
+            check(!second.listen(SocketPath), "takeover: a second daemon is refused");
+        }
+        IdleDaemonClient other(&listener);
+        check(other.connectToDaemon(SocketPath), "takeover: the socket still leads to the first daemon");
+        serve(first);
+        client.dispatch();
+        check(client.isConnected() && first.engine()->timeoutCount() == 2,
+              "takeover: the first daemon keeps its client");
+    }
+    // the first daemon removed its socket file; make one that nobody listens on
+    client.dispatch();
+    check(!client.isConnected(), "reconnect: the client notices that its daemon went away");
+    check(leaveStaleSocket(SocketPath), "stale: a socket file is left behind");
+
+    IdleDaemon next(&source, &clock);
+    check(next.listen(SocketPath), "stale: the next daemon replaces it");
+    check(client.connectToDaemon(SocketPath), "reconnect: the client connects to the next daemon");
+    serve(next);
+    const IdleTimeoutList timeouts = next.engine()->timeouts();
+    check(timeouts.size() == 2 && timeouts[0] == 60000 && timeouts[1] == 300000,
+          "reconnect: the timeouts are registered again");
+    check(next.engine()->isCatchingIdleEvents(), "reconnect: the idle period is caught again");
+
+    // this daemon has no shared page; a kidletimed running in the session may have one
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const int idle = client.idleTime();
+    const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+    check(idle >= -1 && elapsed < std::chrono::milliseconds(100), "idle time: answered at once");
+
+    if (failures) {
+        printf("FAILED: %d checks\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Counts the wake-ups of the evdev plugin's engine, configured by
+// EvdevActivitySource::attachEngine() as the plugin does, over a simulated day in the
+// Parked state and another one in the Catching state. The input device is a pipe fed with
+// input_event records stamped on the virtual clock, and the timer is single-shot and
+// armed for deadlines like the plugin's timerfd. The same engine without activity events is shown for comparison.
+// Exits with 1 if the plugin configuration wakes up at all while parked or catching, or
+// misses the timeouts or the end of the idle period.
+
+#include "activityfilter.h"
+#include "evdevactivitysource.h"
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <linux/input.h>
+
+#include <cstdio>
+
+namespace
+{
+
+const int64_t Day = 24 * 3600 * 1000;
+
+class CountingListener : public IdleEventListener
+{
+public:
+    CountingListener()
+        : reached(0)
+        , resumes(0)
+    {
+    }
+    void timeoutReached(int)
+    {
+        ++reached;
+    }
+    void resumingFromIdle()
+    {
+        ++resumes;
+    }
+
+    int reached;
+    int resumes;
+};
+
+struct Result {
+    int reached;
+    int parkedWakeups;
+    int catchingWakeups;
+    int resumes;
+};
+
+struct Setup {
+    explicit Setup(bool activityEvents)
+        : source(&clock)
+        , timer(&clock, true)
+        , engine(&source, &timer, &listener, &clock)
+        , filter(&engine, &clock)
+    {
+        timer.setCallback([this]() { engine.timerFired(); });
+        engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+        source.attachEngine(&engine, &filter);
+        if (!activityEvents) {
+            engine.setActivityEventsAvailable(false);
+        }
+        int fds[2];
+        if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0) {
+            source.addDevice(fds[0], true);
+            device = fds[1];
+        } else {
+            device = -1;
+        }
+        engine.addTimeout(60000);
+        engine.addTimeout(300000);
+    }
+
+    ~Setup()
+    {
+        if (device >= 0) {
+            close(device);
+        }
+    }
+
+    /**
+     * a key press now, read as the plugin's socket notifier would.
+     */
+    void keyPress()
+    {
+        struct input_event event;
+        memset(&event, 0, sizeof(event));
+        const int64_t now = clock.now();
+#ifdef input_event_sec
+        event.input_event_sec = now / 1000;
+        event.input_event_usec = (now % 1000) * 1000;
+#else
+        event.time.tv_sec = now / 1000;
+        event.time.tv_usec = (now % 1000) * 1000;
+#endif
+        event.type = EV_KEY;
+        event.code = KEY_A;
+        event.value = 1;
+        if (write(device, &event, sizeof(event)) == ssize_t(sizeof(event))) {
+            source.dispatch(0);
+        }
+    }
+
+    Result run()
+    {
+        Result result;
+        keyPress();
+        // both timeouts, then a day parked
+        clock.advance(300000);
+        result.reached = listener.reached;
+        int before = timer.expirations();
+        clock.advance(Day);
+        result.parkedWakeups = timer.expirations() - before;
+        // a day waiting for the end of the idle period
+        engine.catchIdleEvent();
+        before = timer.expirations();
+        clock.advance(Day);
+        result.catchingWakeups = timer.expirations() - before;
+        keyPress();
+        result.resumes = listener.resumes;
+        return result;
+    }
+
+    VirtualClock clock;
+    EvdevActivitySource source;
+    VirtualTimer timer;
+    CountingListener listener;
+    IdleTimeoutEngine engine;
+    ActivityFilter filter;
+    int device;
+};
+
+}
+
+int main()
+{
+    printf("%-28s %8s %16s %18s %8s\n", "configuration", "reached", "parked wake-ups", "catching wake-ups", "resumes");
+    Result plugin;
+    {
+        Setup setup(true);
+        if (setup.device < 0) {
+            printf("FAILED: could not create the fake device\n");
+            return 1;
+        }
+        plugin = setup.run();
+    }
+    Result sampling;
+    {
+        Setup setup(false);
+        sampling = setup.run();
+    }
+    printf("%-28s %8d %16d %18d %8d\n", "plugin (activity events)", plugin.reached, plugin.parkedWakeups,
+           plugin.catchingWakeups, plugin.resumes);
+    printf("%-28s %8d %16d %18d %8d\n", "without activity events", sampling.reached, sampling.parkedWakeups,
+           sampling.catchingWakeups, sampling.resumes);
+
+    if (plugin.reached != 2 || plugin.resumes != 1 || plugin.parkedWakeups || plugin.catchingWakeups) {
+        printf("FAILED: the evdev plugin's engine is not idle while parked and catching\n");
+        return 1;
+    }
+    return 0;
+}
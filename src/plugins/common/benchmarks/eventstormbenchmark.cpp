@@ -0,0 +1,105 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Feeds synthetic native event storms (pointer motion at various rates, mixed with
+// non-input events) to the engine, once the way the Cocoa event filter used to do it
+// (one inputEvent() per native event) and once through an ActivityFilter with various
+// coalescing quanta. Reports engine updates and idle time queries per 10000 events.
+
+#include "activityfilter.h"
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+
+class NullListener : public IdleEventListener
+{
+public:
+    void timeoutReached(int) {}
+    void resumingFromIdle() {}
+};
+
+const int eventCount = 10000;
+
+// every third event is not an input event
+ActivityFilter::EventClass classify(int i)
+{
+    return (i % 3 == 2) ? ActivityFilter::OtherEvent : ActivityFilter::InputEvent;
+}
+
+void run(int rate, int64_t quantum)
+{
+    VirtualClock clock;
+    VirtualIdleSource source(&clock);
+    VirtualTimer timer(&clock);
+    NullListener listener;
+    IdleTimeoutEngine engine(&source, &timer, &listener, &clock);
+    timer.setCallback([&engine]() { engine.timerFired(); });
+    engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+    engine.addTimeout(60000);
+    engine.addTimeout(300000);
+    ActivityFilter filter(&engine, &clock, quantum);
+
+    const int queriesBefore = source.queries();
+    long engineCalls = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < eventCount; ++i) {
+        clock.advanceTo(int64_t(i) * 1000 / rate);
+        if (classify(i) == ActivityFilter::InputEvent) {
+            source.userActivity();
+        }
+        if (quantum < 0) {
+            // the former behaviour: every native event triggers a poll
+            engine.inputEvent();
+            ++engineCalls;
+        } else {
+            filter.event(classify(i), clock.now());
+        }
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if (quantum >= 0) {
+        engineCalls = long(filter.eventsForwarded());
+    }
+    char label[32];
+    if (quantum < 0) {
+        snprintf(label, sizeof(label), "unfiltered");
+    } else {
+        snprintf(label, sizeof(label), "quantum %lldms", (long long)quantum);
+    }
+    printf("%8d %-16s %14ld %14d %10.1f\n", rate, label, engineCalls,
+           source.queries() - queriesBefore, elapsed.count() / eventCount);
+}
+
+}
+
+int main()
+{
+    const int rates[] = { 1000, 250, 60 };
+    const int64_t quanta[] = { -1, 0, 10, 50, 100, 250 };
+    printf("%8s %-16s %14s %14s %10s\n", "events/s", "filter", "engine calls", "idle queries", "ns/event");
+    for (int rate : rates) {
+        for (int64_t quantum : quanta) {
+            run(rate, quantum);
+        }
+    }
+    return 0;
+}
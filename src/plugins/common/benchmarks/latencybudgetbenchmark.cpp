@@ -0,0 +1,192 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Runs a dozen applications with idle timeouts of their own on one virtual clock, all
+// watching the same user, and counts the distinct instants at which their timers wake
+// the system up for growing lateness budgets. Checks that no timeout is ever reported
+// later than its budget allows, and that the wake-ups do not increase with the budget;
+// exits with 1 otherwise. The timers are single-shot, like GCD timer sources: a repeating
+// QTimer keeps polling after the last timeout, at an interval of its own.
+
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+const int Applications = 12;
+const int TimeoutsPerApplication = 3;
+const int Days = 5;
+
+class Lcg
+{
+public:
+    Lcg() : m_state(4242) {}
+    int64_t next(int64_t min, int64_t max)
+    {
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return min + int64_t((m_state >> 33) % uint64_t(max - min + 1));
+    }
+private:
+    uint64_t m_state;
+};
+
+class Application : public IdleEventListener
+{
+public:
+    Application(VirtualClock *clock, VirtualIdleSource *source, const int64_t *lastActivity,
+                std::vector<int64_t> *wakeups)
+        : clock(clock)
+        , lastActivity(lastActivity)
+        , timer(clock, true)
+        , engine(source, &timer, this, clock)
+        , detections(0)
+        , maxOverrun(INT64_MIN)
+        , maxLateness(0)
+    {
+        timer.setCallback([this, wakeups]() {
+            wakeups->push_back(this->clock->now());
+            engine.timerFired();
+        });
+    }
+
+    void timeoutReached(int msecs)
+    {
+        const int64_t lateness = clock->now() - (*lastActivity + msecs);
+        maxLateness = std::max(maxLateness, lateness);
+        maxOverrun = std::max(maxOverrun, lateness - std::max(engine.latenessBudget(msecs), 0));
+        ++detections;
+    }
+
+    void resumingFromIdle() {}
+
+    VirtualClock *clock;
+    const int64_t *lastActivity;
+    VirtualTimer timer;
+    IdleTimeoutEngine engine;
+    int detections;
+    int64_t maxOverrun;
+    int64_t maxLateness;
+};
+
+struct Result {
+    int detections;
+    size_t wakeups;
+    int64_t maxLateness;
+    bool withinBudget;
+};
+
+Result run(const std::vector<int64_t> &events, IdleTimeoutEngine::SchedulingMode mode, int budget,
+           int longTimeoutBudget)
+{
+    VirtualClock clock;
+    VirtualIdleSource source(&clock);
+    int64_t lastActivity = 0;
+    std::vector<int64_t> wakeups;
+    std::vector<std::unique_ptr<Application> > applications;
+    Lcg lcg;
+    for (int i = 0; i < Applications; ++i) {
+        applications.emplace_back(new Application(&clock, &source, &lastActivity, &wakeups));
+        IdleTimeoutEngine &engine = applications.back()->engine;
+        engine.setSchedulingMode(mode);
+        engine.setLatenessBudget(budget);
+        engine.setActivityEventsAvailable(true);
+        for (int j = 0; j < TimeoutsPerApplication; ++j) {
+            const int timeout = int(lcg.next(30000, 900000));
+            engine.addTimeout(timeout);
+            if (longTimeoutBudget >= 0 && timeout >= 300000) {
+                engine.setLatenessBudget(timeout, longTimeoutBudget);
+            }
+        }
+    }
+
+    for (int64_t t : events) {
+        clock.advanceTo(t);
+        source.userActivity();
+        lastActivity = t;
+        for (auto &application : applications) {
+            application->engine.activityAt(t);
+        }
+    }
+    clock.advanceTo(int64_t(Days) * 24 * 3600 * 1000);
+
+    Result result = { 0, 0, 0, true };
+    std::sort(wakeups.begin(), wakeups.end());
+    result.wakeups = size_t(std::unique(wakeups.begin(), wakeups.end()) - wakeups.begin());
+    for (auto &application : applications) {
+        result.detections += application->detections;
+        result.maxLateness = std::max(result.maxLateness, application->maxLateness);
+        result.withinBudget = result.withinBudget && application->maxOverrun <= 0;
+    }
+    return result;
+}
+
+}
+
+int main()
+{
+    const int64_t day = 24 * 3600 * 1000;
+    const int64_t workday = 9 * 3600 * 1000;
+    std::vector<int64_t> events;
+    Lcg lcg;
+    for (int d = 0; d < Days; ++d) {
+        for (int64_t t = d * day; t < d * day + workday;) {
+            const int64_t burstEnd = t + lcg.next(10000, 600000);
+            for (; t < burstEnd; t += lcg.next(50, 2000)) {
+                events.push_back(t);
+            }
+            t += lcg.next(5000, 1800000);
+        }
+    }
+
+    const int budgets[] = { -1, 10, 100, 1000, 5000, 30000 };
+    const struct {
+        const char *name;
+        IdleTimeoutEngine::SchedulingMode mode;
+    } modes[] = {
+        { "deadline", IdleTimeoutEngine::DeadlineScheduling },
+        { "adaptive", IdleTimeoutEngine::AdaptiveScheduling },
+    };
+
+    bool ok = true;
+    printf("%d applications x %d timeouts, %d days\n\n", Applications, TimeoutsPerApplication, Days);
+    printf("%-9s %14s %11s %9s %13s %8s\n", "mode", "budget", "detections", "wakeups", "max lateness", "");
+    for (const auto &mode : modes) {
+        size_t previous = size_t(-1);
+        for (int budget : budgets) {
+            const Result result = run(events, mode.mode, budget, -1);
+            const bool monotonic = result.wakeups <= previous;
+            previous = result.wakeups;
+            ok = ok && result.withinBudget && monotonic;
+            printf("%-9s %12dms %11d %9zu %11lldms %8s\n", mode.name, budget, result.detections,
+                   result.wakeups, (long long)result.maxLateness,
+                   !result.withinBudget ? "OVERRUN" : monotonic ? "ok" : "MORE");
+        }
+        // a tight budget for dimming, a loose one for locking the screen
+        const Result result = run(events, mode.mode, 100, 30000);
+        ok = ok && result.withinBudget;
+        printf("%-9s %14s %11d %9zu %11lldms %8s\n", mode.name, "100/30000ms", result.detections,
+               result.wakeups, (long long)result.maxLateness, result.withinBudget ? "ok" : "OVERRUN");
+    }
+    return ok ? 0 : 1;
+}
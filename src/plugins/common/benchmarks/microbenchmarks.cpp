@@ -0,0 +1,389 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Micro-benchmarks for the hot paths of the idle-timeout engine, run against a fake idle
+// source so that the numbers measure the engine only:
+//   poll/no-emission      poll(true) between two timeouts, by number of timeouts
+//   poll/emission         poll(true) calls that each report a timeout
+//   register/add-remove   addTimeout() + removeTimeout() of one value, by number of timeouts
+//   register/batch        addTimeouts() + removeTimeouts() of a batch, per timeout
+//   register/remove       removeTimeouts() of one handle at a time until none is left, by
+//                         number of timeouts (the batch registrations are not timed)
+//   simulate-activity     simulateUserActivity(), by number of timeouts
+//   filter/event          ActivityFilter::event() per native event, by forwarded fraction
+//
+// Each case is calibrated to run for at least 20ms, repeated 5 times, and the fastest and
+// median repetitions are reported in ns per operation. The output is a text table, or with
+//     microbenchmarks --csv | --json
+// a stable machine-readable form (one record per case) for tracking regressions.
+
+#include "activityfilter.h"
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+class FakeIdleSource : public IdleTimeSource
+{
+public:
+    FakeIdleSource()
+        : idle(0)
+    {
+    }
+
+    bool queryIdleTime(int64_t &value)
+    {
+        value = idle;
+        return true;
+    }
+
+    int64_t idle;
+};
+
+class NullListener : public IdleEventListener
+{
+public:
+    NullListener()
+        : reached(0)
+    {
+    }
+
+    void timeoutReached(int)
+    {
+        ++reached;
+    }
+
+    void resumingFromIdle() {}
+
+    long reached;
+};
+
+class NullTimer : public IdleTimer
+{
+public:
+    NullTimer()
+        : active(false)
+        , lastInterval(0)
+    {
+    }
+
+    void start(int64_t msecs)
+    {
+        active = true;
+        lastInterval = msecs;
+    }
+
+    void stop()
+    {
+        active = false;
+    }
+
+    bool isActive() const
+    {
+        return active;
+    }
+
+    int64_t interval() const
+    {
+        return lastInterval;
+    }
+
+    bool active;
+    int64_t lastInterval;
+};
+
+enum Format {
+    Text,
+    Csv,
+    Json
+};
+
+struct Result {
+    std::string name;
+    long parameter;
+    long operations;
+    double fastest;
+    double median;
+};
+
+/**
+ * runs @p body (which performs the given number of operations) until it takes at least
+ * 20ms, then 5 more times.
+ */
+template<typename Body>
+Result measure(const char *name, long parameter, Body body)
+{
+    typedef std::chrono::steady_clock Clock;
+    long operations = 64;
+    for (;;) {
+        const Clock::time_point start = Clock::now();
+        body(operations);
+        if (Clock::now() - start >= std::chrono::milliseconds(20) || operations >= (1L << 30)) {
+            break;
+        }
+        operations *= 2;
+    }
+    std::vector<double> samples;
+    for (int i = 0; i < 5; ++i) {
+        const Clock::time_point start = Clock::now();
+        body(operations);
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        samples.push_back(elapsed.count() / operations);
+    }
+    std::sort(samples.begin(), samples.end());
+    Result result;
+    result.name = name;
+    result.parameter = parameter;
+    result.operations = operations;
+    result.fastest = samples.front();
+    result.median = samples[samples.size() / 2];
+    return result;
+}
+
+void addTimeouts(IdleTimeoutEngine &engine, int count)
+{
+    for (int i = 1; i <= count; ++i) {
+        engine.addTimeout(i * 1000);
+    }
+}
+
+volatile int64_t sink;
+
+void pollWithoutEmission(std::vector<Result> &results)
+{
+    for (int n = 1; n <= 10000; n *= 10) {
+        FakeIdleSource source;
+        NullTimer timer;
+        NullListener listener;
+        IdleTimeoutEngine engine(&source, &timer, &listener);
+        addTimeouts(engine, n);
+        // reach the first half of the timeouts, then stay between two of them
+        source.idle = (n / 2) * 1000 + 500;
+        while (engine.nextTimeout() >= 0 && engine.nextTimeout() <= source.idle) {
+            engine.poll(true);
+        }
+        results.push_back(measure("poll/no-emission", n, [&](long operations) {
+            for (long i = 0; i < operations; ++i) {
+                sink = engine.poll(true);
+            }
+        }));
+    }
+}
+
+void pollWithEmission(std::vector<Result> &results)
+{
+    const int n = 1000;
+    FakeIdleSource source;
+    NullTimer timer;
+    NullListener listener;
+    IdleTimeoutEngine engine(&source, &timer, &listener);
+    addTimeouts(engine, n);
+    results.push_back(measure("poll/emission", n, [&](long operations) {
+        long done = 0;
+        while (done < operations) {
+            // the idle time drops (a resetting poll), then jumps past all timeouts: each
+            // following poll reports the next one
+            source.idle = 0;
+            engine.poll(true);
+            source.idle = int64_t(n) * 1000;
+            for (int i = 0; i < n && done < operations; ++i, ++done) {
+                sink = engine.poll(true);
+            }
+        }
+    }));
+}
+
+void registration(std::vector<Result> &results)
+{
+    for (int n = 1; n <= 10000; n *= 10) {
+        FakeIdleSource source;
+        NullTimer timer;
+        NullListener listener;
+        IdleTimeoutEngine engine(&source, &timer, &listener);
+        addTimeouts(engine, n);
+        // a value in the middle of the list
+        const int msecs = (n / 2) * 1000 + 500;
+        results.push_back(measure("register/add-remove", n, [&](long operations) {
+            for (long i = 0; i < operations; ++i) {
+                engine.addTimeout(msecs);
+                engine.removeTimeout(msecs);
+            }
+        }));
+    }
+    for (int batch = 10; batch <= 10000; batch *= 10) {
+        FakeIdleSource source;
+        NullTimer timer;
+        NullListener listener;
+        IdleTimeoutEngine engine(&source, &timer, &listener);
+        std::vector<int> values;
+        for (int i = 0; i < batch; ++i) {
+            values.push_back((i * 7919) % 100000 + 1);
+        }
+        std::vector<IdleTimeoutEngine::Handle> handles(batch);
+        Result result = measure("register/batch", batch, [&](long operations) {
+            for (long i = 0; i < operations; ++i) {
+                engine.addTimeouts(values.data(), values.size(), handles.data());
+                engine.removeTimeouts(handles.data(), handles.size());
+            }
+        });
+        result.fastest /= batch;
+        result.median /= batch;
+        results.push_back(result);
+    }
+}
+
+void removal(std::vector<Result> &results)
+{
+    typedef std::chrono::steady_clock Clock;
+    for (int n = 10; n <= 10000; n *= 10) {
+        FakeIdleSource source;
+        NullTimer timer;
+        NullListener listener;
+        IdleTimeoutEngine engine(&source, &timer, &listener);
+        std::vector<int> values;
+        for (int i = 1; i <= n; ++i) {
+            values.push_back(i * 1000);
+        }
+        std::vector<IdleTimeoutEngine::Handle> handles(n);
+        // removed in an order unrelated to the values
+        std::vector<int> order;
+        for (int i = 0; i < n; ++i) {
+            order.push_back(int((int64_t(i) * 7919) % n));
+        }
+        const int rounds = std::max(1, 200000 / n);
+        std::vector<double> samples;
+        for (int repetition = 0; repetition < 5; ++repetition) {
+            Clock::duration elapsed(0);
+            for (int round = 0; round < rounds; ++round) {
+                engine.addTimeouts(values.data(), values.size(), handles.data());
+                const Clock::time_point start = Clock::now();
+                for (int i = 0; i < n; ++i) {
+                    engine.removeTimeouts(&handles[order[i]], 1);
+                }
+                elapsed += Clock::now() - start;
+            }
+            samples.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / (double(rounds) * n));
+        }
+        std::sort(samples.begin(), samples.end());
+        Result result;
+        result.name = "register/remove";
+        result.parameter = n;
+        result.operations = long(rounds) * n;
+        result.fastest = samples.front();
+        result.median = samples[samples.size() / 2];
+        results.push_back(result);
+    }
+}
+
+void simulateActivity(std::vector<Result> &results)
+{
+    for (int n = 1; n <= 10000; n *= 10) {
+        FakeIdleSource source;
+        NullTimer timer;
+        NullListener listener;
+        IdleTimeoutEngine engine(&source, &timer, &listener);
+        addTimeouts(engine, n);
+        source.idle = 500;
+        results.push_back(measure("simulate-activity", n, [&](long operations) {
+            for (long i = 0; i < operations; ++i) {
+                engine.simulateUserActivity();
+            }
+        }));
+    }
+}
+
+void activityFilter(std::vector<Result> &results)
+{
+    // one event per virtual millisecond; the quantum decides which fraction is forwarded
+    const int quanta[] = { 1, 10, 50, 1000 };
+    for (int quantum : quanta) {
+        VirtualClock clock;
+        VirtualIdleSource source(&clock);
+        VirtualTimer timer(&clock);
+        NullListener listener;
+        IdleTimeoutEngine engine(&source, &timer, &listener, &clock);
+        engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+        addTimeouts(engine, 10);
+        ActivityFilter filter(&engine, &clock, quantum);
+        int64_t timestamp = 0;
+        results.push_back(measure("filter/event", 1000 / quantum, [&](long operations) {
+            for (long i = 0; i < operations; ++i) {
+                filter.event((i & 3) ? ActivityFilter::InputEvent : ActivityFilter::OtherEvent, ++timestamp);
+            }
+        }));
+    }
+}
+
+void print(const std::vector<Result> &results, Format format)
+{
+    if (format == Json) {
+        printf("[\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result &r = results[i];
+            printf("  {\"name\": \"%s\", \"parameter\": %ld, \"operations\": %ld, \"ns_fastest\": %.2f, \"ns_median\": %.2f}%s\n",
+                   r.name.c_str(), r.parameter, r.operations, r.fastest, r.median,
+                   i + 1 < results.size() ? "," : "");
+        }
+        printf("]\n");
+    } else if (format == Csv) {
+        printf("name,parameter,operations,ns_fastest,ns_median\n");
+        for (const Result &r : results) {
+            printf("%s,%ld,%ld,%.2f,%.2f\n", r.name.c_str(), r.parameter, r.operations, r.fastest, r.median);
+        }
+    } else {
+        printf("%-22s %10s %12s %12s\n", "benchmark", "parameter", "ns fastest", "ns median");
+        for (const Result &r : results) {
+            printf("%-22s %10ld %12.1f %12.1f\n", r.name.c_str(), r.parameter, r.fastest, r.median);
+        }
+    }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    Format format = Text;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            format = Csv;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            format = Json;
+        } else {
+            fprintf(stderr, "usage: %s [--csv | --json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<Result> results;
+    pollWithoutEmission(results);
+    pollWithEmission(results);
+    registration(results);
+    removal(results);
+    simulateActivity(results);
+    activityFilter(results);
+    print(results, format);
+    return 0;
+}
@@ -0,0 +1,220 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Drives the IdleNotificationTracker of the Wayland backend from a mock ext_idle_notifier_v1
+// in virtual time. The mock behaves as a compositor does: each notification sends "idled"
+// once the seat has been idle for its timeout, and "resumed" at the next activity if it was
+// idle; the zero-timeout notification of catchIdleEvent() is idle at once. Checks that
+//   mapping    every "idled" is reported as timeoutReached(), in order, and nothing else is;
+//   catch      the activity caught is reported as resumingFromIdle(), once;
+//   estimate   the idle time estimated without a query matches the real one while the
+//              activity is seen, and never exceeds the smallest timeout that is not idle
+//              when it is not;
+//   removal    a removed timeout is neither reported nor limits the estimate.
+// Exits with 1 if a check fails.
+
+#include "idlenotificationtracker.h"
+#include "virtualclock.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+
+class RecordingListener : public IdleEventListener
+{
+public:
+    RecordingListener() : resumes(0) {}
+
+    void timeoutReached(int msecs)
+    {
+        reached.push_back(msecs);
+    }
+    void resumingFromIdle()
+    {
+        ++resumes;
+    }
+
+    std::vector<int> reached;
+    int resumes;
+};
+
+/**
+ * the compositor's side of ext-idle-notify-v1 for one seat.
+ */
+class MockIdleNotifier
+{
+public:
+    MockIdleNotifier(VirtualClock *clock, IdleNotificationTracker *tracker)
+        : m_clock(clock)
+        , m_tracker(tracker)
+        , m_activityAt(clock->now())
+        , m_catching(false)
+    {
+    }
+
+    void getIdleNotification(int msecs)
+    {
+        const Notification notification = { msecs, m_clock->now(), false };
+        m_notifications.push_back(notification);
+        m_tracker->addTimeout(msecs);
+    }
+
+    void destroy(int msecs)
+    {
+        for (size_t i = 0; i < m_notifications.size(); ++i) {
+            if (m_notifications[i].msecs == msecs) {
+                m_notifications.erase(m_notifications.begin() + i);
+                m_tracker->removeTimeout(msecs);
+                return;
+            }
+        }
+    }
+
+    void catchIdleEvent()
+    {
+        m_catching = true;
+    }
+
+    /**
+     * lets time pass without input, sending the "idled" events when they are due.
+     */
+    void advanceTo(int64_t time)
+    {
+        for (;;) {
+            Notification *next = 0;
+            for (Notification &notification : m_notifications) {
+                if (!notification.idle && dueAt(notification) <= time
+                    && (!next || dueAt(notification) < dueAt(*next))) {
+                    next = &notification;
+                }
+            }
+            if (!next) {
+                break;
+            }
+            m_clock->advanceTo(dueAt(*next));
+            next->idle = true;
+            m_tracker->idled(next->msecs);
+        }
+        m_clock->advanceTo(time);
+    }
+
+    /**
+     * user input: the idle notifications resume, the others start counting again.
+     */
+    void activity()
+    {
+        m_activityAt = m_clock->now();
+        for (Notification &notification : m_notifications) {
+            if (notification.idle) {
+                notification.idle = false;
+                m_tracker->resumed(notification.msecs);
+            }
+        }
+        if (m_catching) {
+            // the catch notification is destroyed by its first "resumed"
+            m_catching = false;
+            m_tracker->caughtActivity();
+        }
+    }
+
+    int64_t idleTime() const
+    {
+        return m_clock->now() - m_activityAt;
+    }
+
+private:
+    struct Notification {
+        int msecs;
+        int64_t createdAt;
+        bool idle;
+    };
+
+    int64_t dueAt(const Notification &notification) const
+    {
+        return std::max(m_activityAt, notification.createdAt) + notification.msecs;
+    }
+
+    VirtualClock *m_clock;
+    IdleNotificationTracker *m_tracker;
+    std::vector<Notification> m_notifications;
+    int64_t m_activityAt;
+    bool m_catching;
+};
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    printf("%-72s %s\n", what, condition ? "ok" : "FAILED");
+    if (!condition) {
+        ++failures;
+    }
+}
+
+}
+
+int main()
+{
+    VirtualClock clock;
+    RecordingListener listener;
+    IdleNotificationTracker tracker(&listener, &clock);
+    MockIdleNotifier notifier(&clock, &tracker);
+    notifier.getIdleNotification(3000);
+    notifier.getIdleNotification(1000);
+
+    notifier.advanceTo(500);
+    check(tracker.idleTime() == 500, "estimate: counts from the start before any event");
+    notifier.advanceTo(3500);
+    check(listener.reached == std::vector<int>({ 1000, 3000 }), "mapping: idled is reported as timeoutReached, in order");
+    check(tracker.idleTime() == 3500, "estimate: follows the idled events");
+
+    notifier.catchIdleEvent();
+    notifier.activity();
+    check(listener.resumes == 1, "catch: the activity is reported once");
+    notifier.advanceTo(3700);
+    check(tracker.idleTime() == notifier.idleTime(), "estimate: restarts at the resumed events");
+    check(listener.reached.size() == 2, "mapping: resumed is not reported as a timeout");
+
+    // activity while no notification is idle is not reported
+    notifier.activity();
+    notifier.advanceTo(4500);
+    check(notifier.idleTime() == 800 && tracker.idleTime() == 1000,
+          "estimate: unseen activity is bounded by the smallest timeout");
+    notifier.advanceTo(4700);
+    check(tracker.idleTime() == notifier.idleTime(), "estimate: exact again once a notification idles");
+    check(listener.resumes == 1, "catch: not reported without catchIdleEvent()");
+
+    notifier.destroy(1000);
+    notifier.advanceTo(6700);
+    notifier.activity();
+    listener.reached.clear();
+    notifier.advanceTo(clock.now() + 2000);
+    check(listener.reached.empty() && tracker.idleTime() == 2000, "removal: the removed timeout is gone");
+    notifier.advanceTo(clock.now() + 1500);
+    check(listener.reached == std::vector<int>({ 3000 }) && tracker.idleTime() == notifier.idleTime(),
+          "removal: the others are still reported");
+
+    if (failures) {
+        printf("FAILED: %d checks\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Checks every transition of the engine's state machine (IdleTimeoutEngine::State) in each
+// scheduling mode: each state is set up, each input applied, and the resulting state and
+// the timer compared to the table below. Then idles in the Parked and Catching states for
+// a simulated day and counts what that costs, with and without activity events.
+// Exits with 1 if a transition or the parked steady state is not as expected.
+
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace
+{
+
+typedef IdleTimeoutEngine::State State;
+
+const State Active = IdleTimeoutEngine::Active;
+const State Armed = IdleTimeoutEngine::Armed;
+const State Catching = IdleTimeoutEngine::Catching;
+const State Parked = IdleTimeoutEngine::Parked;
+const char *const StateNames[] = { "Active", "Armed", "Catching", "Parked" };
+
+class CountingListener : public IdleEventListener
+{
+public:
+    CountingListener()
+        : reached(0)
+        , resumes(0)
+    {
+    }
+    void timeoutReached(int)
+    {
+        ++reached;
+    }
+    void resumingFromIdle()
+    {
+        ++resumes;
+    }
+
+    int reached;
+    int resumes;
+};
+
+struct Setup {
+    explicit Setup(IdleTimeoutEngine::SchedulingMode mode, bool events = true)
+        : source(&clock)
+        , timer(&clock, mode != IdleTimeoutEngine::AdaptiveScheduling)
+        , engine(&source, &timer, &listener, &clock)
+    {
+        timer.setCallback([this]() { engine.timerFired(); });
+        if (mode == IdleTimeoutEngine::FixedScheduling) {
+            engine.setPollResolution(5000);
+        } else {
+            engine.setSchedulingMode(mode);
+        }
+        engine.setActivityEventsAvailable(events);
+        engine.addTimeout(60000);
+        engine.addTimeout(300000);
+        activity();
+    }
+
+    void activity()
+    {
+        source.userActivity();
+        engine.activityAt(clock.now());
+    }
+
+    /**
+     * brings the engine into @p state.
+     */
+    void enter(State state)
+    {
+        switch (state) {
+        case IdleTimeoutEngine::Active:
+            clock.advance(10000);
+            break;
+        case IdleTimeoutEngine::Armed:
+            clock.advance(120000);
+            break;
+        case IdleTimeoutEngine::Catching:
+            clock.advance(400000);
+            engine.catchIdleEvent();
+            break;
+        case IdleTimeoutEngine::Parked:
+            clock.advance(400000);
+            break;
+        }
+    }
+
+    VirtualClock clock;
+    VirtualIdleSource source;
+    VirtualTimer timer;
+    CountingListener listener;
+    IdleTimeoutEngine engine;
+};
+
+struct Transition {
+    const char *input;
+    std::function<void(Setup &)> apply;
+    /**
+     * whether the input is user activity, which ends a caught idle period
+     */
+    bool activity;
+    /**
+     * the expected state after the input, from Active, Armed, Catching and Parked
+     */
+    State to[4];
+};
+
+const char *modeName(IdleTimeoutEngine::SchedulingMode mode)
+{
+    return mode == IdleTimeoutEngine::AdaptiveScheduling ? "adaptive"
+        : mode == IdleTimeoutEngine::FixedScheduling ? "fixed" : "deadline";
+}
+
+bool checkTransitions(IdleTimeoutEngine::SchedulingMode mode)
+{
+    const std::vector<Transition> transitions = {
+        { "activity", [](Setup &s) { s.activity(); }, true, { Active, Active, Active, Active } },
+        { "10 minutes", [](Setup &s) { s.clock.advance(600000); }, false, { Parked, Parked, Catching, Parked } },
+        { "add 15min", [](Setup &s) { s.engine.addTimeout(900000); }, false, { Active, Armed, Armed, Armed } },
+        { "add 30s", [](Setup &s) { s.engine.addTimeout(30000); }, false, { Active, Armed, Catching, Parked } },
+        { "remove 5min", [](Setup &s) { s.engine.removeTimeout(300000); }, false, { Active, Parked, Catching, Parked } },
+        { "remove all", [](Setup &s) { s.engine.removeTimeout(60000); s.engine.removeTimeout(300000); },
+          false, { Parked, Parked, Catching, Parked } },
+        { "catch", [](Setup &s) { s.engine.catchIdleEvent(); }, false, { Active, Armed, Catching, Catching } },
+        { "stop catching", [](Setup &s) { s.engine.stopCatchingIdleEvents(); }, false, { Active, Armed, Parked, Parked } },
+        { "simulate activity", [](Setup &s) { s.engine.simulateUserActivity(); }, false, { Active, Active, Active, Active } },
+        { "poll", [](Setup &s) { s.engine.forcePollRequest(); }, false, { Active, Armed, Catching, Parked } },
+    };
+    bool ok = true;
+    int checked = 0;
+    for (const Transition &transition : transitions) {
+        for (State from : { Active, Armed, Catching, Parked }) {
+            Setup setup(mode);
+            setup.enter(from);
+            if (setup.engine.state() != from) {
+                printf("%-9s cannot enter %s (got %s)\n", modeName(mode), StateNames[from],
+                       StateNames[setup.engine.state()]);
+                ok = false;
+                continue;
+            }
+            const int resumes = setup.listener.resumes;
+            transition.apply(setup);
+            const State to = setup.engine.state();
+            // the timer runs for the timeouts only; the activity events report the resume
+            const bool timerOk = setup.timer.isActive() == (to == Active || to == Armed);
+            const bool resumeOk = (setup.listener.resumes - resumes)
+                == (from == Catching && transition.activity ? 1 : 0);
+            ++checked;
+            if (to != transition.to[from] || !timerOk || !resumeOk) {
+                printf("%-9s %-8s + %-17s -> %-8s (expected %s)%s%s\n", modeName(mode), StateNames[from],
+                       transition.input, StateNames[to], StateNames[transition.to[from]],
+                       timerOk ? "" : ", wrong timer state", resumeOk ? "" : ", wrong resume");
+                ok = false;
+            }
+        }
+    }
+    printf("%-9s %d transitions %s\n", modeName(mode), checked, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+bool parkedDay(IdleTimeoutEngine::SchedulingMode mode, bool events, bool catching)
+{
+    Setup setup(mode, events);
+    setup.enter(catching ? Catching : Parked);
+    const int expirations = setup.timer.expirations();
+    const int queries = setup.source.queries();
+    setup.clock.advance(24 * 3600 * 1000);
+    const int wakeups = setup.timer.expirations() - expirations;
+    const int sampled = setup.source.queries() - queries;
+    // without events the engine samples once per smallest timeout, and once per resume
+    // latency while catching
+    const int allowed = events ? 0 : catching ? 24 * 3600 : 24 * 60;
+    const bool ok = wakeups <= allowed && sampled <= allowed && setup.engine.state() == (catching ? Catching : Parked);
+    printf("%-9s %-7s %-9s %8d %8d  %s\n", modeName(mode), events ? "yes" : "no", catching ? "catching" : "parked",
+           wakeups, sampled, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+}
+
+int main()
+{
+    bool ok = true;
+    for (IdleTimeoutEngine::SchedulingMode mode : { IdleTimeoutEngine::AdaptiveScheduling,
+                                                    IdleTimeoutEngine::FixedScheduling,
+                                                    IdleTimeoutEngine::DeadlineScheduling }) {
+        ok &= checkTransitions(mode);
+    }
+    printf("\na day after all timeouts (1min, 5min) were reached\n");
+    printf("%-9s %-7s %-9s %8s %8s\n", "mode", "events", "state", "wakeups", "queries");
+    for (bool events : { true, false }) {
+        for (bool catching : { false, true }) {
+            for (IdleTimeoutEngine::SchedulingMode mode : { IdleTimeoutEngine::AdaptiveScheduling,
+                                                            IdleTimeoutEngine::FixedScheduling,
+                                                            IdleTimeoutEngine::DeadlineScheduling }) {
+                ok &= parkedDay(mode, events, catching);
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,423 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Compares the instantiations of BasicIdleTimeoutEngine on the small sets of timeouts
+// (1 to 8) that clients register in practice, with the list-based path of the former
+// OSXIdlePoller for reference:
+//   list      a poller behind a virtual interface keeping an implicitly shared list, which
+//             is detached, appended to and re-sorted on registration and scanned on poll,
+//             as the QList<int> was (this build does not need Qt, so the sharing is redone
+//             with a reference-counted std::vector); only its bookkeeping is measured,
+//             without its QTimer and CFDictionary costs, nor the engine's statistics;
+//   heap      IdleClock and IdleTimer interfaces, std::vector storage: the engine as it
+//             was before it became a template;
+//   inline    IdleTimeoutEngine, the instantiation of the plugins (inline storage);
+//   static    non-virtual clock and timer classes with inline storage, the configuration
+//             of an embedded build, where the whole hot path can be inlined.
+// For each, the cost of poll(true) between two timeouts, of a cycle that reports every
+// timeout and resets, and of adding and removing a timeout, in ns per operation (the
+// fastest of 9 repetitions).
+
+#include "idletimeoutengine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+class FakeIdleSource : public IdleTimeSource
+{
+public:
+    FakeIdleSource()
+        : idle(0)
+    {
+    }
+
+    bool queryIdleTime(int64_t &value)
+    {
+        value = idle;
+        return true;
+    }
+
+    int64_t idle;
+};
+
+class NullListener : public IdleEventListener
+{
+public:
+    NullListener()
+        : reached(0)
+    {
+    }
+
+    void timeoutReached(int)
+    {
+        ++reached;
+    }
+
+    void resumingFromIdle() {}
+
+    long reached;
+};
+
+class NullTimer : public IdleTimer
+{
+public:
+    NullTimer()
+        : active(false)
+        , lastInterval(0)
+    {
+    }
+
+    void start(int64_t msecs)
+    {
+        active = true;
+        lastInterval = msecs;
+    }
+
+    void stop()
+    {
+        active = false;
+    }
+
+    bool isActive() const
+    {
+        return active;
+    }
+
+    int64_t interval() const
+    {
+        return lastInterval;
+    }
+
+    bool active;
+    int64_t lastInterval;
+};
+
+class FixedClock : public IdleClock
+{
+public:
+    int64_t now()
+    {
+        return 0;
+    }
+};
+
+// the same, without the interfaces
+class StaticTimer
+{
+public:
+    StaticTimer()
+        : active(false)
+        , lastInterval(0)
+    {
+    }
+
+    void start(int64_t msecs)
+    {
+        active = true;
+        lastInterval = msecs;
+    }
+
+    void startAt(int64_t deadline, int64_t now, int64_t)
+    {
+        start(deadline - now);
+    }
+
+    void stop()
+    {
+        active = false;
+    }
+
+    bool isActive() const
+    {
+        return active;
+    }
+
+    int64_t interval() const
+    {
+        return lastInterval;
+    }
+
+    bool active;
+    int64_t lastInterval;
+};
+
+class StaticClock
+{
+public:
+    int64_t now()
+    {
+        return 0;
+    }
+
+    int64_t suspendedTime()
+    {
+        return 0;
+    }
+};
+
+/**
+ * the part of AbstractSystemPoller the benchmark needs.
+ */
+class ListPoller
+{
+public:
+    virtual ~ListPoller() {}
+    virtual void addTimeout(int msecs) = 0;
+    virtual void removeTimeout(int msecs) = 0;
+    virtual int64_t poll(bool allowEmit) = 0;
+};
+
+/**
+ * the bookkeeping of the former OSXIdlePoller.
+ */
+class FormerPoller : public ListPoller
+{
+public:
+    FormerPoller(IdleTimeSource *source, IdleTimer *timer, IdleEventListener *listener)
+        : m_source(source)
+        , m_timer(timer)
+        , m_listener(listener)
+        , m_timeouts(std::make_shared<std::vector<int> >())
+        , m_minTimeout(-1)
+        , m_maxTimeout(-1)
+        , m_lastTimeout(-1)
+        , m_realIdle(0)
+        , m_idleOffset(0)
+    {
+    }
+
+    void addTimeout(int msecs)
+    {
+        if (std::find(m_timeouts->begin(), m_timeouts->end(), msecs) == m_timeouts->end()) {
+            detach();
+            m_timeouts->push_back(msecs);
+            std::sort(m_timeouts->begin(), m_timeouts->end());
+            updateRange();
+        }
+        poll(false);
+    }
+
+    void removeTimeout(int msecs)
+    {
+        detach();
+        std::vector<int>::iterator it = std::find(m_timeouts->begin(), m_timeouts->end(), msecs);
+        if (it != m_timeouts->end()) {
+            m_timeouts->erase(it);
+        }
+        std::sort(m_timeouts->begin(), m_timeouts->end());
+        updateRange();
+        poll(false);
+    }
+
+    int64_t poll(bool allowEmit)
+    {
+        int64_t idle = m_realIdle;
+        if (m_source->queryIdleTime(idle)) {
+            if (idle < m_realIdle) {
+                m_lastTimeout = -1;
+                m_idleOffset = 0;
+            } else if (idle < m_idleOffset) {
+                m_idleOffset = 0;
+            }
+            m_realIdle = idle;
+        }
+        const int64_t offsetIdle = idle - m_idleOffset;
+        if (allowEmit) {
+            // foreach-style iteration over the shared list
+            const std::shared_ptr<std::vector<int> > timeouts = m_timeouts;
+            for (std::vector<int>::const_iterator it = timeouts->begin(); it != timeouts->end(); ++it) {
+                const int i = *it;
+                if (i > m_lastTimeout && offsetIdle >= i) {
+                    m_lastTimeout = i;
+                    m_listener->timeoutReached(i);
+                    return offsetIdle;
+                }
+            }
+        }
+        if (m_minTimeout > 0) {
+            int64_t next = m_minTimeout;
+            for (std::vector<int>::const_iterator it = m_timeouts->begin(); it != m_timeouts->end(); ++it) {
+                if (*it > m_lastTimeout) {
+                    next = *it;
+                    break;
+                }
+            }
+            m_timer->start(std::max(next - offsetIdle, int64_t(0)));
+        } else {
+            m_timer->stop();
+        }
+        return offsetIdle;
+    }
+
+private:
+    void detach()
+    {
+        if (m_timeouts.use_count() > 1) {
+            m_timeouts = std::make_shared<std::vector<int> >(*m_timeouts);
+        }
+    }
+
+    void updateRange()
+    {
+        m_minTimeout = m_timeouts->empty() ? -1 : m_timeouts->front();
+        m_maxTimeout = m_timeouts->empty() ? -1 : m_timeouts->back();
+    }
+
+    IdleTimeSource *m_source;
+    IdleTimer *m_timer;
+    IdleEventListener *m_listener;
+    std::shared_ptr<std::vector<int> > m_timeouts;
+    int m_minTimeout,
+        m_maxTimeout,
+        m_lastTimeout;
+    int64_t m_realIdle,
+        m_idleOffset;
+};
+
+typedef BasicIdleTimeoutEngine<IdleClockPolicy<>, IdleTimerPolicy<>, HeapTimeoutStorage> HeapEngine;
+typedef BasicIdleTimeoutEngine<IdleClockPolicy<StaticClock>, IdleTimerPolicy<StaticTimer>, InlineTimeoutStorage<8> > StaticEngine;
+
+volatile int64_t sink;
+
+/**
+ * @returns the fastest of 9 runs of @p body, which performs @p operations operations,
+ * in ns per operation.
+ */
+template<typename Body>
+double measure(long operations, Body body)
+{
+    typedef std::chrono::steady_clock Clock;
+    double fastest = 0;
+    for (int i = 0; i < 9; ++i) {
+        const Clock::time_point start = Clock::now();
+        body(operations);
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        const double sample = elapsed.count() / operations;
+        if (i == 0 || sample < fastest) {
+            fastest = sample;
+        }
+    }
+    return fastest;
+}
+
+struct Costs {
+    double poll;
+    double cycle;
+    double registration;
+};
+
+/**
+ * @p Poller has poll(bool), addTimeout() and removeTimeout(), called directly; the former
+ * poller is passed as a ListPoller so that they are virtual calls.
+ */
+template<typename Poller>
+Costs run(Poller &poller, FakeIdleSource &source, int n)
+{
+    const long operations = 1000000;
+    Costs costs;
+    for (int i = 1; i <= n; ++i) {
+        poller.addTimeout(i * 1000);
+    }
+
+    // between the first timeout and the second (or past the only one)
+    source.idle = 0;
+    poller.poll(true);
+    source.idle = 1500;
+    poller.poll(true);
+    costs.poll = measure(operations, [&](long count) {
+        for (long i = 0; i < count; ++i) {
+            sink = poller.poll(true);
+        }
+    });
+
+    // a reset, then one poll per timeout, each reporting it
+    costs.cycle = measure(operations / n, [&](long count) {
+        for (long i = 0; i < count; ++i) {
+            source.idle = 0;
+            poller.poll(true);
+            source.idle = int64_t(n) * 1000;
+            for (int j = 0; j < n; ++j) {
+                sink = poller.poll(true);
+            }
+        }
+    }) / (n + 1);
+
+    // a value in the middle of the list
+    const int msecs = (n / 2) * 1000 + 500;
+    costs.registration = measure(operations / 4, [&](long count) {
+        for (long i = 0; i < count; ++i) {
+            poller.addTimeout(msecs);
+            poller.removeTimeout(msecs);
+        }
+    });
+    return costs;
+}
+
+}
+
+int main()
+{
+    printf("%-8s %9s %14s %14s %16s\n", "path", "timeouts", "poll (ns)", "cycle (ns)", "add+remove (ns)");
+    const int counts[] = { 1, 4, 8 };
+    for (int n : counts) {
+        Costs costs[4];
+        {
+            FakeIdleSource source;
+            NullTimer timer;
+            NullListener listener;
+            FormerPoller former(&source, &timer, &listener);
+            ListPoller &poller = former;
+            costs[0] = run(poller, source, n);
+        }
+        {
+            FakeIdleSource source;
+            NullTimer timer;
+            NullListener listener;
+            FixedClock clock;
+            HeapEngine engine(&source, &timer, &listener, &clock);
+            costs[1] = run(engine, source, n);
+        }
+        {
+            FakeIdleSource source;
+            NullTimer timer;
+            NullListener listener;
+            FixedClock clock;
+            IdleTimeoutEngine engine(&source, &timer, &listener, &clock);
+            costs[2] = run(engine, source, n);
+        }
+        {
+            FakeIdleSource source;
+            StaticTimer timer;
+            NullListener listener;
+            StaticClock clock;
+            StaticEngine engine(&source, &timer, &listener, &clock);
+            costs[3] = run(engine, source, n);
+        }
+        const char *names[] = { "list", "heap", "inline", "static" };
+        for (int i = 0; i < 4; ++i) {
+            printf("%-8s %9d %14.1f %14.1f %16.1f\n", names[i], n, costs[i].poll, costs[i].cycle, costs[i].registration);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Measures the cost of IdleTimeoutEngine::poll(true) as a function of the number of
+// registered timeouts, in the steady state between two hits (half of the timeouts
+// reached, the next one not yet). The former linear scan of the timeout list is
+// measured alongside for reference.
+
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+
+class NullListener : public IdleEventListener
+{
+public:
+    void timeoutReached(int) {}
+    void resumingFromIdle() {}
+};
+
+// the hit test as it was done before the engine got its cursor
+int linearScan(const std::vector<int> &timeouts, int lastTimeout, int64_t idle)
+{
+    for (size_t j = 0; j < timeouts.size(); ++j) {
+        const int i = timeouts[j];
+        if (i > lastTimeout && idle >= i) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+double nsPerCall(const std::chrono::steady_clock::time_point &start, long calls)
+{
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / calls;
+}
+
+}
+
+int main()
+{
+    const long calls = 200000;
+    volatile int sink = 0;
+
+    printf("%10s %16s %16s\n", "timeouts", "engine ns/poll", "scan ns/poll");
+    for (int n = 1; n <= 10000; n *= 10) {
+        VirtualClock clock;
+        VirtualIdleSource source(&clock);
+        VirtualTimer timer(&clock);
+        NullListener listener;
+        IdleTimeoutEngine engine(&source, &timer, &listener);
+        std::vector<int> timeouts;
+        for (int i = 1; i <= n; ++i) {
+            engine.addTimeout(i * 1000);
+            timeouts.push_back(i * 1000);
+        }
+        // reach the first half of the timeouts
+        const int64_t idle = (n / 2) * 1000 + 500;
+        clock.advanceTo(idle);
+        while (engine.nextTimeout() >= 0 && engine.nextTimeout() <= idle) {
+            engine.poll(true);
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (long c = 0; c < calls; ++c) {
+            sink += int(engine.poll(true));
+        }
+        const double enginePoll = nsPerCall(start, calls);
+
+        const int lastTimeout = (n / 2) * 1000;
+        start = std::chrono::steady_clock::now();
+        for (long c = 0; c < calls; ++c) {
+            sink += linearScan(timeouts, lastTimeout, idle);
+        }
+        const double scan = nsPerCall(start, calls);
+
+        printf("%10d %16.1f %16.1f\n", n, enginePoll, scan);
+    }
+    return 0;
+}
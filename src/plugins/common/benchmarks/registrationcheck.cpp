@@ -0,0 +1,179 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Drives the engine's handle-based registrations with a random mix of batch additions,
+// single and batch removals, activity and time passing, in virtual time, and compares the
+// engine to a plain multiset of the registered values after each step:
+//   - timeoutCount(), registrations() and nextTimeout() match the model, while removed
+//     values are still held in the store, and timeouts() matches it once compacted;
+//   - every timeout reported was registered when it was reached, after the last one
+//     reported in the idle period;
+//   - no registered timeout below the idle time is left unreported after time passed.
+// Runs for both storage policies. Exits with 1 on the first mismatch.
+
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <vector>
+
+namespace
+{
+
+const int Steps = 50000;
+
+class Lcg
+{
+public:
+    explicit Lcg(uint64_t seed) : m_state(seed) {}
+    int below(int bound)
+    {
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return int((m_state >> 33) % uint64_t(bound));
+    }
+
+private:
+    uint64_t m_state;
+};
+
+class CheckingListener : public IdleEventListener
+{
+public:
+    CheckingListener() : registered(0), lastReported(-1), failed(false) {}
+
+    void timeoutReached(int msecs)
+    {
+        check(msecs);
+    }
+    void timeoutsReached(const int *msecs, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            check(msecs[i]);
+        }
+    }
+    void resumingFromIdle() {}
+
+    void check(int msecs)
+    {
+        if (!registered->count(msecs) || msecs <= lastReported) {
+            failed = true;
+        }
+        lastReported = msecs;
+    }
+
+    const std::multiset<int> *registered;
+    int lastReported;
+    bool failed;
+};
+
+template<typename Engine>
+bool run(const char *name)
+{
+    VirtualClock clock;
+    VirtualIdleSource source(&clock);
+    VirtualTimer timer(&clock, true);
+    CheckingListener listener;
+    Engine engine(&source, &timer, &listener, &clock);
+    timer.setCallback([&engine]() { engine.timerFired(); });
+    engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+    engine.setActivityEventsAvailable(true);
+
+    std::multiset<int> registered;
+    listener.registered = &registered;
+    std::vector<std::pair<IdleTimeoutEngine::Handle, int> > handles;
+    int64_t activity = 0;
+    Lcg lcg(23);
+    for (int step = 0; step < Steps; ++step) {
+        const int what = lcg.below(16);
+        // around 32 registrations of 40 values, so that values are shared
+        const bool add = what < 9 && lcg.below(64) >= int(handles.size());
+        if (add) {
+            int values[2];
+            IdleTimeoutEngine::Handle added[2];
+            const int count = 1 + lcg.below(2);
+            for (int i = 0; i < count; ++i) {
+                values[i] = 100 * (1 + lcg.below(40));
+            }
+            engine.addTimeouts(values, count, added);
+            for (int i = 0; i < count; ++i) {
+                handles.push_back(std::make_pair(added[i], values[i]));
+                registered.insert(values[i]);
+            }
+        } else if (what < 9) {
+            // one at a time mostly, sometimes a batch, sometimes a stale handle again
+            const int count = std::min(int(handles.size()), lcg.below(4) ? 1 : 1 + lcg.below(4));
+            std::vector<IdleTimeoutEngine::Handle> removed;
+            for (int i = 0; i < count; ++i) {
+                const size_t index = lcg.below(int(handles.size()));
+                removed.push_back(handles[index].first);
+                registered.erase(registered.find(handles[index].second));
+                handles[index] = handles.back();
+                handles.pop_back();
+            }
+            if (!lcg.below(8)) {
+                removed.push_back(removed.front());
+            }
+            engine.removeTimeouts(removed.data(), removed.size());
+        } else if (what < 15) {
+            clock.advance(lcg.below(1500));
+            const int next = engine.nextTimeout();
+            if (next >= 0 && next <= clock.now() - activity) {
+                printf("%s: step %d, timeout %d left unreported at idle time %lld\n", name, step, next,
+                       (long long)(clock.now() - activity));
+                return false;
+            }
+        } else {
+            source.userActivity();
+            activity = clock.now();
+            listener.lastReported = -1;
+            engine.activityAt(activity);
+        }
+        if (listener.failed) {
+            printf("%s: step %d, a timeout was reported that is not registered or out of order\n", name, step);
+            return false;
+        }
+
+        std::set<int> values(registered.begin(), registered.end());
+        std::set<int>::const_iterator above = values.upper_bound(listener.lastReported);
+        const int expectedNext = above == values.end() ? -1 : *above;
+        bool ok = engine.timeoutCount() == int(values.size()) && engine.nextTimeout() == expectedNext;
+        const int probe = 100 * (1 + lcg.below(40));
+        ok = ok && engine.registrations(probe) == int(registered.count(probe));
+        if (ok && step % 7 == 0) {
+            const IdleTimeoutList timeouts = engine.timeouts();
+            ok = std::vector<int>(timeouts.begin(), timeouts.end()) == std::vector<int>(values.begin(), values.end());
+        }
+        if (!ok) {
+            printf("%s: step %d, the engine's registrations differ from the model\n", name, step);
+            return false;
+        }
+    }
+    printf("%-8s %d steps, %d registrations left  ok\n", name, Steps, int(registered.size()));
+    return true;
+}
+
+}
+
+int main()
+{
+    bool ok = run<IdleTimeoutEngine>("inline");
+    ok &= run<BasicIdleTimeoutEngine<IdleClockPolicy<>, IdleTimerPolicy<>, HeapTimeoutStorage> >("heap");
+    return ok ? 0 : 1;
+}
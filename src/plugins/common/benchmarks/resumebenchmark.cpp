@@ -0,0 +1,219 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Catches the end of randomly long idle periods in each scheduling mode, with and without
+// activity events, and measures how long the engine takes to report resumingFromIdle()
+// and how many timer wake-ups it needs while the user is away.
+// Without activity events, every resume must be reported within the resume latency;
+// with them, catching an idle period without timeouts must not wake the timer at all.
+// A threshold registered again after activity seen while no timeout was registered must be
+// reached again in the new idle period, for activity reported by time and by input event.
+// Exits with 1 if a case does not behave as expected.
+
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+
+const int Periods = 2000;
+const int ResumeLatency = 1000;
+
+class Lcg
+{
+public:
+    explicit Lcg(uint64_t seed) : m_state(seed) {}
+    int64_t below(int64_t bound)
+    {
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return int64_t((m_state >> 33) % uint64_t(bound));
+    }
+
+private:
+    uint64_t m_state;
+};
+
+class ResumeListener : public IdleEventListener
+{
+public:
+    void timeoutReached(int)
+    {
+        // as a KIdleTime client would, in order to learn about the end of the idle period
+        engine->catchIdleEvent();
+    }
+    void resumingFromIdle()
+    {
+        resumes.push_back(clock->now());
+    }
+
+    VirtualClock *clock;
+    IdleTimeoutEngine *engine;
+    std::vector<int64_t> resumes;
+};
+
+struct Result {
+    int missed;
+    int spurious;
+    int64_t maxLatency;
+    int64_t totalLatency;
+    int expirations;
+};
+
+Result run(IdleTimeoutEngine::SchedulingMode mode, int resolution, bool events, const std::vector<int> &timeouts)
+{
+    VirtualClock clock;
+    VirtualIdleSource source(&clock);
+    VirtualTimer timer(&clock, mode == IdleTimeoutEngine::DeadlineScheduling);
+    ResumeListener listener;
+    IdleTimeoutEngine engine(&source, &timer, &listener, &clock);
+    listener.clock = &clock;
+    listener.engine = &engine;
+    timer.setCallback([&engine]() { engine.timerFired(); });
+    if (mode == IdleTimeoutEngine::FixedScheduling) {
+        engine.setPollResolution(resolution);
+    } else {
+        engine.setSchedulingMode(mode);
+    }
+    engine.setActivityEventsAvailable(events);
+    engine.setResumeLatency(ResumeLatency);
+    for (int msecs : timeouts) {
+        engine.addTimeout(msecs);
+    }
+
+    Lcg lcg(19);
+    Result result = { 0, 0, 0, 0, 0 };
+    for (int i = 0; i < Periods; ++i) {
+        if (timeouts.empty()) {
+            // the client catches every idle period right away
+            clock.advance(1);
+            engine.catchIdleEvent();
+        }
+        // idle periods from a second to 20 minutes, ending at an arbitrary millisecond
+        const int expirations = timer.expirations();
+        clock.advance(1000 + lcg.below(20 * 60 * 1000));
+        result.expirations += timer.expirations() - expirations;
+        const bool caught = engine.isCatchingIdleEvents();
+        const int64_t activity = clock.now();
+        listener.resumes.clear();
+        source.userActivity();
+        if (events) {
+            engine.activityAt(activity);
+        }
+        clock.advance(ResumeLatency + 500);
+        if (!caught) {
+            result.spurious += int(listener.resumes.size());
+            continue;
+        }
+        if (listener.resumes.size() != 1) {
+            result.missed += listener.resumes.empty();
+            result.spurious += int(listener.resumes.size() > 1);
+            continue;
+        }
+        const int64_t latency = listener.resumes.front() - activity;
+        result.maxLatency = std::max(result.maxLatency, latency);
+        result.totalLatency += latency;
+    }
+    return result;
+}
+
+class CountingListener : public IdleEventListener
+{
+public:
+    CountingListener() : reached(0) {}
+    void timeoutReached(int)
+    {
+        ++reached;
+    }
+    void resumingFromIdle() {}
+
+    int reached;
+};
+
+bool reregistration(bool inputEvent)
+{
+    VirtualClock clock;
+    VirtualIdleSource source(&clock);
+    VirtualTimer timer(&clock, false);
+    CountingListener listener;
+    IdleTimeoutEngine engine(&source, &timer, &listener, &clock);
+    timer.setCallback([&engine]() { engine.timerFired(); });
+    engine.setActivityEventsAvailable(true);
+    for (int i = 0; i < 2; ++i) {
+        engine.addTimeout(1000);
+        clock.advance(1500);
+        engine.removeTimeout(1000);
+        // the activity arrives while nothing is registered
+        source.userActivity();
+        if (inputEvent) {
+            engine.inputEvent();
+        } else {
+            engine.activityAt(clock.now());
+        }
+    }
+    const bool ok = listener.reached == 2;
+    printf("%-28s %7d %9d  %s\n", inputEvent ? "re-registered, input event" : "re-registered, activityAt",
+           listener.reached, 2, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+bool report(const char *name, bool events, const std::vector<int> &timeouts, const Result &result,
+            int maxExpirations)
+{
+    const bool ok = result.missed == 0 && result.spurious == 0
+        && result.maxLatency <= (events ? 0 : ResumeLatency)
+        && (maxExpirations < 0 || result.expirations <= maxExpirations);
+    printf("%-9s %-7s %-9s %7d %9d %8lld %8lld %10d  %s\n", name, events ? "yes" : "no",
+           timeouts.empty() ? "none" : "1m,5m", result.missed, result.spurious,
+           (long long)result.totalLatency / Periods, (long long)result.maxLatency, result.expirations,
+           ok ? "ok" : "FAILED");
+    return ok;
+}
+
+}
+
+int main()
+{
+    const std::vector<int> none;
+    const std::vector<int> some = { 60000, 300000 };
+    bool ok = true;
+    printf("%d idle periods of 1s to 20min, resume latency %dms\n\n", Periods, ResumeLatency);
+    printf("%-9s %-7s %-9s %7s %9s %8s %8s %10s\n", "mode", "events", "timeouts", "missed", "spurious",
+           "avg(ms)", "max(ms)", "wakeups");
+    for (bool events : { false, true }) {
+        for (const std::vector<int> *timeouts : { &none, &some }) {
+            // the steady state with events and nothing to wait for costs no wake-up at all
+            const int maxExpirations = events && timeouts->empty() ? 0 : -1;
+            ok &= report("adaptive", events, *timeouts,
+                         run(IdleTimeoutEngine::AdaptiveScheduling, -1, events, *timeouts), maxExpirations);
+            ok &= report("fixed", events, *timeouts,
+                         run(IdleTimeoutEngine::FixedScheduling, 5000, events, *timeouts),
+                         // polling at a fixed interval is what FixedScheduling is for
+                         timeouts->empty() ? maxExpirations : -1);
+            ok &= report("deadline", events, *timeouts,
+                         run(IdleTimeoutEngine::DeadlineScheduling, -1, events, *timeouts), maxExpirations);
+        }
+    }
+
+    printf("\n%-28s %7s %9s\n", "case", "reached", "expected");
+    ok &= reregistration(false);
+    ok &= reregistration(true);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Measures the idle time queries that readers can make on an IdleSharedPage, with
+// 1 to 16 concurrent reader threads (each with its own read-only mapping, as separate
+// processes would have) while a writer publishes activity, once at a realistic input
+// rate (1 kHz) and once continuously as a worst case for the seqlock. A query through
+// the daemon's socket (IdleDaemonClient::forcePollRequest() without a shared page) is
+// measured for reference. Also checks that a reader gives up at once on a page whose
+// writer died mid-update, and exits with 1 if it does not.
+
+#include "idledaemon.h"
+#include "idledaemonclient.h"
+#include "idlesharedpage.h"
+#include "monotonicclock.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+
+const char *PageName = "/kidletime-sharedpagebenchmark";
+const char *StuckPageName = "/kidletime-sharedpagebenchmark-stuck";
+const std::chrono::milliseconds Duration(500);
+
+class NullListener : public IdleEventListener
+{
+public:
+    void timeoutReached(int) {}
+    void resumingFromIdle() {}
+};
+
+class MonotonicIdleSource : public IdleTimeSource
+{
+public:
+    bool queryIdleTime(int64_t &idle)
+    {
+        idle = 0;
+        return true;
+    }
+};
+
+struct Result {
+    double readsPerSecond;
+    double retriesPerMillion;
+};
+
+// writerPeriod < 0: no writer; 0: continuous
+Result measure(IdleSharedPage *writer, int readers, int writerPeriodUs)
+{
+    std::atomic<bool> stop(false);
+    std::atomic<int64_t> reads(0);
+    std::atomic<int64_t> retries(0);
+    MonotonicClock clock;
+
+    std::thread writerThread([&]() {
+        while (writerPeriodUs >= 0 && !stop.load(std::memory_order_relaxed)) {
+            writer->publish(clock.now());
+            if (writerPeriodUs > 0) {
+                usleep(writerPeriodUs);
+            }
+        }
+    });
+    std::vector<std::thread> readerThreads;
+    for (int i = 0; i < readers; ++i) {
+        readerThreads.push_back(std::thread([&]() {
+            IdleSharedPage *page = IdleSharedPage::open(PageName);
+            int64_t count = 0;
+            volatile int64_t sink = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int j = 0; j < 1000; ++j) {
+                    sink = page->idleTime();
+                }
+                count += 1000;
+            }
+            (void) sink;
+            reads += count;
+            retries += page->readRetries();
+            delete page;
+        }));
+    }
+    std::this_thread::sleep_for(Duration);
+    stop = true;
+    writerThread.join();
+    for (std::thread &thread : readerThreads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(Duration).count();
+    Result result;
+    result.readsPerSecond = reads / seconds;
+    result.retriesPerMillion = reads ? retries * 1e6 / reads : 0;
+    return result;
+}
+
+double daemonRoundTrips()
+{
+    MonotonicClock clock;
+    MonotonicIdleSource source;
+    IdleDaemon daemon(&source, &clock);
+    const std::string path = "/tmp/kidletime-sharedpagebenchmark.socket";
+    if (!daemon.listen(path)) {
+        return 0;
+    }
+    std::atomic<bool> stop(false);
+    std::thread daemonThread([&]() {
+        while (!stop) {
+            daemon.processEvents(10);
+        }
+    });
+    NullListener listener;
+    IdleDaemonClient client(&listener);
+    client.connectToDaemon(path);
+    int64_t count = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < Duration) {
+        client.forcePollRequest();
+        ++count;
+    }
+    stop = true;
+    daemonThread.join();
+    return count / std::chrono::duration<double>(Duration).count();
+}
+
+/**
+ * leaves the sequence number of the page @p name odd, as a writer that died in the
+ * middle of publish() would; the number is the third 32-bit word of the page.
+ */
+bool interruptWriter(const char *name)
+{
+    const int fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    void *address = mmap(0, 3 * sizeof(uint32_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    std::atomic<uint32_t> *sequence = reinterpret_cast<std::atomic<uint32_t>*>(static_cast<uint32_t*>(address) + 2);
+    sequence->fetch_add(1);
+    munmap(address, 3 * sizeof(uint32_t));
+    return true;
+}
+
+bool checkStuckWriter()
+{
+    IdleSharedPage *writer = IdleSharedPage::create(StuckPageName);
+    IdleSharedPage *reader = writer ? IdleSharedPage::open(StuckPageName) : 0;
+    bool ok = false;
+    if (reader) {
+        writer->publish(MonotonicClock().now());
+        if (interruptWriter(StuckPageName)) {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            const IdleSharedPage::Snapshot snapshot = reader->read();
+            const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+            const int64_t attempts = reader->readRetries();
+            ok = snapshot.state == IdleSharedPage::Stopped && reader->idleTime() == -1
+                && elapsed < std::chrono::milliseconds(100);
+            printf("\nstuck writer: read() gave up after %lld attempts in %.3f ms: %s\n",
+                   (long long) attempts,
+                   std::chrono::duration<double, std::milli>(elapsed).count(), ok ? "ok" : "FAILED");
+        }
+    }
+    delete reader;
+    delete writer;
+    return ok;
+}
+
+}
+
+int main()
+{
+    IdleSharedPage *writer = IdleSharedPage::create(PageName);
+    if (!writer) {
+        fprintf(stderr, "cannot create the shared page\n");
+        return 1;
+    }
+    writer->publish(MonotonicClock().now());
+
+    printf("%8s %14s %20s %20s %16s\n", "readers", "writer", "total reads/s", "reads/s/reader", "retries/1M");
+    const int periods[] = { -1, 1000, 0 };
+    const char *periodNames[] = { "none", "1 kHz", "continuous" };
+    for (int p = 0; p < 3; ++p) {
+        for (int readers = 1; readers <= 16; readers *= 2) {
+            const Result result = measure(writer, readers, periods[p]);
+            printf("%8d %14s %20.0f %20.0f %16.1f\n", readers, periodNames[p],
+                   result.readsPerSecond, result.readsPerSecond / readers, result.retriesPerMillion);
+        }
+    }
+    delete writer;
+
+    printf("\ndaemon socket round-trips: %.0f queries/s (1 client)\n", daemonRoundTrips());
+    return checkStuckWriter() ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Measures what the idle detection costs an application at startup, for the portable part
+// of a threaded poller (OSXIdleDispatcher minus IOKit and Cocoa): the engine, the detector
+// and the activity filter. The eager set-up starts the detection thread in setUpPoller(),
+// as the pollers used to; the lazy one defers it to the first consumer (@see IdleActivation).
+// The platform set-up that is deferred with it (the IOHID lookup, the Cocoa event monitor
+// and its processEvents() calls) comes on top and cannot be measured here.
+//
+// Then checks the lazy life cycle: nothing runs and the idle time is not queried until the
+// first timeout or catchIdleEvent(), the detection is set up once for any number of
+// consumers, and torn down when the last timeout is removed or the idle event was caught.
+// Exits with 1 if the life cycle is not as expected.
+
+#include "activityfilter.h"
+#include "idleactivation.h"
+#include "monotonicclock.h"
+#include "threadedidledetector.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+
+const int Startups = 2000;
+
+class CountingSource : public IdleTimeSource
+{
+public:
+    CountingSource()
+        : queries(0)
+    {
+    }
+
+    bool queryIdleTime(int64_t &idle)
+    {
+        ++queries;
+        idle = 0;
+        return true;
+    }
+
+    std::atomic<int> queries;
+};
+
+class Poller;
+
+class Listener : public IdleEventListener
+{
+public:
+    void timeoutReached(int) {}
+    void resumingFromIdle();
+
+    Poller *poller;
+};
+
+/**
+ * the bookkeeping of OSXIdleDispatcher, without the platform parts.
+ */
+class Poller
+{
+public:
+    explicit Poller(bool lazy)
+        : detector(&source, &listener, &clock)
+        , filter(&detector, &clock)
+        , activation([this]() { return activate(); }, [this]() { detector.stop(); })
+        , catching(false)
+        , lazy(lazy)
+        , wakeUps(0)
+    {
+        listener.poller = this;
+        detector.setWakeUp([this]() { ++wakeUps; });
+    }
+
+    bool setUpPoller()
+    {
+        return lazy || activate();
+    }
+
+    bool activate()
+    {
+        detector.start();
+        detector.setActivityEventsAvailable(true);
+        return true;
+    }
+
+    void addTimeout(int msecs)
+    {
+        const bool first = detector.timeouts().empty();
+        detector.addTimeout(msecs);
+        if (first) {
+            activation.acquire();
+        }
+    }
+
+    void removeTimeout(int msecs)
+    {
+        if (detector.timeouts().empty()) {
+            return;
+        }
+        detector.removeTimeout(msecs);
+        if (detector.timeouts().empty()) {
+            activation.release();
+        }
+    }
+
+    void catchIdleEvent()
+    {
+        if (!catching) {
+            catching = true;
+            activation.acquire();
+        }
+        detector.catchIdleEvent();
+    }
+
+    void stopCatchingIdleEvents()
+    {
+        detector.stopCatchingIdleEvents();
+        if (catching) {
+            catching = false;
+            activation.release();
+        }
+    }
+
+    CountingSource source;
+    MonotonicClock clock;
+    Listener listener;
+    ThreadedIdleDetector detector;
+    ActivityFilter filter;
+    IdleActivation activation;
+    bool catching;
+    bool lazy;
+    std::atomic<int> wakeUps;
+};
+
+void Listener::resumingFromIdle()
+{
+    const bool caught = poller->catching;
+    poller->catching = false;
+    if (caught) {
+        poller->activation.release();
+    }
+}
+
+double startupMicroseconds(bool lazy)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Startups; ++i) {
+        Poller poller(lazy);
+        poller.setUpPoller();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / Startups;
+}
+
+bool check(const char *what, bool condition)
+{
+    printf("%-58s %s\n", what, condition ? "ok" : "FAILED");
+    return condition;
+}
+
+}
+
+int main()
+{
+    // warm up the allocator and the thread machinery
+    startupMicroseconds(false);
+    const double eager = startupMicroseconds(false);
+    const double lazy = startupMicroseconds(true);
+    printf("%d application startups (construction, setUpPoller() and destruction)\n", Startups);
+    printf("eager: %8.2f us\nlazy:  %8.2f us\n\n", eager, lazy);
+
+    bool ok = true;
+    Poller poller(true);
+    poller.setUpPoller();
+    ok &= check("phase one starts no thread", !poller.detector.isRunning());
+    poller.detector.setLatenessBudget(1000);
+    poller.detector.setResumeLatency(2000);
+    ok &= check("phase one queries nothing", poller.source.queries == 0);
+
+    poller.addTimeout(60000);
+    poller.addTimeout(300000);
+    poller.catchIdleEvent();
+    ok &= check("the first consumer sets up", poller.detector.isRunning());
+    ok &= check("further consumers do not", poller.activation.setUps() == 1);
+    poller.stopCatchingIdleEvents();
+    poller.removeTimeout(60000);
+    ok &= check("the detection runs while a timeout is left", poller.detector.isRunning());
+    poller.removeTimeout(300000);
+    ok &= check("the last consumer tears down", !poller.detector.isRunning()
+                && poller.activation.consumers() == 0);
+
+    poller.catchIdleEvent();
+    ok &= check("catching sets up again", poller.detector.isRunning() && poller.activation.setUps() == 2);
+    poller.filter.event(ActivityFilter::InputEvent);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (poller.wakeUps == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    poller.detector.deliverEvents();
+    ok &= check("catching the idle event tears down", !poller.detector.isRunning());
+
+    poller.detector.forcePollRequest();
+    ok &= check("a poll while dormant starts no thread", !poller.detector.isRunning());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Runs the same real-time workload through each timer strategy a poller can use on Linux
+// (@see IdleTimerStrategy), and compares their wake-ups and detection lateness:
+// - "timerfd": a LocalIdleDetector in deadline mode, on a TimerFdIdleTimer serviced by an
+//   epoll loop on the owner's thread, like the daemon does;
+// - "thread": a ThreadedIdleDetector, whose events the owner delivers when woken up.
+// The workload is a series of idle periods of various lengths, each ended by an activity
+// event, with the thresholds the periods go past; every run is done without and with a
+// lateness budget. The "qt" and "gcd" strategies need the OS X plugin.
+//
+// A threshold that is missed or reported when it was not reached fails the benchmark.
+
+#include "idlestatistics.h"
+#include "idletimerstrategy.h"
+#include "localidledetector.h"
+#include "monotonicclock.h"
+#include "threadedidledetector.h"
+#include "timerfdidletimer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace
+{
+
+const int Thresholds[] = { 40, 90, 150, 300 };
+/**
+ * the lengths of the idle periods, all well away from the thresholds
+ */
+const int Periods[] = { 330, 120, 60, 200, 330, 20, 115, 180, 330, 70, 250, 330 };
+
+class ActivitySource : public IdleTimeSource
+{
+public:
+    ActivitySource()
+        : lastActivity(clock.now())
+    {
+    }
+
+    bool queryIdleTime(int64_t &idle)
+    {
+        idle = clock.now() - lastActivity.load();
+        return true;
+    }
+
+    MonotonicClock clock;
+    std::atomic<int64_t> lastActivity;
+};
+
+/**
+ * collects the thresholds reported in the current idle period and their lateness.
+ */
+class Recorder : public IdleEventListener
+{
+public:
+    void timeoutReached(int msecs)
+    {
+        reached.push_back(msecs);
+        if (timesDetection) {
+            detected(msecs, clock->now());
+        }
+    }
+
+    void detected(int msecs, int64_t detectedAt)
+    {
+        lateness.push_back(detectedAt - (activity + msecs));
+    }
+
+    void resumingFromIdle() {}
+
+    /**
+     * compares the thresholds reported during a period of @p length with those it went past.
+     */
+    void endPeriod(int length)
+    {
+        std::sort(reached.begin(), reached.end());
+        std::vector<int> expected;
+        for (int threshold : Thresholds) {
+            if (threshold < length) {
+                expected.push_back(threshold);
+            }
+        }
+        for (int threshold : expected) {
+            if (!std::binary_search(reached.begin(), reached.end(), threshold)) {
+                ++missed;
+            }
+        }
+        for (int msecs : reached) {
+            if (!std::binary_search(expected.begin(), expected.end(), msecs)) {
+                ++spurious;
+            }
+        }
+        reached.clear();
+    }
+
+    IdleClock *clock;
+    /**
+     * false when the events are timed at detection rather than in the listener
+     */
+    bool timesDetection = true;
+    int64_t activity;
+    std::vector<int> reached;
+    std::vector<int64_t> lateness;
+    int missed = 0;
+    int spurious = 0;
+};
+
+struct OwnerLoop {
+    void wakeUp()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            woken = true;
+        }
+        condition.notify_one();
+    }
+
+    void waitForWakeUp(int64_t msecs)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait_for(lock, std::chrono::milliseconds(std::max(msecs, int64_t(0))), [this]() { return woken; });
+        woken = false;
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool woken = false;
+};
+
+/**
+ * runs the workload through @p detector; @p wait blocks until the detector needs the owner
+ * or until the given time, and services it.
+ */
+template<typename Wait>
+void workload(IdleDetector &detector, ActivitySource &source, Recorder &recorder, Wait wait)
+{
+    for (int threshold : Thresholds) {
+        detector.addTimeout(threshold);
+    }
+    detector.setActivityEventsAvailable(true);
+    detector.start();
+    recorder.clock = &source.clock;
+    for (int length : Periods) {
+        recorder.activity = source.clock.now();
+        source.lastActivity = recorder.activity;
+        detector.activityAt(recorder.activity);
+        const int64_t end = recorder.activity + length;
+        while (source.clock.now() < end) {
+            wait(end);
+        }
+        recorder.endPeriod(length);
+    }
+    detector.stop();
+}
+
+struct Result {
+    int64_t wakeups;
+    std::vector<int64_t> lateness;
+    int missed;
+    int spurious;
+};
+
+Result timerFdRun(int budget)
+{
+    ActivitySource source;
+    Recorder recorder;
+    TimerFdIdleTimer timer;
+    LocalIdleDetector detector(&source, &timer, &recorder, &source.clock, IdleTimeoutEngine::DeadlineScheduling);
+    detector.setLatenessBudget(budget);
+
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = timer.fd();
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, timer.fd(), &event);
+    workload(detector, source, recorder, [&](int64_t until) {
+        if (epoll_wait(epollFd, &event, 1, int(std::max(until - source.clock.now(), int64_t(0)))) > 0
+                && timer.acknowledge()) {
+            detector.timerFired();
+        }
+    });
+    close(epollFd);
+
+    Result result = { detector.statistics().counter(IdleStatistics::TimerWakeups), recorder.lateness,
+                      recorder.missed, recorder.spurious };
+    return result;
+}
+
+Result threadRun(int budget)
+{
+    ActivitySource source;
+    Recorder recorder;
+    OwnerLoop loop;
+    ThreadedIdleDetector detector(&source, &recorder, &source.clock);
+    detector.setWakeUp([&loop]() { loop.wakeUp(); });
+    detector.setLatenessBudget(budget);
+    // like the other strategy, measured when the engine detects, not when the owner delivers
+    recorder.timesDetection = false;
+
+    workload(detector, source, recorder, [&](int64_t until) {
+        loop.waitForWakeUp(until - source.clock.now());
+        detector.deliverEvents([&](const ThreadedIdleDetector::Event &event) {
+            if (event.type == ThreadedIdleDetector::Event::TimeoutReached) {
+                recorder.detected(event.msecs, event.detectedAt);
+            }
+        });
+    });
+
+    Result result = { detector.statistics().counter(IdleStatistics::TimerWakeups), recorder.lateness,
+                      recorder.missed, recorder.spurious };
+    return result;
+}
+
+int64_t percentile(std::vector<int64_t> &samples, double fraction)
+{
+    if (samples.empty()) {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[std::min(samples.size() - 1, size_t(fraction * samples.size()))];
+}
+
+}
+
+int main()
+{
+    int failures = 0;
+    printf("%-8s %12s %8s %10s %10s %10s %8s %9s\n", "strategy", "budget (ms)", "wakeups",
+           "p50 (ms)", "p99 (ms)", "max (ms)", "missed", "spurious");
+    const IdleTimerStrategy strategies[] = { QtTimerStrategy, GcdTimerStrategy, TimerFdStrategy, ThreadStrategy };
+    const int budgets[] = { -1, 10 };
+    for (IdleTimerStrategy strategy : strategies) {
+        if (!idleTimerStrategyAvailable(strategy) || strategy == QtTimerStrategy) {
+            printf("%-8s %12s (OS X plugin only)\n", idleTimerStrategyName(strategy), "-");
+            continue;
+        }
+        for (int budget : budgets) {
+            Result result = strategy == TimerFdStrategy ? timerFdRun(budget) : threadRun(budget);
+            printf("%-8s %12d %8lld %10lld %10lld %10lld %8d %9d\n", idleTimerStrategyName(strategy), budget,
+                   static_cast<long long>(result.wakeups),
+                   static_cast<long long>(percentile(result.lateness, 0.5)),
+                   static_cast<long long>(percentile(result.lateness, 0.99)),
+                   static_cast<long long>(percentile(result.lateness, 1.0)),
+                   result.missed, result.spurious);
+            failures += result.missed + result.spurious;
+        }
+    }
+    if (failures) {
+        printf("FAILED: %d thresholds missed or reported when not reached\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,201 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Suspends a virtual system for two hours in the middle of an idle period and checks what
+// each suspend policy reports, and when, for idle time sources that do and do not count
+// the time spent suspended. Also counts the timer wake-ups and re-arms the engine needs
+// after the wake-up, which must stay at a handful rather than one per threshold.
+// A clock whose suspended time jitters by a few milliseconds either way, as two clock reads
+// truncated to milliseconds do, must neither count as a suspend nor collapse the thresholds
+// crossed together by an ordinary poll.
+// Exits with 1 if a case does not behave as expected.
+
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int64_t SuspendAt = 30000;
+const int64_t SuspendFor = 2 * 3600 * 1000;
+const int64_t AwakeAfterwards = 20 * 60 * 1000;
+
+struct Report {
+    int64_t at;
+    std::vector<int> timeouts;
+    bool operator==(const Report &other) const
+    {
+        return at == other.at && timeouts == other.timeouts;
+    }
+};
+
+class RecordingListener : public IdleEventListener
+{
+public:
+    void timeoutReached(int msecs)
+    {
+        reports.push_back({ clock->now() - SuspendAt, std::vector<int>(1, msecs) });
+    }
+    void timeoutsReached(const int *msecs, size_t count)
+    {
+        reports.push_back({ clock->now() - SuspendAt, std::vector<int>(msecs, msecs + count) });
+    }
+    void resumingFromIdle() {}
+
+    VirtualClock *clock;
+    std::vector<Report> reports;
+};
+
+std::string format(const std::vector<Report> &reports)
+{
+    std::string text;
+    for (const Report &report : reports) {
+        text += std::to_string(report.at / 1000) + "s[";
+        for (size_t i = 0; i < report.timeouts.size(); ++i) {
+            text += (i ? "," : "") + std::to_string(report.timeouts[i] / 60000);
+        }
+        text += "] ";
+    }
+    return text.empty() ? "-" : text;
+}
+
+bool run(const char *name, IdleTimeoutEngine::SuspendPolicy policy, bool sourceCounts, bool activityOnWake,
+         const std::vector<Report> &expected)
+{
+    VirtualClock clock;
+    VirtualIdleSource source(&clock);
+    source.setCountsSuspendedTime(sourceCounts);
+    VirtualTimer timer(&clock, true);
+    RecordingListener listener;
+    listener.clock = &clock;
+    IdleTimeoutEngine engine(&source, &timer, &listener, &clock);
+    timer.setCallback([&engine]() { engine.timerFired(); });
+    engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+    engine.setSuspendPolicy(policy);
+    engine.setActivityEventsAvailable(true);
+    for (int timeout : { 60000, 300000, 600000, 1800000 }) {
+        engine.addTimeout(timeout);
+    }
+    engine.activityAt(0);
+
+    clock.advanceTo(SuspendAt);
+    clock.suspend(SuspendFor);
+    const int expirations = timer.expirations();
+    const int starts = timer.starts();
+    engine.systemResumed();
+    if (activityOnWake) {
+        clock.advance(1000);
+        source.userActivity();
+        engine.activityAt(clock.now());
+    }
+    clock.advance(AwakeAfterwards);
+
+    const bool ok = listener.reports == expected;
+    printf("%-10s %-7s %-9s %8d %5d  %-34s %s\n", name, sourceCounts ? "yes" : "no", activityOnWake ? "yes" : "no",
+           timer.expirations() - expirations, timer.starts() - starts, format(listener.reports).c_str(),
+           ok ? "ok" : ("EXPECTED " + format(expected)).c_str());
+    return ok;
+}
+
+/**
+ * a VirtualClock as MonotonicClock reads it on a system that never sleeps.
+ */
+class JitteryClock : public IdleClock
+{
+public:
+    explicit JitteryClock(VirtualClock *clock) : m_clock(clock), m_read(0) {}
+    int64_t now()
+    {
+        return m_clock->now();
+    }
+    int64_t suspendedTime()
+    {
+        static const int jitter[] = { 0, 1, 0, -1, 0, -15, 0, 2, 1, 0 };
+        return m_clock->suspendedTime() + jitter[m_read++ % (sizeof(jitter) / sizeof(jitter[0]))];
+    }
+
+private:
+    VirtualClock *m_clock;
+    unsigned m_read;
+};
+
+bool jitter(const char *name, IdleTimeoutEngine::SuspendPolicy policy)
+{
+    VirtualClock clock;
+    JitteryClock jittery(&clock);
+    VirtualIdleSource source(&clock);
+    VirtualTimer timer(&clock, false);
+    RecordingListener listener;
+    listener.clock = &clock;
+    IdleTimeoutEngine engine(&source, &timer, &listener, &jittery);
+    timer.setCallback([&engine]() { engine.timerFired(); });
+    // a coarse poll crosses the three thresholds at once
+    engine.setPollResolution(5000);
+    engine.setSuspendPolicy(policy);
+    for (int timeout : { 1000, 2000, 3000 }) {
+        engine.addTimeout(timeout);
+    }
+    for (int i = 0; i < 20; ++i) {
+        clock.advance(6000);
+        source.userActivity();
+        engine.simulateUserActivity();
+    }
+    int together = 0;
+    for (const Report &report : listener.reports) {
+        together += report.timeouts.size() == 3;
+    }
+    const int64_t suspends = engine.statistics().counter(IdleStatistics::Suspends);
+    const bool ok = suspends == 0 && together == 20 && listener.reports.size() == 20;
+    printf("%-10s %8lld %8d %8d  %s\n", name, (long long)suspends, int(listener.reports.size()), together,
+           ok ? "ok" : "FAILED");
+    return ok;
+}
+
+}
+
+int main()
+{
+    const std::vector<int> all = { 60000, 300000, 600000, 1800000 };
+    bool ok = true;
+    printf("suspended for 2h after 30s of idling, then idle for 20min (reports: time after the wake-up[minutes])\n\n");
+    printf("%-10s %-7s %-9s %8s %5s  %-34s\n", "policy", "counts", "activity", "wakeups", "arms", "reports");
+    for (bool counts : { false, true }) {
+        ok &= run("unaware", IdleTimeoutEngine::SuspendUnaware, counts, false,
+                  counts ? std::vector<Report>{ { 0, all } }
+                         : std::vector<Report>{ { 30000, { 60000 } }, { 270000, { 300000 } }, { 570000, { 600000 } } });
+        ok &= run("count", IdleTimeoutEngine::CountSuspendAsIdle, counts, false, { { 0, all } });
+        ok &= run("ignore", IdleTimeoutEngine::IgnoreSuspend, counts, false,
+                  { { 30000, { 60000 } }, { 270000, { 300000 } }, { 570000, { 600000 } } });
+        ok &= run("collapse", IdleTimeoutEngine::CollapseSuspend, counts, false, { { 0, { 1800000 } } });
+        // the user is back a second after the wake-up: only the thresholds crossed before are reported
+        ok &= run("count", IdleTimeoutEngine::CountSuspendAsIdle, counts, true,
+                  { { 0, all }, { 61000, { 60000 } }, { 301000, { 300000 } }, { 601000, { 600000 } } });
+        ok &= run("ignore", IdleTimeoutEngine::IgnoreSuspend, counts, true,
+                  { { 61000, { 60000 } }, { 301000, { 300000 } }, { 601000, { 600000 } } });
+    }
+
+    printf("\njittering suspended time, 20 idle periods crossing 1s, 2s and 3s in one poll\n\n");
+    printf("%-10s %8s %8s %8s\n", "policy", "suspends", "reports", "all 3");
+    ok &= jitter("count", IdleTimeoutEngine::CountSuspendAsIdle);
+    ok &= jitter("collapse", IdleTimeoutEngine::CollapseSuspend);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,356 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Stress and latency benchmark for ThreadedIdleDetector, meant to be run under
+// ThreadSanitizer as well:
+//     cmake -S src/plugins/common -B build-tsan -DCMAKE_CXX_FLAGS=-fsanitize=thread
+//     cmake --build build-tsan && build-tsan/benchmarks/threadeddetectorbenchmark
+//
+// The owner ("GUI") thread is deliberately blocked for a while after each round of
+// work, as an event loop busy with painting or I/O would be. For each stall length it
+// reports how late the timeouts were detected (relative to the moment the idle time
+// crossed them) and how long the events then waited in the queue until the owner
+// delivered them. The same scenario with the engine running on the owner's thread is
+// measured for comparison: there, detection itself is late by the stall.
+//
+// A final phase floods the command queue with registrations and removals from the owner
+// while the detection thread fires timeouts, and checks that only registered timeouts
+// are ever reported. Another has an owner that does not drain the events at all while it
+// keeps posting commands: the detection thread has to coalesce the events rather than wait,
+// so that neither thread ends up waiting for the other. Exits with 1 if either check fails.
+
+#include "idletimeoutengine.h"
+#include "monotonicclock.h"
+#include "threadedidledetector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const int Thresholds = 10;
+const int Step = 10;
+const int Cycles = 8;
+
+class ActivitySource : public IdleTimeSource
+{
+public:
+    ActivitySource()
+        : lastActivity(clock.now())
+    {
+    }
+
+    bool queryIdleTime(int64_t &idle)
+    {
+        idle = clock.now() - lastActivity.load();
+        return true;
+    }
+
+    MonotonicClock clock;
+    std::atomic<int64_t> lastActivity;
+};
+
+class Recorder : public IdleEventListener
+{
+public:
+    Recorder()
+        : reached(0)
+    {
+    }
+
+    void timeoutReached(int)
+    {
+        ++reached;
+    }
+
+    void resumingFromIdle() {}
+
+    int reached;
+};
+
+struct Stats {
+    std::vector<int64_t> samples;
+
+    void add(int64_t value)
+    {
+        samples.push_back(value);
+    }
+
+    int64_t percentile(double p)
+    {
+        if (samples.empty()) {
+            return 0;
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples[std::min(samples.size() - 1, size_t(p * samples.size()))];
+    }
+};
+
+/**
+ * the owner thread's event loop: it waits for a wake-up, delivers, then stalls.
+ */
+struct OwnerLoop {
+    OwnerLoop()
+        : woken(false)
+    {
+    }
+
+    void wakeUp()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            woken = true;
+        }
+        condition.notify_one();
+    }
+
+    void waitForWakeUp(int msecs)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait_for(lock, std::chrono::milliseconds(msecs), [this]() { return woken; });
+        woken = false;
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool woken;
+};
+
+void threaded(int stall, Stats &detection, Stats &delivery)
+{
+    ActivitySource source;
+    Recorder recorder;
+    OwnerLoop loop;
+    ThreadedIdleDetector detector(&source, &recorder, &source.clock);
+    detector.setWakeUp([&loop]() { loop.wakeUp(); });
+    for (int i = 1; i <= Thresholds; ++i) {
+        detector.addTimeout(i * Step);
+    }
+    detector.start();
+
+    for (int cycle = 0; cycle < Cycles; ++cycle) {
+        const int64_t activity = source.clock.now();
+        source.lastActivity = activity;
+        detector.activityAt(activity);
+        const int expected = recorder.reached + Thresholds;
+        while (recorder.reached < expected) {
+            loop.waitForWakeUp(Step);
+            const int64_t now = source.clock.now();
+            detector.deliverEvents([&](const ThreadedIdleDetector::Event &event) {
+                detection.add(event.detectedAt - (activity + event.msecs));
+                delivery.add(now - event.detectedAt);
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(stall));
+        }
+    }
+    detector.stop();
+}
+
+/**
+ * the engine on the owner's thread, with its timer serviced by the same (stalling) loop.
+ */
+class OwnerThreadBackend : public IdleTimer, public IdleEventListener
+{
+public:
+    OwnerThreadBackend()
+        : active(false)
+        , deadline(0)
+        , lastInterval(0)
+        , reached(0)
+    {
+    }
+
+    void start(int64_t msecs)
+    {
+        lastInterval = msecs;
+        deadline = clock->now() + msecs;
+        active = true;
+    }
+
+    void stop()
+    {
+        active = false;
+    }
+
+    bool isActive() const
+    {
+        return active;
+    }
+
+    int64_t interval() const
+    {
+        return lastInterval;
+    }
+
+    void timeoutReached(int msecs)
+    {
+        ++reached;
+        detection->add(clock->now() - (activity + msecs));
+    }
+
+    void resumingFromIdle() {}
+
+    IdleClock *clock;
+    Stats *detection;
+    bool active;
+    int64_t deadline;
+    int64_t lastInterval;
+    int64_t activity;
+    int reached;
+};
+
+void ownerThread(int stall, Stats &detection)
+{
+    ActivitySource source;
+    OwnerThreadBackend backend;
+    backend.clock = &source.clock;
+    backend.detection = &detection;
+    IdleTimeoutEngine engine(&source, &backend, &backend, &source.clock);
+    engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+    for (int i = 1; i <= Thresholds; ++i) {
+        engine.addTimeout(i * Step);
+    }
+
+    for (int cycle = 0; cycle < Cycles; ++cycle) {
+        backend.activity = source.clock.now();
+        source.lastActivity = backend.activity;
+        engine.activityAt(backend.activity);
+        const int expected = backend.reached + Thresholds;
+        while (backend.reached < expected) {
+            const int64_t wait = backend.active ? backend.deadline - source.clock.now() : Step;
+            if (wait > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+            }
+            if (backend.active && source.clock.now() >= backend.deadline) {
+                backend.active = false;
+                engine.timerFired();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(stall));
+        }
+    }
+}
+
+bool stress()
+{
+    ActivitySource source;
+    Recorder recorder;
+    OwnerLoop loop;
+    ThreadedIdleDetector detector(&source, &recorder, &source.clock);
+    detector.setWakeUp([&loop]() { loop.wakeUp(); });
+    detector.start();
+
+    // the idle time keeps growing, so every newly added small timeout is reached at once
+    source.lastActivity = source.clock.now() - 1000000;
+    int commands = 0;
+    int unexpected = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 2000; ++round) {
+        for (int i = 1; i <= 8; ++i) {
+            detector.addTimeout(round % 7 + i);
+        }
+        detector.activityAt(source.clock.now() - 1000000);
+        for (int i = 1; i <= 8; i += 2) {
+            detector.removeTimeout(round % 7 + i);
+        }
+        commands += 13;
+        detector.deliverEvents([&](const ThreadedIdleDetector::Event &event) {
+            const IdleTimeoutList timeouts = detector.timeouts();
+            if (event.type == ThreadedIdleDetector::Event::TimeoutReached
+                    && !std::binary_search(timeouts.begin(), timeouts.end(), event.msecs)) {
+                ++unexpected;
+            }
+        });
+        std::vector<int> timeouts = detector.timeouts().toVector();
+        for (int msecs : timeouts) {
+            detector.removeTimeout(msecs);
+            ++commands;
+        }
+        if (round % 100 == 0) {
+            detector.forcePollRequest();
+            ++commands;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    detector.stop();
+    printf("\nstress: %d commands in %.3fs (%.0f/s), %d timeouts delivered, %d unexpected, %lld detection wakeups\n",
+           commands, seconds, commands / seconds, recorder.reached, unexpected,
+           static_cast<long long>(detector.timerWakeups()));
+    return unexpected == 0;
+}
+
+bool backlog()
+{
+    ActivitySource source;
+    Recorder recorder;
+    ThreadedIdleDetector detector(&source, &recorder, &source.clock);
+    detector.addTimeout(1);
+    detector.addTimeout(2);
+    detector.start();
+
+    // each round ends an idle period (a resume) and starts one past both timeouts: far
+    // more events, and commands, than the queues hold
+    const int rounds = 5000;
+    for (int round = 0; round < rounds; ++round) {
+        detector.catchIdleEvent();
+        detector.activityAt(source.clock.now() - 1000000);
+    }
+    const int idle = detector.forcePollRequest();
+    // the coalesced events follow as soon as there is room
+    int delivered = detector.deliverEvents();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    delivered += detector.deliverEvents();
+    detector.stop();
+    printf("backlog: %d rounds undrained, %d events delivered, %lld coalesced, poll %s\n", rounds, delivered,
+           static_cast<long long>(detector.coalescedEvents()), idle >= 0 ? "answered" : "timed out");
+    return idle >= 0 && detector.coalescedEvents() > 0 && recorder.reached > 0;
+}
+
+}
+
+int main()
+{
+    printf("%10s | %28s | %28s | %24s\n", "", "threaded: detection late", "threaded: delivery wait",
+           "owner thread: detection");
+    printf("%10s | %13s %14s | %13s %14s | %11s %12s\n", "stall (ms)", "p50 (ms)", "p99 (ms)",
+           "p50 (ms)", "p99 (ms)", "p50 (ms)", "p99 (ms)");
+    const int stalls[] = { 0, 20, 100 };
+    for (int stall : stalls) {
+        Stats detection;
+        Stats delivery;
+        Stats inline_;
+        threaded(stall, detection, delivery);
+        ownerThread(stall, inline_);
+        printf("%10d | %13lld %14lld | %13lld %14lld | %11lld %12lld\n", stall,
+               static_cast<long long>(detection.percentile(0.5)), static_cast<long long>(detection.percentile(0.99)),
+               static_cast<long long>(delivery.percentile(0.5)), static_cast<long long>(delivery.percentile(0.99)),
+               static_cast<long long>(inline_.percentile(0.5)), static_cast<long long>(inline_.percentile(0.99)));
+    }
+    const bool stressed = stress();
+    const bool drained = backlog();
+    if (!stressed || !drained) {
+        printf("FAILED\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Measures how late idle timeouts fire with respect to the moment the idle time crosses
+// them, for a chain of timeouts after a single user activity:
+// - "relative": the way the QTimer and GCD based plugins arm their timers, an interval
+//   re-derived from a fresh (millisecond) idle sample after each expiry;
+// - "absolute": TimerFdIdleTimer with TFD_TIMER_ABSTIME deadlines, with 0%, 1% and 10% slack.
+// A second part runs two independent deadline streams (as two processes would) and counts
+// the distinct wake-ups, to show the batching that the slack allows.
+
+#include "monotonicclock.h"
+#include "timerfdidletimer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace
+{
+
+const int Thresholds = 10;
+const int Spacing = 37;
+const int Cycles = 3;
+
+int64_t nowUs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return int64_t(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+void waitFor(TimerFdIdleTimer &timer)
+{
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = timer.fd();
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, timer.fd(), &event);
+    while (!timer.acknowledge()) {
+        epoll_wait(epollFd, &event, 1, -1);
+    }
+    close(epollFd);
+}
+
+struct Lateness {
+    std::vector<int64_t> samples;
+
+    void print(const char *name)
+    {
+        std::sort(samples.begin(), samples.end());
+        int64_t total = 0;
+        for (int64_t sample : samples) {
+            total += sample;
+        }
+        printf("%-18s %10lld %10lld %10lld %10lld\n", name,
+               static_cast<long long>(samples[samples.size() / 2]),
+               static_cast<long long>(total / int64_t(samples.size())),
+               static_cast<long long>(samples[samples.size() * 99 / 100]),
+               static_cast<long long>(samples.back()));
+    }
+};
+
+/**
+ * @param slack : percent, or -1 for the relative re-derivation
+ */
+void chain(int slack, Lateness &lateness)
+{
+    MonotonicClock clock;
+    TimerFdIdleTimer timer;
+    for (int cycle = 0; cycle < Cycles; ++cycle) {
+        // the deadlines are whole milliseconds
+        const int64_t activity = nowUs() / 1000;
+        const int64_t activityUs = activity * 1000;
+        for (int i = 1; i <= Thresholds; ++i) {
+            const int threshold = i * Spacing;
+            const int64_t now = clock.now();
+            if (slack < 0) {
+                const int64_t idle = now - activity;
+                timer.start(std::max(threshold - idle, int64_t(0)));
+            } else {
+                const int64_t deadline = activity + threshold;
+                timer.startAt(deadline, now, std::max(deadline - now, int64_t(0)) * slack / 100);
+            }
+            waitFor(timer);
+            lateness.samples.push_back(nowUs() - (activityUs + threshold * 1000));
+        }
+    }
+}
+
+int coalescing(int slack)
+{
+    MonotonicClock clock;
+    TimerFdIdleTimer a;
+    TimerFdIdleTimer b;
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &a;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, a.fd(), &event);
+    event.data.ptr = &b;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, b.fd(), &event);
+
+    const int64_t origin = clock.now() + 10;
+    int nextA = 0;
+    int nextB = 0;
+    const int deadlines = 20;
+    const auto armA = [&]() {
+        const int64_t now = clock.now();
+        const int64_t deadline = origin + nextA * 50 + 3;
+        a.startAt(deadline, now, std::max(deadline - now, int64_t(0)) * slack / 100);
+    };
+    const auto armB = [&]() {
+        const int64_t now = clock.now();
+        const int64_t deadline = origin + nextB * 50 + 5;
+        b.startAt(deadline, now, std::max(deadline - now, int64_t(0)) * slack / 100);
+    };
+    armA();
+    armB();
+    int wakeups = 0;
+    while (nextA < deadlines || nextB < deadlines) {
+        epoll_event events[2];
+        const int count = epoll_wait(epollFd, events, 2, -1);
+        if (count <= 0) {
+            continue;
+        }
+        ++wakeups;
+        for (int i = 0; i < count; ++i) {
+            TimerFdIdleTimer *timer = static_cast<TimerFdIdleTimer*>(events[i].data.ptr);
+            if (!timer->acknowledge()) {
+                continue;
+            }
+            if (timer == &a && ++nextA < deadlines) {
+                armA();
+            } else if (timer == &b && ++nextB < deadlines) {
+                armB();
+            }
+        }
+    }
+    close(epollFd);
+    return wakeups;
+}
+
+}
+
+int main()
+{
+    printf("lateness of %d timeouts x %d cycles, in microseconds\n", Thresholds, Cycles);
+    printf("%-18s %10s %10s %10s %10s\n", "timer", "median", "mean", "p99", "max");
+    {
+        Lateness lateness;
+        chain(-1, lateness);
+        lateness.print("relative");
+    }
+    const int slacks[] = { 0, 1, 10 };
+    for (int slack : slacks) {
+        Lateness lateness;
+        chain(slack, lateness);
+        char name[32];
+        snprintf(name, sizeof(name), "absolute, %d%% slack", slack);
+        lateness.print(name);
+    }
+
+    printf("\ntwo streams of 20 deadlines, 2ms apart: wake-ups\n");
+    const int coalescingSlacks[] = { 0, 10, 25 };
+    for (int slack : coalescingSlacks) {
+        printf("%3d%% slack: %d\n", slack, coalescing(slack));
+    }
+    return 0;
+}
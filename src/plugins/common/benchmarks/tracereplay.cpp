@@ -0,0 +1,174 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Evaluates the idle detection policies against activity traces in virtual time.
+//
+//     tracereplay [--days N] [--seed S] [--save FILE] [TRACE...]
+//
+// Without trace files, N (default 1000) synthetic user-days are generated: a working day
+// of 7 to 11 hours made of bursts of coalesced input separated by pauses of very
+// different lengths, followed by the night. --save writes them out as a single trace
+// that can be replayed later. Traces recorded with an ActivityTraceRecorder are
+// replayed as they are. For each policy the tool reports the detection lateness
+// percentiles and the cost of detection (timer wake-ups, arms and idle time queries).
+
+#include "activitytrace.h"
+#include "idletracesimulator.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int64_t Day = 24 * 3600 * 1000;
+
+class Lcg
+{
+public:
+    explicit Lcg(uint64_t seed) : m_state(seed) {}
+    // uniform in (0, 1]
+    double uniform()
+    {
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return double((m_state >> 11) + 1) / double(1ULL << 53);
+    }
+    int64_t exponential(double mean)
+    {
+        return int64_t(-mean * std::log(uniform()));
+    }
+private:
+    uint64_t m_state;
+};
+
+void generateDay(Lcg &lcg, int64_t dayStart, ActivityTraceWriter *writer)
+{
+    int64_t t = dayStart + 7 * 3600 * 1000 + int64_t(lcg.uniform() * 2 * 3600 * 1000);
+    const int64_t end = t + 7 * 3600 * 1000 + int64_t(lcg.uniform() * 4 * 3600 * 1000);
+    while (t < end) {
+        // a burst of input, coalesced to at most one activity per 50ms
+        const int64_t burstEnd = t + lcg.exponential(90000);
+        for (; t < burstEnd && t < end; t += 50 + lcg.exponential(600)) {
+            writer->append(t);
+        }
+        // reading, thinking, a coffee, a meeting
+        const double kind = lcg.uniform();
+        if (kind < 0.7) {
+            t += lcg.exponential(15000);
+        } else if (kind < 0.93) {
+            t += lcg.exponential(180000);
+        } else if (kind < 0.99) {
+            t += lcg.exponential(1200000);
+        } else {
+            t += lcg.exponential(3600000);
+        }
+    }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    int days = 1000;
+    uint64_t seed = 1;
+    const char *saveFile = 0;
+    std::vector<std::string> traceFiles;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--days") && i + 1 < argc) {
+            days = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], 0, 10);
+        } else if (!strcmp(argv[i], "--save") && i + 1 < argc) {
+            saveFile = argv[++i];
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [--days N] [--seed S] [--save FILE] [TRACE...]\n", argv[0]);
+            return 1;
+        } else {
+            traceFiles.push_back(argv[i]);
+        }
+    }
+
+    const std::vector<int> thresholds = { 30000, 60000, 300000, 600000 };
+    const int64_t tail = thresholds.back() + 1000;
+    std::vector<IdleTraceSimulator> simulators = {
+        IdleTraceSimulator(IdleTraceSimulator::AdaptivePolling, thresholds),
+        IdleTraceSimulator(IdleTraceSimulator::DeadlineTimer, thresholds),
+        IdleTraceSimulator(IdleTraceSimulator::FixedPolling, thresholds, 1000),
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    if (traceFiles.empty()) {
+        Lcg lcg(seed);
+        ActivityTraceWriter day;
+        ActivityTraceWriter all;
+        for (int i = 0; i < days; ++i) {
+            day.clear(i * Day);
+            generateDay(lcg, i * Day, &day);
+            ActivityTraceReader trace(day.data().data(), day.data().size());
+            // the night ends the day, up to the origin of the next one
+            int64_t last = i * Day;
+            while (trace.next(last)) {
+                if (saveFile) {
+                    all.append(last);
+                }
+            }
+            for (IdleTraceSimulator &simulator : simulators) {
+                simulator.replay(trace, (i + 1) * Day - last);
+            }
+        }
+        if (saveFile && !all.save(saveFile)) {
+            fprintf(stderr, "cannot write %s\n", saveFile);
+            return 1;
+        }
+    } else {
+        for (const std::string &file : traceFiles) {
+            ActivityTraceReader trace;
+            if (!trace.load(file)) {
+                fprintf(stderr, "%s: not an activity trace\n", file.c_str());
+                return 1;
+            }
+            for (IdleTraceSimulator &simulator : simulators) {
+                simulator.replay(trace, tail);
+            }
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const IdleTraceSimulator::Report first = simulators.front().report();
+    printf("%.1f simulated days, %lld activities, replayed in %.2fs\n\n",
+           double(first.simulatedTime) / Day, (long long)first.activities, seconds);
+    printf("%-9s %9s %9s %9s %12s %12s %12s %7s %7s %7s %7s\n", "policy", "expected", "detected",
+           "spurious", "wakeups/day", "arms/day", "queries/day", "p50", "p90", "p99", "max");
+    for (const IdleTraceSimulator &simulator : simulators) {
+        const IdleTraceSimulator::Report report = simulator.report();
+        const double simulatedDays = double(report.simulatedTime) / Day;
+        printf("%-9s %9lld %9lld %9lld %12.0f %12.0f %12.0f %5lldms %5lldms %5lldms %5lldms\n",
+               IdleTraceSimulator::policyName(simulator.policy()),
+               (long long)report.expected, (long long)report.detected, (long long)report.spurious,
+               report.timerWakeups / simulatedDays, report.timerArms / simulatedDays,
+               report.idleQueries / simulatedDays,
+               (long long)report.latenessP50, (long long)report.latenessP90,
+               (long long)report.latenessP99, (long long)report.latenessMax);
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Replays a simulated day (an 8 hour working day made of bursts of input events separated
+// by idle periods of random length, followed by the night) through the engine in virtual
+// time and reports how many timer wake-ups, timer (re)arms and idle time queries each
+// scheduling strategy costs to detect the same timeouts.
+
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+
+class CountingListener : public IdleEventListener
+{
+public:
+    CountingListener() : hits(0) {}
+    void timeoutReached(int) { ++hits; }
+    void resumingFromIdle() {}
+    int hits;
+};
+
+struct Strategy {
+    const char *name;
+    IdleTimeoutEngine::SchedulingMode mode;
+    bool singleShot;
+};
+
+// a minimal deterministic generator so that every strategy sees the same day
+class Lcg
+{
+public:
+    Lcg() : m_state(12345) {}
+    int64_t next(int64_t min, int64_t max)
+    {
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return min + int64_t((m_state >> 33) % uint64_t(max - min + 1));
+    }
+private:
+    uint64_t m_state;
+};
+
+}
+
+int main()
+{
+    const int64_t workday = 8 * 3600 * 1000;
+    const int64_t day = 24 * 3600 * 1000;
+    const int timeouts[] = { 60000, 300000, 600000, 1800000 };
+    const Strategy strategies[] = {
+        { "adaptive, repeating timer", IdleTimeoutEngine::AdaptiveScheduling, false },
+        { "adaptive, single-shot timer", IdleTimeoutEngine::AdaptiveScheduling, true },
+        { "fixed 1000ms", IdleTimeoutEngine::FixedScheduling, false },
+        { "deadline", IdleTimeoutEngine::DeadlineScheduling, true },
+    };
+
+    // input events every 500ms during bursts of 1 to 20 minutes, separated by 10s to 45min of idling
+    std::vector<int64_t> events;
+    Lcg lcg;
+    for (int64_t t = 0; t < workday;) {
+        const int64_t burstEnd = t + lcg.next(60000, 1200000);
+        for (; t < burstEnd && t < workday; t += 500) {
+            events.push_back(t);
+        }
+        t += lcg.next(10000, 2700000);
+    }
+
+    printf("%-28s %10s %10s %10s %10s\n", "strategy", "wakeups", "arms", "queries", "timeouts");
+    for (const Strategy &strategy : strategies) {
+        VirtualClock clock;
+        VirtualIdleSource source(&clock);
+        VirtualTimer timer(&clock, strategy.singleShot);
+        CountingListener listener;
+        IdleTimeoutEngine engine(&source, &timer, &listener, &clock);
+        timer.setCallback([&engine]() { engine.timerFired(); });
+        if (strategy.mode == IdleTimeoutEngine::FixedScheduling) {
+            engine.setPollResolution(1000);
+        } else {
+            engine.setSchedulingMode(strategy.mode);
+        }
+        // every event is reported to the engine
+        engine.setActivityEventsAvailable(true);
+        for (int timeout : timeouts) {
+            engine.addTimeout(timeout);
+        }
+        for (int64_t t : events) {
+            clock.advanceTo(t);
+            source.userActivity();
+            engine.inputEvent();
+        }
+        clock.advanceTo(day);
+        printf("%-28s %10lld %10d %10d %10d\n", strategy.name,
+               (long long)engine.timerWakeups(), timer.starts(), source.queries(), listener.hits);
+    }
+    return 0;
+}
@@ -0,0 +1,241 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Compares the XSync alarm backend with the adaptive polling of OSXIdleDispatcher's "qt" strategy
+// (an IdleTimeoutEngine in adaptive mode, with a repeating timer, sampling the IDLETIME
+// counter) on a live X server. A child process plays the user, injecting pointer motion
+// through XTEST in bursts separated by increasingly long pauses, like xdotool would.
+// For each strategy the CPU time used by this process, its wake-ups and the number of
+// timeouts detected are reported. Meant to be run under Xvfb:
+//     xvfb-run ./xsynccomparison [seconds per strategy]
+
+#include "idletimeoutengine.h"
+#include "monotonicclock.h"
+#include "xsyncidlealarms.h"
+
+#include <xcb/xtest.h>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+
+const int thresholds[] = { 2000, 5000, 10000 };
+
+class CountingListener : public IdleEventListener
+{
+public:
+    CountingListener() : hits(0), resumes(0), alarms(0) {}
+    void timeoutReached(int) { ++hits; }
+    void resumingFromIdle()
+    {
+        ++resumes;
+        // keep waiting for the next activity, as a screen locker would
+        if (alarms) {
+            alarms->catchIdleEvent();
+        }
+    }
+    int hits;
+    int resumes;
+    XSyncIdleAlarms *alarms;
+};
+
+// a repeating timer, like the QTimer of OSXIdleDispatcher's "qt" strategy, run by the loop in pollingRun()
+class LoopTimer : public IdleTimer
+{
+public:
+    explicit LoopTimer(IdleClock *clock) : m_clock(clock), m_interval(0), m_deadline(0), m_active(false) {}
+    void start(int64_t msecs)
+    {
+        m_interval = msecs > 0 ? msecs : 1;
+        m_deadline = m_clock->now() + m_interval;
+        m_active = true;
+    }
+    void stop() { m_active = false; }
+    bool isActive() const { return m_active; }
+    int64_t interval() const { return m_interval; }
+    int64_t deadline() const { return m_deadline; }
+    void expired() { m_deadline += m_interval; }
+private:
+    IdleClock *m_clock;
+    int64_t m_interval,
+        m_deadline;
+    bool m_active;
+};
+
+class CountingSource : public IdleTimeSource
+{
+public:
+    explicit CountingSource(IdleTimeSource *source) : queries(0), m_source(source) {}
+    bool queryIdleTime(int64_t &idle)
+    {
+        ++queries;
+        return m_source->queryIdleTime(idle);
+    }
+    int queries;
+private:
+    IdleTimeSource *m_source;
+};
+
+void sleepFor(int msecs)
+{
+    struct timespec ts = { msecs / 1000, (msecs % 1000) * 1000000L };
+    nanosleep(&ts, 0);
+}
+
+// the simulated user: 2s of pointer motion, then a pause of 1, 3, 6 or 12 seconds
+pid_t startUser()
+{
+    const pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+    xcb_connection_t *connection = xcb_connect(0, 0);
+    const int pauses[] = { 1000, 3000, 6000, 12000 };
+    for (int i = 0;; ++i) {
+        for (int j = 0; j < 20; ++j) {
+            xcb_test_fake_input(connection, XCB_MOTION_NOTIFY, 1 /* relative */, XCB_CURRENT_TIME,
+                                XCB_NONE, int16_t(j % 2 ? 5 : -5), 0, 0);
+            xcb_flush(connection);
+            sleepFor(100);
+        }
+        sleepFor(pauses[i % 4]);
+    }
+    return 0;
+}
+
+void stopUser(pid_t pid)
+{
+    kill(pid, SIGTERM);
+    waitpid(pid, 0, 0);
+}
+
+double cpuMsecs()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0
+        + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+void report(const char *name, double cpu, long wakeups, long requests, const CountingListener &listener)
+{
+    printf("%-22s %10.1f %10ld %12ld %10d %10d\n", name, cpu, wakeups, requests, listener.hits, listener.resumes);
+}
+
+void alarmRun(xcb_connection_t *connection, int64_t duration)
+{
+    MonotonicClock clock;
+    CountingListener listener;
+    XSyncIdleAlarms alarms(connection, &listener);
+    listener.alarms = &alarms;
+    if (!alarms.initialise()) {
+        fprintf(stderr, "no IDLETIME counter on this X server\n");
+        exit(1);
+    }
+    for (int threshold : thresholds) {
+        alarms.addTimeout(threshold);
+    }
+    alarms.catchIdleEvent();
+
+    const pid_t user = startUser();
+    const double cpuStart = cpuMsecs();
+    const int64_t end = clock.now() + duration;
+    long wakeups = 0;
+    struct pollfd pfd = { xcb_get_file_descriptor(connection), POLLIN, 0 };
+    for (int64_t now = clock.now(); now < end; now = clock.now()) {
+        if (poll(&pfd, 1, int(end - now)) > 0) {
+            ++wakeups;
+            while (xcb_generic_event_t *event = xcb_poll_for_event(connection)) {
+                alarms.handleEvent(event);
+                free(event);
+            }
+        }
+    }
+    const double cpu = cpuMsecs() - cpuStart;
+    stopUser(user);
+    report("XSync alarms", cpu, wakeups, long(alarms.alarmEvents()), listener);
+}
+
+void pollingRun(xcb_connection_t *connection, int64_t duration)
+{
+    MonotonicClock clock;
+    CountingListener listener;
+    XSyncIdleAlarms counter(connection, &listener);
+    if (!counter.initialise()) {
+        fprintf(stderr, "no IDLETIME counter on this X server\n");
+        exit(1);
+    }
+    CountingSource source(&counter);
+    LoopTimer timer(&clock);
+    IdleTimeoutEngine engine(&source, &timer, &listener, &clock);
+    for (int threshold : thresholds) {
+        engine.addTimeout(threshold);
+    }
+    engine.catchIdleEvent();
+
+    const pid_t user = startUser();
+    const double cpuStart = cpuMsecs();
+    const int64_t end = clock.now() + duration;
+    long wakeups = 0;
+    for (int64_t now = clock.now(); now < end; now = clock.now()) {
+        if (!timer.isActive()) {
+            sleepFor(int(end - now));
+            continue;
+        }
+        if (timer.deadline() > now) {
+            sleepFor(int(std::min(timer.deadline(), end) - now));
+            continue;
+        }
+        ++wakeups;
+        timer.expired();
+        engine.timerFired();
+        if (!engine.isCatchingIdleEvents()) {
+            engine.catchIdleEvent();
+        }
+    }
+    const double cpu = cpuMsecs() - cpuStart;
+    stopUser(user);
+    report("adaptive polling", cpu, wakeups, source.queries, listener);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    const int64_t duration = (argc > 1 ? atoi(argv[1]) : 60) * 1000;
+    xcb_connection_t *connection = xcb_connect(0, 0);
+    if (xcb_connection_has_error(connection)) {
+        fprintf(stderr, "cannot connect to the X server (DISPLAY not set?)\n");
+        return 1;
+    }
+    printf("%-22s %10s %10s %12s %10s %10s\n", "strategy", "cpu ms", "wakeups", "X messages", "timeouts", "resumes");
+    alarmRun(connection, duration);
+    pollingRun(connection, duration);
+    xcb_disconnect(connection);
+    return 0;
+}
@@ -0,0 +1,338 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "evdevactivitysource.h"
+#include "activityfilter.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/input.h>
+
+#include <algorithm>
+
+namespace
+{
+
+bool testBit(const unsigned long *bits, int bit)
+{
+    const int width = 8 * sizeof(unsigned long);
+    return (bits[bit / width] >> (bit % width)) & 1;
+}
+
+bool hasAnyBit(const unsigned long *bits, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (bits[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// does the device generate events that indicate a user at work? Sensors (accelerometers,
+// ...) report continuously and would keep the idle time at 0; absolute axes only count on
+// devices with keys or buttons, like touchpads, touchscreens and tablets.
+bool isUserInputDevice(int fd)
+{
+    const int width = 8 * sizeof(unsigned long);
+    unsigned long types[EV_MAX / width + 1] = { 0 };
+    if (ioctl(fd, EVIOCGBIT(0, sizeof(types)), types) < 0) {
+        return false;
+    }
+#ifdef INPUT_PROP_ACCELEROMETER
+    unsigned long properties[INPUT_PROP_MAX / width + 1] = { 0 };
+    if (ioctl(fd, EVIOCGPROP(sizeof(properties)), properties) >= 0
+            && testBit(properties, INPUT_PROP_ACCELEROMETER)) {
+        return false;
+    }
+#endif
+    if (testBit(types, EV_REL)) {
+        return true;
+    }
+    unsigned long keys[KEY_MAX / width + 1] = { 0 };
+    return testBit(types, EV_KEY) && ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) >= 0
+        && hasAnyBit(keys, sizeof(keys) / sizeof(keys[0]));
+}
+
+bool isUserInputEvent(const struct input_event &event)
+{
+    return event.type == EV_KEY || event.type == EV_REL || event.type == EV_ABS;
+}
+
+int64_t timestamp(const struct input_event &event)
+{
+#ifdef input_event_sec
+    return int64_t(event.input_event_sec) * 1000 + event.input_event_usec / 1000;
+#else
+    return int64_t(event.time.tv_sec) * 1000 + event.time.tv_usec / 1000;
+#endif
+}
+
+}
+
+EvdevActivitySource::EvdevActivitySource(IdleClock *clock)
+    : m_clock(clock)
+    , m_filter(0)
+    , m_epollFd(epoll_create1(EPOLL_CLOEXEC))
+    , m_inotifyFd(-1)
+    , m_lastActivity(clock->now())
+{
+}
+
+EvdevActivitySource::~EvdevActivitySource()
+{
+    for (const Device &device : m_devices) {
+        if (device.owned) {
+            close(device.fd);
+        }
+    }
+    if (m_inotifyFd >= 0) {
+        close(m_inotifyFd);
+    }
+    if (m_epollFd >= 0) {
+        close(m_epollFd);
+    }
+}
+
+int EvdevActivitySource::openDevices(const char *directory)
+{
+    DIR *dir = opendir(directory);
+    if (!dir) {
+        return 0;
+    }
+    // before the enumeration, so that no device plugged in meanwhile is missed
+    watchDirectory(directory);
+    int opened = 0;
+    while (struct dirent *entry = readdir(dir)) {
+        if (openDevice(entry->d_name)) {
+            ++opened;
+        }
+    }
+    closedir(dir);
+    return opened;
+}
+
+bool EvdevActivitySource::openDevice(const char *name)
+{
+    if (strncmp(name, "event", 5) != 0) {
+        return false;
+    }
+    const std::string path = m_directory + "/" + name;
+    struct stat info;
+    if (stat(path.c_str(), &info) < 0) {
+        return false;
+    }
+    for (const Device &device : m_devices) {
+        if (device.rdev == info.st_rdev) {
+            return false;
+        }
+    }
+    const int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        // udev may not have granted access yet: IN_ATTRIB follows when it does
+        return false;
+    }
+    if (!isUserInputDevice(fd)) {
+        close(fd);
+        return false;
+    }
+    // timestamp the events on the monotonic clock instead of the wall clock
+    int clockId = CLOCK_MONOTONIC;
+    ioctl(fd, EVIOCSCLOCKID, &clockId);
+    if (!addDevice(fd, true)) {
+        return false;
+    }
+    m_devices.back().rdev = info.st_rdev;
+    return true;
+}
+
+void EvdevActivitySource::watchDirectory(const char *directory)
+{
+    m_directory = directory;
+    if (m_inotifyFd >= 0 || m_epollFd < 0) {
+        return;
+    }
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        return;
+    }
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = m_inotifyFd;
+    if (inotify_add_watch(m_inotifyFd, directory, IN_CREATE | IN_ATTRIB) < 0
+            || epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_inotifyFd, &event) < 0) {
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+}
+
+void EvdevActivitySource::readHotplugEvents()
+{
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t n = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        for (const char *p = buffer; p < buffer + n;) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(p);
+            if (event->len) {
+                openDevice(event->name);
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+
+bool EvdevActivitySource::addDevice(int fd, bool takeOwnership)
+{
+    if (m_epollFd < 0 || fd < 0) {
+        return false;
+    }
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        if (takeOwnership) {
+            close(fd);
+        }
+        return false;
+    }
+    Device device = { fd, takeOwnership, 0 };
+    m_devices.push_back(device);
+    return true;
+}
+
+void EvdevActivitySource::removeDevice(int fd)
+{
+    for (std::vector<Device>::iterator it = m_devices.begin(); it != m_devices.end(); ++it) {
+        if (it->fd == fd) {
+            epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, 0);
+            if (it->owned) {
+                close(fd);
+            }
+            m_devices.erase(it);
+            return;
+        }
+    }
+}
+
+int EvdevActivitySource::deviceCount() const
+{
+    return int(m_devices.size());
+}
+
+int EvdevActivitySource::epollFd() const
+{
+    return m_epollFd;
+}
+
+void EvdevActivitySource::setActivityFilter(ActivityFilter *filter)
+{
+    m_filter = filter;
+}
+
+void EvdevActivitySource::attachEngine(IdleTimeoutEngine *engine, ActivityFilter *filter)
+{
+    engine->setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+    engine->setActivityEventsAvailable(true);
+    setActivityFilter(filter);
+}
+
+int EvdevActivitySource::dispatch(int timeout)
+{
+    if (m_epollFd < 0) {
+        return 0;
+    }
+    struct epoll_event ready[16];
+    const int nReady = epoll_wait(m_epollFd, ready, 16, timeout);
+    int inputEvents = 0;
+    int64_t latest = -1;
+    bool removed = false;
+    for (int i = 0; i < nReady; ++i) {
+        const int fd = ready[i].data.fd;
+        if (fd == m_inotifyFd) {
+            readHotplugEvents();
+            continue;
+        }
+        struct input_event events[64];
+        for (;;) {
+            const ssize_t n = read(fd, events, sizeof(events));
+            if (n > 0) {
+                for (size_t j = 0; j < size_t(n) / sizeof(struct input_event); ++j) {
+                    if (isUserInputEvent(events[j])) {
+                        ++inputEvents;
+                        latest = std::max(latest, timestamp(events[j]));
+                    }
+                }
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n == 0 || (n < 0 && errno != EAGAIN)) {
+                // end of a recorded stream, or the device was unplugged (ENODEV)
+                removeDevice(fd);
+                removed = true;
+            }
+            break;
+        }
+    }
+    if (removed && m_inotifyFd >= 0) {
+        // a replugged device may have been announced before the old one reported ENODEV
+        const std::string directory = m_directory;
+        openDevices(directory.c_str());
+    }
+    if (inputEvents) {
+        // events are never in the future; clamp timestamps from clocks that drifted apart
+        const int64_t now = m_clock->now();
+        latest = std::min(latest, now);
+        if (latest > m_lastActivity) {
+            m_lastActivity = latest;
+        }
+        if (m_filter) {
+            m_filter->event(ActivityFilter::InputEvent, m_lastActivity);
+        }
+    }
+    return inputEvents;
+}
+
+bool EvdevActivitySource::queryIdleTime(int64_t &idle)
+{
+    idle = std::max(m_clock->now() - m_lastActivity, int64_t(0));
+    return true;
+}
+
+int64_t EvdevActivitySource::lastActivity() const
+{
+    return m_lastActivity;
+}
@@ -0,0 +1,129 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef EVDEVACTIVITYSOURCE_H
+#define EVDEVACTIVITYSOURCE_H
+
+#include "idlebackend.h"
+#include "idletimeoutengine.h"
+
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+class ActivityFilter;
+
+/**
+ * An event-driven IdleTimeSource for Linux that reads the kernel's input events
+ * from evdev device nodes (/dev/input/event*) and remembers the time of the last one.
+ * The idle time is then simply the time elapsed since that event: answering a query
+ * costs a clock read, and nothing has to be polled.
+ *
+ * The devices are multiplexed through an epoll instance. Its descriptor (epollFd())
+ * becomes readable when input is pending, at which point the owner calls dispatch();
+ * this fits into any event loop (a QSocketNotifier, another epoll set, ...).
+ *
+ * Any readable descriptor delivering struct input_event records can be added with
+ * addDevice(); a pipe fed with a recorded event stream acts as a fake device.
+ *
+ * The directory opened by openDevices() is watched with inotify through the same epoll
+ * instance, so that devices plugged in later (or plugged in again after being removed on
+ * ENODEV) are opened by dispatch(), with the same selection.
+ *
+ * The event timestamps are interpreted on the clock passed to the constructor. Real
+ * devices are switched to CLOCK_MONOTONIC timestamps so that they match a MonotonicClock.
+ */
+class EvdevActivitySource : public IdleTimeSource
+{
+public:
+    explicit EvdevActivitySource(IdleClock *clock);
+    ~EvdevActivitySource();
+
+    /**
+     * opens all event devices in @p directory that report keys, buttons or pointer motion,
+     * leaving out sensors such as accelerometers.
+     * @returns the number of devices opened; 0 typically means that the user lacks the
+     * permissions to read them.
+     */
+    int openDevices(const char *directory = "/dev/input");
+    /**
+     * adds an already opened, non-blocking descriptor.
+     * @param takeOwnership : close @p fd when it is removed or on destruction
+     */
+    bool addDevice(int fd, bool takeOwnership = true);
+    void removeDevice(int fd);
+    int deviceCount() const;
+
+    /**
+     * @returns the epoll descriptor to watch for readability, or -1.
+     */
+    int epollFd() const;
+    /**
+     * reads all pending input events.
+     * @param timeout : how long to wait for events, in milliseconds (-1 = indefinitely)
+     * @returns the number of user input events read
+     */
+    int dispatch(int timeout = 0);
+
+    /**
+     * when set, the filter is told about each batch of input events read by dispatch().
+     */
+    void setActivityFilter(ActivityFilter *filter);
+    /**
+     * configures @p engine for this source, as the evdev plugin uses it: @p filter (which
+     * feeds @p engine) is told about the input events, and since it sees all of them the
+     * engine neither samples the idle time while parked nor polls for the end of an idle
+     * period. The deadline scheduling mode keeps a single wake-up per timeout.
+     */
+    void attachEngine(IdleTimeoutEngine *engine, ActivityFilter *filter);
+
+    bool queryIdleTime(int64_t &idle);
+    /**
+     * @returns the time of the last input event on the clock, or the creation time of
+     * this object if no event has been seen yet.
+     */
+    int64_t lastActivity() const;
+
+private:
+    struct Device {
+        int fd;
+        bool owned;
+        /**
+         * the device number of a device node, 0 for other descriptors
+         */
+        dev_t rdev;
+    };
+
+    /**
+     * opens the event device @p name in the watched directory, unless it is open already.
+     */
+    bool openDevice(const char *name);
+    void watchDirectory(const char *directory);
+    void readHotplugEvents();
+
+    IdleClock *m_clock;
+    ActivityFilter *m_filter;
+    int m_epollFd;
+    int m_inotifyFd;
+    std::string m_directory;
+    std::vector<Device> m_devices;
+    int64_t m_lastActivity;
+};
+
+#endif /* EVDEVACTIVITYSOURCE_H */
@@ -0,0 +1,73 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idleactivation.h"
+
+IdleActivation::IdleActivation(const std::function<bool()> &setUp, const std::function<void()> &tearDown)
+    : m_setUp(setUp)
+    , m_tearDown(tearDown)
+    , m_consumers(0)
+    , m_setUps(0)
+    , m_active(false)
+{
+}
+
+bool IdleActivation::acquire()
+{
+    ++m_consumers;
+    if (!m_active && m_setUp()) {
+        m_active = true;
+        ++m_setUps;
+    }
+    return m_active;
+}
+
+void IdleActivation::release()
+{
+    if (m_consumers == 0) {
+        return;
+    }
+    if (--m_consumers == 0 && m_active) {
+        m_active = false;
+        m_tearDown();
+    }
+}
+
+void IdleActivation::reset()
+{
+    m_consumers = 0;
+    if (m_active) {
+        m_active = false;
+        m_tearDown();
+    }
+}
+
+bool IdleActivation::isActive() const
+{
+    return m_active;
+}
+
+int IdleActivation::consumers() const
+{
+    return m_consumers;
+}
+
+int IdleActivation::setUps() const
+{
+    return m_setUps;
+}
@@ -0,0 +1,69 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLEACTIVATION_H
+#define IDLEACTIVATION_H
+
+#include <functional>
+
+/**
+ * The second phase of a poller's two-phase set-up. setUpPoller() runs on the startup path
+ * of every application that links KIdleTime, including those that never register a timeout,
+ * so it only does what is cheap; the expensive part (installing the event monitor, starting
+ * the detection thread or timer) is done by the set-up function given here when the first
+ * consumer arrives, and undone by the tear-down function when the last one goes away.
+ *
+ * A consumer is anything that needs the detection to run: typically one for the whole list
+ * of timeouts, while it is not empty, and one while the end of an idle period is caught.
+ * A set-up that fails is retried by the next acquire().
+ */
+class IdleActivation
+{
+public:
+    IdleActivation(const std::function<bool()> &setUp, const std::function<void()> &tearDown);
+
+    /**
+     * registers a consumer, setting up if it is the first one.
+     * @returns true if the detection is set up.
+     */
+    bool acquire();
+    /**
+     * unregisters a consumer, tearing down if it was the last one.
+     */
+    void release();
+    /**
+     * tears down and forgets about the consumers, typically when unloading the poller.
+     */
+    void reset();
+
+    bool isActive() const;
+    int consumers() const;
+    /**
+     * @returns how many times the set-up function succeeded.
+     */
+    int setUps() const;
+
+private:
+    std::function<bool()> m_setUp;
+    std::function<void()> m_tearDown;
+    int m_consumers;
+    int m_setUps;
+    bool m_active;
+};
+
+#endif /* IDLEACTIVATION_H */
@@ -0,0 +1,306 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idleawaitables.h"
+
+#include <algorithm>
+
+IdleAwaitables::IdleAwaiter::IdleAwaiter(IdleAwaitables *awaitables, int msecs)
+{
+    m_waiter.awaitables = awaitables;
+    m_waiter.msecs = msecs;
+}
+
+IdleAwaitables::IdleAwaiter::~IdleAwaiter()
+{
+    if (m_waiter.list) {
+        m_waiter.awaitables->cancel(&m_waiter);
+    }
+}
+
+void IdleAwaitables::IdleAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+{
+    m_waiter.awaitables->suspend(&m_waiter, coroutine);
+}
+
+IdleAwaitables::ActivityAwaiter::ActivityAwaiter(IdleAwaitables *awaitables)
+{
+    m_waiter.awaitables = awaitables;
+}
+
+IdleAwaitables::ActivityAwaiter::~ActivityAwaiter()
+{
+    if (m_waiter.list) {
+        m_waiter.awaitables->cancel(&m_waiter);
+    }
+}
+
+void IdleAwaitables::ActivityAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+{
+    m_waiter.awaitables->suspend(&m_waiter, coroutine);
+}
+
+IdleAwaitables::FirstOfAwaiter::FirstOfAwaiter(IdleAwaiter idle, ActivityAwaiter activity)
+    : m_idle(idle)
+    , m_activity(activity)
+    , m_outcome(IdleReached)
+{
+}
+
+void IdleAwaitables::FirstOfAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+{
+    Waiter *idle = &m_idle.m_waiter;
+    Waiter *activity = &m_activity.m_waiter;
+    idle->sibling = activity;
+    idle->outcome = &m_outcome;
+    activity->sibling = idle;
+    activity->outcome = &m_outcome;
+    idle->awaitables->suspend(idle, coroutine);
+    activity->awaitables->suspend(activity, coroutine);
+}
+
+IdleAwaitables::IdleAwaitables(IdleEventListener *next)
+    : m_next(next)
+    , m_engine(nullptr)
+    , m_nextCatching(false)
+{
+}
+
+IdleAwaitables::~IdleAwaitables()
+{
+    // leave nothing registered in the engine; the awaiters find themselves unlinked
+    List *lists[] = { &m_idleWaiters, &m_activityWaiters, &m_ready };
+    for (List *list : lists) {
+        while (list->first) {
+            release(list->first);
+        }
+    }
+}
+
+void IdleAwaitables::setEngine(IdleTimeoutEngine *engine)
+{
+    m_engine = engine;
+}
+
+void IdleAwaitables::setWakeUp(const std::function<void()> &wakeUp)
+{
+    m_wakeUp = wakeUp;
+}
+
+IdleAwaitables::IdleAwaiter IdleAwaitables::idleFor(std::chrono::milliseconds duration)
+{
+    return IdleAwaiter(this, int(std::max<std::chrono::milliseconds::rep>(duration.count(), 1)));
+}
+
+IdleAwaitables::ActivityAwaiter IdleAwaitables::nextActivity()
+{
+    return ActivityAwaiter(this);
+}
+
+IdleAwaitables::FirstOfAwaiter IdleAwaitables::firstOf(IdleAwaiter idle, ActivityAwaiter activity)
+{
+    return FirstOfAwaiter(idle, activity);
+}
+
+int IdleAwaitables::resumeReady()
+{
+    int resumed = 0;
+    // a resumed coroutine can suspend again, but not become ready before the next event
+    while (Waiter *waiter = m_ready.first) {
+        remove(waiter);
+        ++resumed;
+        waiter->coroutine.resume();
+    }
+    return resumed;
+}
+
+int IdleAwaitables::pendingCount() const
+{
+    int count = 0;
+    const List *lists[] = { &m_idleWaiters, &m_activityWaiters, &m_ready };
+    for (const List *list : lists) {
+        for (const Waiter *waiter = list->first; waiter; waiter = waiter->next) {
+            // the two waiters of a firstOf() are one await
+            if (!waiter->sibling || waiter->msecs >= 0 || !waiter->sibling->list) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+void IdleAwaitables::catchIdleEvent()
+{
+    m_nextCatching = true;
+    m_engine->catchIdleEvent();
+}
+
+void IdleAwaitables::stopCatchingIdleEvents()
+{
+    m_nextCatching = false;
+    if (m_activityWaiters.isEmpty()) {
+        m_engine->stopCatchingIdleEvents();
+    }
+}
+
+void IdleAwaitables::timeoutReached(int msecs)
+{
+    // pass on the timeouts that others registered too, before releasing ours
+    if (m_next && m_engine->registrations(msecs) > ownRegistrations(msecs)) {
+        m_next->timeoutReached(msecs);
+    }
+    fireIdle(msecs);
+}
+
+void IdleAwaitables::timeoutsReached(const int *msecs, size_t count)
+{
+    if (m_next) {
+        m_forwarded.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (m_engine->registrations(msecs[i]) > ownRegistrations(msecs[i])) {
+                m_forwarded.push_back(msecs[i]);
+            }
+        }
+        if (m_forwarded.size() == 1) {
+            m_next->timeoutReached(m_forwarded.front());
+        } else if (!m_forwarded.empty()) {
+            m_next->timeoutsReached(m_forwarded.data(), m_forwarded.size());
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        fireIdle(msecs[i]);
+    }
+}
+
+void IdleAwaitables::resumingFromIdle()
+{
+    // the engine stops catching after this
+    if (m_nextCatching) {
+        m_nextCatching = false;
+        if (m_next) {
+            m_next->resumingFromIdle();
+        }
+    }
+    while (Waiter *waiter = m_activityWaiters.first) {
+        fire(waiter, ActivitySeen);
+    }
+}
+
+void IdleAwaitables::append(List &list, Waiter *waiter)
+{
+    waiter->list = &list;
+    waiter->previous = list.last;
+    waiter->next = nullptr;
+    if (list.last) {
+        list.last->next = waiter;
+    } else {
+        list.first = waiter;
+    }
+    list.last = waiter;
+}
+
+void IdleAwaitables::remove(Waiter *waiter)
+{
+    List *list = waiter->list;
+    if (waiter->previous) {
+        waiter->previous->next = waiter->next;
+    } else {
+        list->first = waiter->next;
+    }
+    if (waiter->next) {
+        waiter->next->previous = waiter->previous;
+    } else {
+        list->last = waiter->previous;
+    }
+    waiter->list = nullptr;
+    waiter->previous = waiter->next = nullptr;
+}
+
+void IdleAwaitables::suspend(Waiter *waiter, std::coroutine_handle<> coroutine)
+{
+    waiter->coroutine = coroutine;
+    if (waiter->msecs >= 0) {
+        append(m_idleWaiters, waiter);
+        m_engine->addTimeouts(&waiter->msecs, 1, &waiter->handle);
+    } else {
+        append(m_activityWaiters, waiter);
+        if (!m_engine->isCatchingIdleEvents()) {
+            m_engine->catchIdleEvent();
+        }
+    }
+}
+
+void IdleAwaitables::release(Waiter *waiter)
+{
+    const bool registered = waiter->list == &m_idleWaiters;
+    remove(waiter);
+    if (registered) {
+        const IdleTimeoutEngine::Handle handle = waiter->handle;
+        waiter->handle = IdleTimeoutEngine::InvalidHandle;
+        m_engine->removeTimeouts(&handle, 1);
+    }
+}
+
+void IdleAwaitables::cancel(Waiter *waiter)
+{
+    const bool catching = waiter->list == &m_activityWaiters;
+    release(waiter);
+    if (catching && m_activityWaiters.isEmpty() && !m_nextCatching) {
+        m_engine->stopCatchingIdleEvents();
+    }
+}
+
+void IdleAwaitables::fire(Waiter *waiter, Event event)
+{
+    release(waiter);
+    if (waiter->sibling && waiter->sibling->list) {
+        cancel(waiter->sibling);
+    }
+    if (waiter->outcome) {
+        *waiter->outcome = event;
+    }
+    const bool wasIdle = m_ready.isEmpty();
+    append(m_ready, waiter);
+    if (wasIdle && m_wakeUp) {
+        m_wakeUp();
+    }
+}
+
+void IdleAwaitables::fireIdle(int msecs)
+{
+    Waiter *waiter = m_idleWaiters.first;
+    while (waiter) {
+        // firing can cancel a sibling, which is never in this list
+        Waiter *next = waiter->next;
+        if (waiter->msecs == msecs) {
+            fire(waiter, IdleReached);
+        }
+        waiter = next;
+    }
+}
+
+int IdleAwaitables::ownRegistrations(int msecs) const
+{
+    int count = 0;
+    for (const Waiter *waiter = m_idleWaiters.first; waiter; waiter = waiter->next) {
+        if (waiter->msecs == msecs) {
+            ++count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,251 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLEAWAITABLES_H
+#define IDLEAWAITABLES_H
+
+#include "idlebackend.h"
+#include "idletimeoutengine.h"
+
+#include <chrono>
+#include <coroutine>
+#include <functional>
+#include <vector>
+
+/**
+ * C++20 awaitables on top of an IdleTimeoutEngine, for consumers that would otherwise
+ * wire timeoutReached() and resumingFromIdle() into state machines of their own:
+ *
+ *     co_await awaitables.idleFor(std::chrono::minutes(5));
+ *     dimScreen();
+ *     co_await awaitables.nextActivity();
+ *     if (co_await awaitables.firstOf(awaitables.idleFor(10min), awaitables.nextActivity())
+ *             == IdleAwaitables::IdleReached) { ... }
+ *
+ * An awaited idleFor() registers its threshold with the engine (through a handle, so that
+ * it coexists with the other registrations of the same value) and unregisters it when it
+ * completes or is cancelled; an awaited nextActivity() has the engine catch the end of the
+ * idle period. The engine's own timer does the waiting: there are no extra timers. The
+ * waiters live in the awaiters, i.e. in the coroutine frames, and are chained in intrusive
+ * lists, so awaiting allocates nothing beyond the frame.
+ *
+ * IdleAwaitables is the engine's listener. The events of the registrations made by others
+ * are passed on to @p next; whoever wants resumingFromIdle() passed on as well has to go
+ * through catchIdleEvent() and stopCatchingIdleEvents() here rather than on the engine.
+ *
+ * The coroutines are not resumed from within the engine: the waiters whose event occurred
+ * are queued, and resumeReady() resumes them, typically from the owner's event loop after
+ * the wake-up callback. Destroying a suspended coroutine cancels what it awaits; so does
+ * the firstOf() awaitable for the alternative that did not happen.
+ *
+ * Everything happens on the engine's thread, and the coroutines have to be destroyed or
+ * finished before this object.
+ */
+class IdleAwaitables : public IdleEventListener
+{
+public:
+    /**
+     * what ended a firstOf().
+     */
+    enum Event {
+        IdleReached,
+        ActivitySeen
+    };
+
+    struct Waiter;
+
+    struct List {
+        Waiter *first = nullptr;
+        Waiter *last = nullptr;
+
+        bool isEmpty() const
+        {
+            return !first;
+        }
+    };
+
+    /**
+     * the bookkeeping of one suspended await, stored in the awaiter.
+     */
+    struct Waiter {
+        IdleAwaitables *awaitables = nullptr;
+        /**
+         * the list the waiter is in (waiting or ready), or null.
+         */
+        List *list = nullptr;
+        Waiter *previous = nullptr;
+        Waiter *next = nullptr;
+        std::coroutine_handle<> coroutine;
+        /**
+         * the threshold of an idle waiter, -1 for an activity waiter.
+         */
+        int msecs = -1;
+        IdleTimeoutEngine::Handle handle = IdleTimeoutEngine::InvalidHandle;
+        /**
+         * in a firstOf(), the waiter of the other alternative and where to report the outcome.
+         */
+        Waiter *sibling = nullptr;
+        Event *outcome = nullptr;
+    };
+
+    class IdleAwaiter
+    {
+    public:
+        IdleAwaiter(IdleAwaitables *awaitables, int msecs);
+        ~IdleAwaiter();
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> coroutine);
+        void await_resume() const noexcept {}
+
+    private:
+        friend class IdleAwaitables;
+        Waiter m_waiter;
+    };
+
+    class ActivityAwaiter
+    {
+    public:
+        explicit ActivityAwaiter(IdleAwaitables *awaitables);
+        ~ActivityAwaiter();
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> coroutine);
+        void await_resume() const noexcept {}
+
+    private:
+        friend class IdleAwaitables;
+        Waiter m_waiter;
+    };
+
+    class FirstOfAwaiter
+    {
+    public:
+        FirstOfAwaiter(IdleAwaiter idle, ActivityAwaiter activity);
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> coroutine);
+        Event await_resume() const noexcept
+        {
+            return m_outcome;
+        }
+
+    private:
+        IdleAwaiter m_idle;
+        ActivityAwaiter m_activity;
+        Event m_outcome;
+    };
+
+    /**
+     * @param next : receives the events of the registrations made by others; may be null
+     */
+    explicit IdleAwaitables(IdleEventListener *next = nullptr);
+    ~IdleAwaitables();
+
+    /**
+     * sets the engine to await, which has to report to this object.
+     */
+    void setEngine(IdleTimeoutEngine *engine);
+    /**
+     * @param wakeUp : called when coroutines become ready to be resumed by resumeReady().
+     */
+    void setWakeUp(const std::function<void()> &wakeUp);
+
+    /**
+     * completes when the idle time reaches @p duration. A threshold the current idle
+     * period already went past before the await is reported at once, unless it was
+     * reported before, in which case the await lasts until the next idle period.
+     */
+    IdleAwaiter idleFor(std::chrono::milliseconds duration);
+    /**
+     * completes at the first user activity.
+     */
+    ActivityAwaiter nextActivity();
+    /**
+     * completes with whichever of @p idle and @p activity happens first, and cancels the other.
+     */
+    FirstOfAwaiter firstOf(IdleAwaiter idle, ActivityAwaiter activity);
+
+    /**
+     * resumes the coroutines whose event occurred.
+     * @returns the number of coroutines resumed.
+     */
+    int resumeReady();
+    /**
+     * @returns the number of suspended awaits, ready ones included.
+     */
+    int pendingCount() const;
+
+    /**
+     * catch the end of the idle period for @p next, whatever the coroutines await.
+     */
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+
+    void timeoutReached(int msecs);
+    void timeoutsReached(const int *msecs, size_t count);
+    void resumingFromIdle();
+
+private:
+    void append(List &list, Waiter *waiter);
+    void remove(Waiter *waiter);
+    void suspend(Waiter *waiter, std::coroutine_handle<> coroutine);
+    /**
+     * takes @p waiter out of its list and releases what it holds in the engine.
+     */
+    void release(Waiter *waiter);
+    /**
+     * releases @p waiter, and stops catching idle events when nobody needs them anymore.
+     */
+    void cancel(Waiter *waiter);
+    /**
+     * queues the coroutine of @p waiter for resumeReady(), and cancels its sibling.
+     */
+    void fire(Waiter *waiter, Event event);
+    void fireIdle(int msecs);
+    /**
+     * @returns the number of registrations of @p msecs made by the idle waiters.
+     */
+    int ownRegistrations(int msecs) const;
+
+    IdleEventListener *m_next;
+    IdleTimeoutEngine *m_engine;
+    std::function<void()> m_wakeUp;
+    List m_idleWaiters,
+        m_activityWaiters,
+        m_ready;
+    /**
+     * scratch storage for passing on several timeouts, kept to avoid reallocations.
+     */
+    std::vector<int> m_forwarded;
+    /**
+     * @p next asked for the end of the idle period.
+     */
+    bool m_nextCatching;
+};
+
+#endif /* IDLEAWAITABLES_H */
@@ -0,0 +1,164 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLEBACKEND_H
+#define IDLEBACKEND_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The interfaces through which the platform-independent IdleTimeoutEngine talks
+ * to the outside world. A plugin implements them on top of its native APIs (IOKit,
+ * QTimer, GCD, ...); benchmarks and simulations use the VirtualClock family instead.
+ * All times are expressed in milliseconds.
+ */
+
+/**
+ * A monotonic clock.
+ */
+class IdleClock
+{
+public:
+    virtual ~IdleClock() {}
+    /**
+     * @returns the current time in milliseconds, from an arbitrary origin.
+     */
+    virtual int64_t now() = 0;
+    /**
+     * @returns the total time the system spent suspended in milliseconds, from an arbitrary
+     * origin: the distance between a clock that keeps running during suspend (CLOCK_BOOTTIME)
+     * and now(), which does not. Clocks that cannot tell return 0.
+     */
+    virtual int64_t suspendedTime()
+    {
+        return 0;
+    }
+};
+
+/**
+ * Provides the system idle time, i.e. the time since the last user input event.
+ */
+class IdleTimeSource
+{
+public:
+    virtual ~IdleTimeSource() {}
+    /**
+     * Query the current idle time.
+     * @param idle : receives the idle time in milliseconds, only when the query succeeds
+     * @returns true in case of success
+     */
+    virtual bool queryIdleTime(int64_t &idle) = 0;
+    /**
+     * @returns true if the idle time keeps growing while the system is suspended,
+     * false (the default) if it only counts the time spent awake.
+     */
+    virtual bool countsSuspendedTime() const
+    {
+        return false;
+    }
+};
+
+/**
+ * The timer that drives the idle polling. Its owner has to call IdleTimeoutEngine::timerFired()
+ * each time it expires. Implementations may be single-shot (GCD) or repeating (QTimer): the engine
+ * re-arms the timer explicitly whenever it needs another wake-up.
+ */
+class IdleTimer
+{
+public:
+    virtual ~IdleTimer() {}
+    /**
+     * (re)arm the timer to expire after @p msecs milliseconds.
+     */
+    virtual void start(int64_t msecs) = 0;
+    /**
+     * (re)arm the timer to expire at the absolute time @p deadline on the engine's clock,
+     * which currently reads @p now. The timer may fire up to @p slack milliseconds late
+     * if that lets it share a wake-up with others. Timers that can express absolute
+     * deadlines override this; by default it is a relative start() without slack.
+     */
+    virtual void startAt(int64_t deadline, int64_t now, int64_t slack)
+    {
+        (void) slack;
+        start(deadline > now ? deadline - now : 0);
+    }
+    virtual void stop() = 0;
+    virtual bool isActive() const = 0;
+    /**
+     * @returns the interval the timer was last armed with.
+     */
+    virtual int64_t interval() const = 0;
+
+    /**
+     * @returns when a timer armed for @p deadline with @p slack should expire so that
+     * it coincides with other timers whose slack overlaps: the deadline rounded up to
+     * a multiple of the largest power of two milliseconds not exceeding the slack.
+     * The result is less than @p slack milliseconds after the deadline.
+     */
+    static int64_t coalescedDeadline(int64_t deadline, int64_t slack)
+    {
+        if (slack <= 1) {
+            return deadline;
+        }
+        int64_t granularity = 1;
+        while (granularity * 2 <= slack) {
+            granularity *= 2;
+        }
+        return (deadline + granularity - 1) / granularity * granularity;
+    }
+};
+
+/**
+ * Receives the notifications the engine generates; plugins forward them as
+ * AbstractSystemPoller signals.
+ */
+class IdleEventListener
+{
+public:
+    virtual ~IdleEventListener() {}
+    virtual void timeoutReached(int msecs) = 0;
+    /**
+     * several timeouts were found to be reached at the same time, e.g. after a suspend,
+     * a busy spell or a late wake-up; @p msecs lists them in ascending order. The default
+     * implementation reports them one by one through timeoutReached().
+     */
+    virtual void timeoutsReached(const int *msecs, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            timeoutReached(msecs[i]);
+        }
+    }
+    virtual void resumingFromIdle() = 0;
+};
+
+/**
+ * Receives the user activity detected by an ActivityFilter: the IdleTimeoutEngine itself,
+ * or something that forwards to an engine running elsewhere (ThreadedIdleDetector).
+ */
+class IdleActivitySink
+{
+public:
+    virtual ~IdleActivitySink() {}
+    /**
+     * user activity took place at @p time, in milliseconds on the engine's clock.
+     */
+    virtual void activityAt(int64_t time) = 0;
+};
+
+#endif /* IDLEBACKEND_H */
@@ -0,0 +1,441 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idledaemon.h"
+#include "idlesharedpage.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+
+/**
+ * a client that doesn't read its events is dropped rather than buffered indefinitely
+ */
+const size_t MaxBacklog = 4096;
+
+}
+
+std::string idleDaemonSocketPath()
+{
+    const char *path = getenv("KIDLETIME_DAEMON_SOCKET");
+    if (path && *path) {
+        return path;
+    }
+    const char *runtimeDir = getenv("XDG_RUNTIME_DIR");
+    if (!runtimeDir || !*runtimeDir) {
+        return std::string();
+    }
+    return std::string(runtimeDir) + "/kidletimed.socket";
+}
+
+IdleDaemon::IdleDaemon(IdleTimeSource *source, IdleClock *clock)
+    : m_clock(clock)
+    , m_engine(0)
+    , m_sharedPage(0)
+    , m_lastActivity(-1)
+    , m_epollFd(epoll_create1(EPOLL_CLOEXEC))
+    , m_listenFd(-1)
+    , m_catchingClients(0)
+    , m_quit(false)
+{
+    m_engine = new IdleDaemonEngine(source, &m_timer, this, clock);
+    m_engine->setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+    // the same leeway as a GCD timer source with interval * 10000ns
+    m_engine->setTimerSlack(1);
+    addWatch(m_timer.fd(), [this]() {
+        if (m_timer.acknowledge()) {
+            m_engine->timerFired();
+        }
+    }, 0);
+}
+
+IdleDaemon::~IdleDaemon()
+{
+    delete m_engine;
+    for (Client *client : m_clients) {
+        delete client;
+    }
+    for (Watch *watch : m_watches) {
+        if (watch->client || watch->fd == m_listenFd) {
+            close(watch->fd);
+        }
+        delete watch;
+    }
+    if (m_listenFd >= 0 && !m_socketPath.empty()) {
+        unlink(m_socketPath.c_str());
+    }
+    if (m_epollFd >= 0) {
+        close(m_epollFd);
+    }
+}
+
+bool IdleDaemon::listen(const std::string &path)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (m_listenFd >= 0 || m_epollFd < 0 || path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+
+    // the socket file may belong to a running daemon, whose clients would be orphaned:
+    // only a file that refuses connections is stale
+    const int probe = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+        return false;
+    }
+    const bool running = connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    const int error = errno;
+    close(probe);
+    if (running) {
+        return false;
+    }
+    if (error == ECONNREFUSED) {
+        unlink(path.c_str());
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, 64) < 0) {
+        close(fd);
+        return false;
+    }
+    m_listenFd = fd;
+    m_socketPath = path;
+    addWatch(fd, [this]() { acceptClients(); }, 0);
+    return true;
+}
+
+bool IdleDaemon::watch(int fd, const std::function<void()> &callback)
+{
+    return addWatch(fd, callback, 0) != 0;
+}
+
+IdleDaemon::Watch *IdleDaemon::addWatch(int fd, const std::function<void()> &callback, Client *client)
+{
+    Watch *watch = new Watch;
+    watch->fd = fd;
+    watch->callback = callback;
+    watch->client = client;
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = watch;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        delete watch;
+        return 0;
+    }
+    m_watches.push_back(watch);
+    return watch;
+}
+
+void IdleDaemon::setSharedPage(IdleSharedPage *page)
+{
+    m_sharedPage = page;
+    if (m_sharedPage && m_lastActivity >= 0) {
+        m_sharedPage->publish(m_lastActivity);
+    }
+}
+
+void IdleDaemon::publishActivity(int64_t time)
+{
+    if (time <= m_lastActivity) {
+        return;
+    }
+    m_lastActivity = time;
+    if (m_sharedPage) {
+        m_sharedPage->publish(time);
+    }
+}
+
+IdleDaemonEngine *IdleDaemon::engine()
+{
+    return m_engine;
+}
+
+const TimerFdIdleTimer &IdleDaemon::timer() const
+{
+    return m_timer;
+}
+
+int IdleDaemon::clientCount() const
+{
+    return int(m_clients.size());
+}
+
+int IdleDaemon::thresholdCount() const
+{
+    return int(m_subscribers.size());
+}
+
+void IdleDaemon::processEvents(int maxWait)
+{
+    epoll_event events[32];
+    const int count = epoll_wait(m_epollFd, events, 32, maxWait);
+    for (int i = 0; i < count; ++i) {
+        Watch *watch = static_cast<Watch*>(events[i].data.ptr);
+        if (watch->client) {
+            if (events[i].events & EPOLLOUT) {
+                flushBacklog(watch->client);
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                readClient(watch->client);
+            }
+        } else {
+            watch->callback();
+        }
+    }
+    // clients are only deleted here, so that no watch is freed while events refer to it
+    removeDeadClients();
+}
+
+void IdleDaemon::exec()
+{
+    m_quit = false;
+    while (!m_quit) {
+        processEvents();
+    }
+}
+
+void IdleDaemon::quit()
+{
+    m_quit = true;
+}
+
+void IdleDaemon::acceptClients()
+{
+    for (;;) {
+        const int fd = accept4(m_listenFd, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        Client *client = new Client;
+        client->catching = false;
+        client->dead = false;
+        client->watch = addWatch(fd, std::function<void()>(), client);
+        if (!client->watch) {
+            close(fd);
+            delete client;
+            continue;
+        }
+        m_clients.push_back(client);
+    }
+}
+
+void IdleDaemon::readClient(Client *client)
+{
+    while (!client->dead) {
+        IdleDaemonMessage message;
+        const ssize_t length = recv(client->watch->fd, &message, sizeof(message), 0);
+        if (length == sizeof(message)) {
+            handleMessage(client, message);
+        } else if (length < 0 && (errno == EAGAIN || errno == EINTR)) {
+            return;
+        } else if (length > 0) {
+            // a malformed message; skip it
+            continue;
+        } else {
+            // orderly shutdown or error
+            client->dead = true;
+        }
+    }
+}
+
+void IdleDaemon::handleMessage(Client *client, const IdleDaemonMessage &message)
+{
+    switch (message.type) {
+    case IdleDaemonMessage::AddTimeout:
+        subscribe(client, message.value);
+        break;
+    case IdleDaemonMessage::RemoveTimeout:
+        unsubscribe(client, message.value);
+        break;
+    case IdleDaemonMessage::CatchIdleEvent:
+        if (!client->catching) {
+            client->catching = true;
+            if (m_catchingClients++ == 0) {
+                m_engine->catchIdleEvent();
+            }
+        }
+        break;
+    case IdleDaemonMessage::StopCatchingIdleEvents:
+        if (client->catching) {
+            client->catching = false;
+            if (--m_catchingClients == 0) {
+                m_engine->stopCatchingIdleEvents();
+            }
+        }
+        break;
+    case IdleDaemonMessage::SimulateUserActivity:
+        m_engine->simulateUserActivity();
+        publishActivity(m_clock->now());
+        break;
+    case IdleDaemonMessage::ForcePollRequest:
+        send(client, IdleDaemonMessage::IdleTime, m_engine->forcePollRequest());
+        break;
+    default:
+        break;
+    }
+}
+
+void IdleDaemon::subscribe(Client *client, int msecs)
+{
+    std::vector<int>::iterator it = std::lower_bound(client->timeouts.begin(), client->timeouts.end(), msecs);
+    if (msecs <= 0 || (it != client->timeouts.end() && *it == msecs)) {
+        return;
+    }
+    client->timeouts.insert(it, msecs);
+    std::vector<Client*> &subscribers = m_subscribers[msecs];
+    subscribers.push_back(client);
+    if (subscribers.size() == 1) {
+        m_engine->addTimeout(msecs);
+    }
+}
+
+void IdleDaemon::unsubscribe(Client *client, int msecs)
+{
+    std::vector<int>::iterator it = std::lower_bound(client->timeouts.begin(), client->timeouts.end(), msecs);
+    if (it == client->timeouts.end() || *it != msecs) {
+        return;
+    }
+    client->timeouts.erase(it);
+    std::map<int, std::vector<Client*> >::iterator subscribers = m_subscribers.find(msecs);
+    if (subscribers == m_subscribers.end()) {
+        return;
+    }
+    std::vector<Client*> &list = subscribers->second;
+    list.erase(std::remove(list.begin(), list.end(), client), list.end());
+    if (list.empty()) {
+        m_subscribers.erase(subscribers);
+        m_engine->removeTimeout(msecs);
+    }
+}
+
+void IdleDaemon::send(Client *client, IdleDaemonMessage::Type type, int value)
+{
+    if (client->dead) {
+        return;
+    }
+    IdleDaemonMessage message;
+    message.type = type;
+    message.value = value;
+    if (client->backlog.empty()) {
+        const ssize_t length = ::send(client->watch->fd, &message, sizeof(message), MSG_NOSIGNAL);
+        if (length == sizeof(message)) {
+            return;
+        }
+        if (length >= 0 || (errno != EAGAIN && errno != EINTR)) {
+            client->dead = true;
+            return;
+        }
+        // the socket is full: wait until the client catches up
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLOUT;
+        event.data.ptr = client->watch;
+        epoll_ctl(m_epollFd, EPOLL_CTL_MOD, client->watch->fd, &event);
+    }
+    if (client->backlog.size() >= MaxBacklog) {
+        client->dead = true;
+        return;
+    }
+    client->backlog.push_back(message);
+}
+
+void IdleDaemon::flushBacklog(Client *client)
+{
+    size_t sent = 0;
+    while (sent < client->backlog.size() && !client->dead) {
+        const ssize_t length = ::send(client->watch->fd, &client->backlog[sent], sizeof(IdleDaemonMessage), MSG_NOSIGNAL);
+        if (length == sizeof(IdleDaemonMessage)) {
+            ++sent;
+        } else if (length < 0 && (errno == EAGAIN || errno == EINTR)) {
+            break;
+        } else {
+            client->dead = true;
+        }
+    }
+    client->backlog.erase(client->backlog.begin(), client->backlog.begin() + sent);
+    if (client->backlog.empty() && !client->dead) {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.ptr = client->watch;
+        epoll_ctl(m_epollFd, EPOLL_CTL_MOD, client->watch->fd, &event);
+    }
+}
+
+void IdleDaemon::removeDeadClients()
+{
+    for (size_t i = 0; i < m_clients.size();) {
+        Client *client = m_clients[i];
+        if (!client->dead) {
+            ++i;
+            continue;
+        }
+        while (!client->timeouts.empty()) {
+            unsubscribe(client, client->timeouts.back());
+        }
+        if (client->catching && --m_catchingClients == 0) {
+            m_engine->stopCatchingIdleEvents();
+        }
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, client->watch->fd, 0);
+        close(client->watch->fd);
+        m_watches.erase(std::remove(m_watches.begin(), m_watches.end(), client->watch), m_watches.end());
+        delete client->watch;
+        delete client;
+        m_clients.erase(m_clients.begin() + i);
+    }
+}
+
+void IdleDaemon::timeoutReached(int msecs)
+{
+    std::map<int, std::vector<Client*> >::const_iterator subscribers = m_subscribers.find(msecs);
+    if (subscribers == m_subscribers.end()) {
+        return;
+    }
+    for (Client *client : subscribers->second) {
+        send(client, IdleDaemonMessage::TimeoutReached, msecs);
+    }
+}
+
+void IdleDaemon::resumingFromIdle()
+{
+    // the engine stops catching after this; so do the clients, until they ask again
+    for (Client *client : m_clients) {
+        if (client->catching) {
+            client->catching = false;
+            send(client, IdleDaemonMessage::ResumingFromIdle, 0);
+        }
+    }
+    m_catchingClients = 0;
+    m_engine->stopCatchingIdleEvents();
+}
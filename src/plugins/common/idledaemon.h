@@ -0,0 +1,157 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLEDAEMON_H
+#define IDLEDAEMON_H
+
+#include "idlebackend.h"
+#include "idledaemonprotocol.h"
+#include "idletimeoutengine.h"
+#include "timerfdidletimer.h"
+
+#include <functional>
+#include <map>
+#include <vector>
+
+class IdleSharedPage;
+
+/**
+ * the daemon's engine: it holds the thresholds of all clients, an unbounded set, so it
+ * keeps them on the heap rather than in the plugins' inline storage.
+ */
+typedef BasicIdleTimeoutEngine<IdleClockPolicy<>, IdleTimerPolicy<>, HeapTimeoutStorage> IdleDaemonEngine;
+
+/**
+ * The server side of the optional daemon mode: a single process owns idle detection
+ * for the whole session, and the client processes register their timeouts over a
+ * Unix-domain socket (@see IdleDaemonMessage) instead of each running a plugin that
+ * queries the system and runs a timer of its own.
+ *
+ * All client thresholds are multiplexed on one IdleDaemonEngine: each distinct value is
+ * registered once, no matter how many clients asked for it, and the engine keeps a single
+ * deadline for the nearest one (IdleTimeoutEngine::DeadlineScheduling). That deadline is
+ * programmed as an absolute time on a timerfd in the daemon's epoll set (@see TimerFdIdleTimer),
+ * with 1% slack so that the kernel can batch the wake-ups. When a
+ * threshold is reached, the clients subscribed to it are notified; resuming from idle is
+ * pushed to the clients that asked for it with CatchIdleEvent.
+ *
+ * The idle source is passed in; its descriptor (if any) is added to the daemon's loop
+ * with watch(). SimulateUserActivity acts on the shared engine and thus on all clients,
+ * like resetting the idle time of an X server would.
+ *
+ * The daemon can also publish the time of the last activity in an IdleSharedPage, from
+ * which clients read the idle time without asking the daemon.
+ */
+class IdleDaemon : public IdleEventListener
+{
+public:
+    /**
+     * @param clock : must be a MonotonicClock, the clock of the timerfd
+     */
+    IdleDaemon(IdleTimeSource *source, IdleClock *clock);
+    ~IdleDaemon();
+
+    /**
+     * binds the listening socket at @p path. A socket file nobody listens on any more is
+     * replaced; @returns false if another daemon still accepts connections there.
+     */
+    bool listen(const std::string &path);
+    /**
+     * calls @p callback whenever @p fd becomes readable.
+     */
+    bool watch(int fd, const std::function<void()> &callback);
+
+    /**
+     * publishes the last activity in @p page (not owned) from now on.
+     */
+    void setSharedPage(IdleSharedPage *page);
+    /**
+     * to be called by the owner of the idle source when it saw activity at @p time.
+     */
+    void publishActivity(int64_t time);
+
+    IdleDaemonEngine *engine();
+    /**
+     * @returns the engine's timer, e.g. for its lateness statistics.
+     */
+    const TimerFdIdleTimer &timer() const;
+    int clientCount() const;
+    /**
+     * @returns the number of distinct thresholds registered by the clients.
+     */
+    int thresholdCount() const;
+
+    /**
+     * waits for and handles one batch of events.
+     * @param maxWait : an upper bound on the wait in milliseconds (-1 = none)
+     */
+    void processEvents(int maxWait = -1);
+    /**
+     * runs processEvents() until quit() is called.
+     */
+    void exec();
+    void quit();
+
+    // IdleEventListener: fan the engine's events out to the clients
+    void timeoutReached(int msecs);
+    void resumingFromIdle();
+
+private:
+    struct Watch;
+    struct Client {
+        Watch *watch;
+        std::vector<int> timeouts;
+        std::vector<IdleDaemonMessage> backlog;
+        bool catching;
+        bool dead;
+    };
+    struct Watch {
+        int fd;
+        std::function<void()> callback;
+        Client *client;
+    };
+
+    Watch *addWatch(int fd, const std::function<void()> &callback, Client *client);
+    void acceptClients();
+    void readClient(Client *client);
+    void handleMessage(Client *client, const IdleDaemonMessage &message);
+    void subscribe(Client *client, int msecs);
+    void unsubscribe(Client *client, int msecs);
+    void send(Client *client, IdleDaemonMessage::Type type, int value);
+    void flushBacklog(Client *client);
+    void removeDeadClients();
+
+    IdleClock *m_clock;
+    IdleDaemonEngine *m_engine;
+    IdleSharedPage *m_sharedPage;
+    int64_t m_lastActivity;
+    int m_epollFd;
+    int m_listenFd;
+    std::string m_socketPath;
+    std::vector<Watch*> m_watches;
+    std::vector<Client*> m_clients;
+    /**
+     * threshold -> the clients waiting for it
+     */
+    std::map<int, std::vector<Client*> > m_subscribers;
+    int m_catchingClients;
+    TimerFdIdleTimer m_timer;
+    bool m_quit;
+};
+
+#endif /* IDLEDAEMON_H */
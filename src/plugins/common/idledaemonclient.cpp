@@ -0,0 +1,230 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idledaemonclient.h"
+#include "idlesharedpage.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+IdleDaemonClient::IdleDaemonClient(IdleEventListener *listener)
+    : m_listener(listener)
+    , m_fd(-1)
+    , m_sharedPage(0)
+    , m_idleReply(-1)
+    , m_catching(false)
+{
+}
+
+IdleDaemonClient::~IdleDaemonClient()
+{
+    disconnectFromDaemon();
+}
+
+bool IdleDaemonClient::connectToDaemon(const std::string &path)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+
+    disconnectFromDaemon();
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    // connect while blocking, so that a daemon with a full backlog isn't mistaken for a missing one
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(fd);
+        return false;
+    }
+    m_fd = fd;
+    m_sharedPage = IdleSharedPage::open();
+    for (int msecs : m_timeouts) {
+        send(IdleDaemonMessage::AddTimeout, msecs);
+    }
+    if (m_catching) {
+        send(IdleDaemonMessage::CatchIdleEvent);
+    }
+    return isConnected();
+}
+
+void IdleDaemonClient::disconnectFromDaemon()
+{
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    delete m_sharedPage;
+    m_sharedPage = 0;
+}
+
+bool IdleDaemonClient::isConnected() const
+{
+    return m_fd >= 0;
+}
+
+int IdleDaemonClient::fd() const
+{
+    return m_fd;
+}
+
+void IdleDaemonClient::addTimeout(int msecs)
+{
+    std::vector<int>::iterator it = std::lower_bound(m_timeouts.begin(), m_timeouts.end(), msecs);
+    if (msecs <= 0 || (it != m_timeouts.end() && *it == msecs)) {
+        return;
+    }
+    m_timeouts.insert(it, msecs);
+    send(IdleDaemonMessage::AddTimeout, msecs);
+}
+
+void IdleDaemonClient::removeTimeout(int msecs)
+{
+    std::vector<int>::iterator it = std::lower_bound(m_timeouts.begin(), m_timeouts.end(), msecs);
+    if (it == m_timeouts.end() || *it != msecs) {
+        return;
+    }
+    m_timeouts.erase(it);
+    send(IdleDaemonMessage::RemoveTimeout, msecs);
+}
+
+const std::vector<int> &IdleDaemonClient::timeouts() const
+{
+    return m_timeouts;
+}
+
+void IdleDaemonClient::catchIdleEvent()
+{
+    m_catching = true;
+    send(IdleDaemonMessage::CatchIdleEvent);
+}
+
+void IdleDaemonClient::stopCatchingIdleEvents()
+{
+    m_catching = false;
+    send(IdleDaemonMessage::StopCatchingIdleEvents);
+}
+
+void IdleDaemonClient::simulateUserActivity()
+{
+    send(IdleDaemonMessage::SimulateUserActivity);
+}
+
+int IdleDaemonClient::forcePollRequest(int timeout)
+{
+    if (m_sharedPage && isConnected()) {
+        const int64_t idle = m_sharedPage->idleTime();
+        if (idle >= 0) {
+            return int(idle);
+        }
+    }
+    m_idleReply = -1;
+    if (!send(IdleDaemonMessage::ForcePollRequest)) {
+        return -1;
+    }
+    pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    while (m_idleReply < 0 && isConnected()) {
+        pfd.revents = 0;
+        if (poll(&pfd, 1, timeout) <= 0) {
+            break;
+        }
+        dispatch();
+    }
+    return m_idleReply;
+}
+
+int IdleDaemonClient::idleTime()
+{
+    if (!isConnected()) {
+        return -1;
+    }
+    if (!m_sharedPage) {
+        // the daemon creates the page after it starts listening
+        m_sharedPage = IdleSharedPage::open();
+        if (!m_sharedPage) {
+            return -1;
+        }
+    }
+    const int64_t idle = m_sharedPage->idleTime();
+    return idle >= 0 ? int(idle) : -1;
+}
+
+int IdleDaemonClient::dispatch()
+{
+    int count = 0;
+    while (isConnected()) {
+        IdleDaemonMessage message;
+        const ssize_t length = recv(m_fd, &message, sizeof(message), MSG_DONTWAIT);
+        if (length == sizeof(message)) {
+            ++count;
+            deliver(message);
+        } else if (length < 0 && (errno == EAGAIN || errno == EINTR)) {
+            break;
+        } else if (length <= 0) {
+            disconnectFromDaemon();
+        }
+    }
+    return count;
+}
+
+bool IdleDaemonClient::send(IdleDaemonMessage::Type type, int value)
+{
+    if (!isConnected()) {
+        return false;
+    }
+    IdleDaemonMessage message;
+    message.type = type;
+    message.value = value;
+    // requests are rare and tiny: a blocking send is fine
+    if (::send(m_fd, &message, sizeof(message), MSG_NOSIGNAL) != sizeof(message)) {
+        disconnectFromDaemon();
+        return false;
+    }
+    return true;
+}
+
+void IdleDaemonClient::deliver(const IdleDaemonMessage &message)
+{
+    switch (message.type) {
+    case IdleDaemonMessage::TimeoutReached:
+        m_listener->timeoutReached(message.value);
+        break;
+    case IdleDaemonMessage::ResumingFromIdle:
+        // the daemon stopped catching for this client
+        m_catching = false;
+        m_listener->resumingFromIdle();
+        break;
+    case IdleDaemonMessage::IdleTime:
+        m_idleReply = message.value;
+        break;
+    default:
+        break;
+    }
+}
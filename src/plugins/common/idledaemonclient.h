@@ -0,0 +1,99 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLEDAEMONCLIENT_H
+#define IDLEDAEMONCLIENT_H
+
+#include "idlebackend.h"
+#include "idledaemonprotocol.h"
+
+#include <vector>
+
+class IdleSharedPage;
+
+/**
+ * The client side of the daemon mode (@see IdleDaemon): forwards the timeout registrations
+ * to the daemon and turns the messages it pushes back into IdleEventListener calls.
+ *
+ * The socket is non-blocking; its descriptor (fd()) becomes readable when the daemon has
+ * sent something, at which point the owner calls dispatch(). forcePollRequest() is the only
+ * call that waits for a reply, and only when the daemon's shared page (@see IdleSharedPage)
+ * can't be mapped; events arriving in the meantime are delivered as usual. idleTime() never
+ * waits.
+ *
+ * The registrations and the catching of the idle period are kept while disconnected, and
+ * sent again by the next connectToDaemon(), so that the owner can reconnect after the
+ * daemon went away.
+ */
+class IdleDaemonClient
+{
+public:
+    explicit IdleDaemonClient(IdleEventListener *listener);
+    ~IdleDaemonClient();
+
+    /**
+     * connects to the daemon listening at @p path, registers the timeouts already added and
+     * asks it to catch the end of the idle period if that was asked for before.
+     */
+    bool connectToDaemon(const std::string &path = idleDaemonSocketPath());
+    void disconnectFromDaemon();
+    bool isConnected() const;
+    int fd() const;
+
+    void addTimeout(int msecs);
+    void removeTimeout(int msecs);
+    /**
+     * @returns the registered timeouts, in ascending order.
+     */
+    const std::vector<int> &timeouts() const;
+
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+    void simulateUserActivity();
+    /**
+     * reads the current idle time from the shared page, or asks the daemon for it.
+     * @param timeout : how long to wait for the answer, in milliseconds
+     * @returns the idle time, or -1 if the daemon didn't answer.
+     */
+    int forcePollRequest(int timeout = 1000);
+    /**
+     * @returns the idle time read from the daemon's shared page, or -1 if the page cannot
+     * be read (not connected, no page, or the daemon is not publishing).
+     */
+    int idleTime();
+
+    /**
+     * delivers the messages received from the daemon.
+     * @returns the number of messages read; if the daemon went away, the client is
+     * disconnected.
+     */
+    int dispatch();
+
+private:
+    bool send(IdleDaemonMessage::Type type, int value = 0);
+    void deliver(const IdleDaemonMessage &message);
+
+    IdleEventListener *m_listener;
+    int m_fd;
+    IdleSharedPage *m_sharedPage;
+    std::vector<int> m_timeouts;
+    int m_idleReply;
+    bool m_catching;
+};
+
+#endif /* IDLEDAEMONCLIENT_H */
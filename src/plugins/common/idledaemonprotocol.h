@@ -0,0 +1,66 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLEDAEMONPROTOCOL_H
+#define IDLEDAEMONPROTOCOL_H
+
+#include <stdint.h>
+
+#include <string>
+
+/**
+ * The messages exchanged between the idle daemon (IdleDaemon) and its clients
+ * (IdleDaemonClient) over a SOCK_SEQPACKET Unix-domain socket. Every datagram holds
+ * exactly one message, so there is no framing to deal with.
+ */
+struct IdleDaemonMessage
+{
+    enum Type {
+        // client -> daemon
+        AddTimeout = 1,
+        RemoveTimeout,
+        CatchIdleEvent,
+        StopCatchingIdleEvents,
+        SimulateUserActivity,
+        ForcePollRequest,
+        // daemon -> client
+        TimeoutReached = 64,
+        ResumingFromIdle,
+        /**
+         * the reply to ForcePollRequest; value holds the idle time
+         */
+        IdleTime
+    };
+
+    uint32_t type;
+    /**
+     * the timeout or idle time in milliseconds, where applicable
+     */
+    int32_t value;
+};
+
+/**
+ * @returns the path of the daemon's socket: $KIDLETIME_DAEMON_SOCKET if set, otherwise
+ * kidletimed.socket in $XDG_RUNTIME_DIR, or an empty string when neither is set. There is
+ * no fallback in a shared directory such as /tmp, where another user could create the
+ * socket first and impersonate the daemon, and where the daemons of different users
+ * would collide.
+ */
+std::string idleDaemonSocketPath();
+
+#endif /* IDLEDAEMONPROTOCOL_H */
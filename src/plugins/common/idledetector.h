@@ -0,0 +1,110 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLEDETECTOR_H
+#define IDLEDETECTOR_H
+
+#include "idlebackend.h"
+#include "idletimeoutengine.h"
+#include "idletimeoutlist.h"
+
+#include <functional>
+#include <vector>
+
+class IdleStatistics;
+
+/**
+ * What a poller needs from the machinery that runs its IdleTimeoutEngine, whatever wakes the
+ * engine up (@see IdleTimerStrategy): LocalIdleDetector runs the engine on the owner's thread
+ * with an IdleTimer of the owner's choosing, ThreadedIdleDetector on a thread of its own.
+ *
+ * All methods are called from the owner's thread. The listener is called on that thread
+ * too, either synchronously or from deliverEvents().
+ */
+class IdleDetector : public IdleActivitySink
+{
+public:
+    virtual ~IdleDetector() {}
+
+    /**
+     * @param wakeUp : called, possibly from another thread, when events are waiting for
+     * deliverEvents(). Detectors that report their events synchronously never call it.
+     */
+    virtual void setWakeUp(const std::function<void()> &wakeUp) = 0;
+    /**
+     * starts the detection. While stopped, the registrations are kept and the calls take
+     * effect, but nothing wakes the engine up.
+     */
+    virtual void start() = 0;
+    virtual void stop() = 0;
+    virtual bool isRunning() const = 0;
+
+    virtual void addTimeout(int msecs) = 0;
+    virtual void removeTimeout(int msecs) = 0;
+    /**
+     * @returns the registered timeouts, in ascending order, as the owner requested them,
+     * until they change.
+     */
+    virtual IdleTimeoutList timeouts() const = 0;
+    virtual void catchIdleEvent() = 0;
+    virtual void stopCatchingIdleEvents() = 0;
+    virtual void simulateUserActivity() = 0;
+
+    /**
+     * polls at a fixed interval of @p msecs, or (-1) returns to the detector's own
+     * scheduling mode. @see IdleTimeoutEngine::setPollResolution()
+     */
+    virtual void setPollResolution(int msecs) = 0;
+    /**
+     * @see IdleTimeoutEngine::setLatenessBudget()
+     */
+    virtual void setLatenessBudget(int msecs) = 0;
+    virtual void setLatenessBudget(int timeout, int msecs) = 0;
+    /**
+     * @see IdleTimeoutEngine::setSuspendPolicy()
+     */
+    virtual void setSuspendPolicy(IdleTimeoutEngine::SuspendPolicy policy) = 0;
+    /**
+     * @see IdleTimeoutEngine::systemResumed()
+     */
+    virtual void systemResumed() = 0;
+    /**
+     * @see IdleTimeoutEngine::setActivityEventsAvailable()
+     */
+    virtual void setActivityEventsAvailable(bool available) = 0;
+    /**
+     * @see IdleTimeoutEngine::setResumeLatency()
+     */
+    virtual void setResumeLatency(int msecs) = 0;
+
+    /**
+     * polls the idle time now.
+     */
+    virtual int forcePollRequest() = 0;
+    /**
+     * calls the listener for the events reported since the last call.
+     * @returns the number of events delivered.
+     */
+    virtual int deliverEvents() = 0;
+    /**
+     * @returns the statistics of the engine; they can be read and reset from any thread.
+     */
+    virtual IdleStatistics &statistics() = 0;
+};
+
+#endif /* IDLEDETECTOR_H */
@@ -0,0 +1,129 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLEENGINEPOLICIES_H
+#define IDLEENGINEPOLICIES_H
+
+#include "idlebackend.h"
+#include "inlinearray.h"
+
+#include <vector>
+
+/**
+ * The policies a BasicIdleTimeoutEngine is parameterised on.
+ *
+ * The clock and timer policies hold a pointer to the object they call. With their default
+ * arguments they call the IdleClock and IdleTimer interfaces, whose implementations the
+ * plugins choose at runtime. A build with a fixed platform can instead name its concrete
+ * classes, which then need not derive from the interfaces: when their methods are not
+ * virtual (or are final), the engine's calls are resolved at compile time and can be inlined.
+ */
+
+/**
+ * @tparam Clock : provides int64_t now() and int64_t suspendedTime(), like IdleClock.
+ */
+template<typename Clock = IdleClock>
+class IdleClockPolicy
+{
+public:
+    typedef Clock ClockType;
+
+    explicit IdleClockPolicy(Clock *clock)
+        : m_clock(clock)
+    {
+    }
+
+    /**
+     * @returns false if the engine was given no clock.
+     */
+    bool isValid() const
+    {
+        return m_clock != 0;
+    }
+    int64_t now() const
+    {
+        return m_clock->now();
+    }
+    int64_t suspendedTime() const
+    {
+        return m_clock->suspendedTime();
+    }
+
+private:
+    Clock *m_clock;
+};
+
+/**
+ * @tparam Timer : provides the methods of IdleTimer, startAt() included.
+ */
+template<typename Timer = IdleTimer>
+class IdleTimerPolicy
+{
+public:
+    typedef Timer TimerType;
+
+    explicit IdleTimerPolicy(Timer *timer)
+        : m_timer(timer)
+    {
+    }
+
+    void start(int64_t msecs)
+    {
+        m_timer->start(msecs);
+    }
+    void startAt(int64_t deadline, int64_t now, int64_t slack)
+    {
+        m_timer->startAt(deadline, now, slack);
+    }
+    void stop()
+    {
+        m_timer->stop();
+    }
+    bool isActive() const
+    {
+        return m_timer->isActive();
+    }
+    int64_t interval() const
+    {
+        return m_timer->interval();
+    }
+
+private:
+    Timer *m_timer;
+};
+
+/**
+ * keeps the timeouts, the registrations and the scratch lists of the engine in InlineArrays
+ * of @p N elements: up to @p N timeouts the engine does not allocate. Larger sets are
+ * still supported, on the heap.
+ */
+template<size_t N>
+struct InlineTimeoutStorage {
+    template<typename T>
+    using Array = InlineArray<T, N>;
+};
+
+/**
+ * keeps everything in std::vectors, as suits large sets (e.g. the daemon's).
+ */
+struct HeapTimeoutStorage {
+    template<typename T>
+    using Array = std::vector<T>;
+};
+
+#endif /* IDLEENGINEPOLICIES_H */
@@ -0,0 +1,96 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idlenotificationtracker.h"
+
+#include <algorithm>
+
+IdleNotificationTracker::IdleNotificationTracker(IdleEventListener *listener, IdleClock *clock)
+    : m_listener(listener)
+    , m_clock(clock)
+    , m_activityAt(clock->now())
+{
+}
+
+void IdleNotificationTracker::addTimeout(int msecs)
+{
+    std::vector<Threshold>::iterator it = m_thresholds.begin();
+    while (it != m_thresholds.end() && it->msecs < msecs) {
+        ++it;
+    }
+    if (it == m_thresholds.end() || it->msecs != msecs) {
+        const Threshold threshold = { msecs, false };
+        m_thresholds.insert(it, threshold);
+    }
+}
+
+void IdleNotificationTracker::removeTimeout(int msecs)
+{
+    for (std::vector<Threshold>::iterator it = m_thresholds.begin(); it != m_thresholds.end(); ++it) {
+        if (it->msecs == msecs) {
+            m_thresholds.erase(it);
+            return;
+        }
+    }
+}
+
+void IdleNotificationTracker::idled(int msecs)
+{
+    for (Threshold &threshold : m_thresholds) {
+        if (threshold.msecs == msecs) {
+            threshold.idle = true;
+        }
+    }
+    // the compositor counted @p msecs since the last activity it saw
+    m_activityAt = m_clock->now() - msecs;
+    m_listener->timeoutReached(msecs);
+}
+
+void IdleNotificationTracker::resumed(int msecs)
+{
+    for (Threshold &threshold : m_thresholds) {
+        if (threshold.msecs == msecs) {
+            threshold.idle = false;
+        }
+    }
+    activityAt(m_clock->now());
+}
+
+void IdleNotificationTracker::caughtActivity()
+{
+    activityAt(m_clock->now());
+    m_listener->resumingFromIdle();
+}
+
+void IdleNotificationTracker::activityAt(int64_t time)
+{
+    m_activityAt = std::max(m_activityAt, time);
+}
+
+int IdleNotificationTracker::idleTime() const
+{
+    int64_t idle = std::max(m_clock->now() - m_activityAt, int64_t(0));
+    for (const Threshold &threshold : m_thresholds) {
+        if (!threshold.idle) {
+            // activity after the last event would not have been reported
+            idle = std::min(idle, int64_t(threshold.msecs));
+            break;
+        }
+    }
+    return int(idle);
+}
@@ -0,0 +1,89 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLENOTIFICATIONTRACKER_H
+#define IDLENOTIFICATIONTRACKER_H
+
+#include "idlebackend.h"
+
+#include <vector>
+
+/**
+ * The client side of idle timeouts that are pushed per timeout rather than sampled, as
+ * ext-idle-notify-v1 does (@see WaylandIdleNotifications): it turns the "idled" and
+ * "resumed" events of the notifications into the listener's calls, and keeps track of
+ * them to estimate the idle time, which such protocols cannot be asked for.
+ *
+ * It knows nothing about the protocol objects, so it can be driven by a mock notifier.
+ */
+class IdleNotificationTracker
+{
+public:
+    IdleNotificationTracker(IdleEventListener *listener, IdleClock *clock);
+
+    /**
+     * a notification for @p msecs was created; it starts out active.
+     */
+    void addTimeout(int msecs);
+    void removeTimeout(int msecs);
+
+    /**
+     * the notification for @p msecs went idle: the seat has been idle for @p msecs.
+     * Reported to the listener as timeoutReached().
+     */
+    void idled(int msecs);
+    /**
+     * the notification for @p msecs saw user activity.
+     */
+    void resumed(int msecs);
+    /**
+     * the zero-timeout notification of catchIdleEvent() saw user activity. Reported to the
+     * listener as resumingFromIdle().
+     */
+    void caughtActivity();
+
+    /**
+     * @returns an estimate of the idle time in milliseconds: the time since the last
+     * activity reported, or since the start of the idle period that the last "idled"
+     * implies, or since the tracker was made before any event. Activity is only reported
+     * by notifications that were idle, so the estimate does not exceed the smallest
+     * timeout whose notification is not.
+     */
+    int idleTime() const;
+
+private:
+    struct Threshold {
+        int msecs;
+        bool idle;
+    };
+
+    void activityAt(int64_t time);
+
+    IdleEventListener *m_listener;
+    IdleClock *m_clock;
+    /**
+     * sorted by value.
+     */
+    std::vector<Threshold> m_thresholds;
+    /**
+     * the estimated time of the last user activity.
+     */
+    int64_t m_activityAt;
+};
+
+#endif /* IDLENOTIFICATIONTRACKER_H */
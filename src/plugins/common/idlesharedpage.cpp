@@ -0,0 +1,176 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idlesharedpage.h"
+#include "monotonicclock.h"
+
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct IdleSharedPage::Layout
+{
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> state;
+    std::atomic<int64_t> lastActivity;
+};
+
+namespace
+{
+
+const uint32_t PageMagic = 0x4b49444c; // "KIDL"
+const uint32_t PageVersion = 1;
+// a writer updates the page with three stores; one that is still mid-update after this
+// many attempts (and as many yields) has died or is stopped in a debugger
+const int MaxReadAttempts = 100;
+
+}
+
+IdleSharedPage::IdleSharedPage(Layout *layout, bool writer, const std::string &name)
+    : m_layout(layout)
+    , m_writer(writer)
+    , m_name(name)
+    , m_readRetries(0)
+{
+}
+
+IdleSharedPage::~IdleSharedPage()
+{
+    if (m_writer) {
+        // readers that still have the page mapped see that it's stale
+        publish(m_layout->lastActivity.load(std::memory_order_relaxed), Stopped);
+        shm_unlink(m_name.c_str());
+    }
+    munmap(m_layout, sizeof(Layout));
+}
+
+std::string IdleSharedPage::defaultName()
+{
+    return "/kidletime-" + std::to_string(getuid());
+}
+
+IdleSharedPage *IdleSharedPage::create(const std::string &name)
+{
+    // owner-only access; other users have no business reading our idle time
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return 0;
+    }
+    if (ftruncate(fd, sizeof(Layout)) < 0) {
+        close(fd);
+        return 0;
+    }
+    void *address = mmap(0, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        return 0;
+    }
+    Layout *layout = new (address) Layout;
+    layout->sequence.store(0, std::memory_order_relaxed);
+    layout->state.store(Stopped, std::memory_order_relaxed);
+    layout->lastActivity.store(0, std::memory_order_relaxed);
+    layout->version = PageVersion;
+    std::atomic_thread_fence(std::memory_order_release);
+    layout->magic = PageMagic;
+    return new IdleSharedPage(layout, true, name);
+}
+
+IdleSharedPage *IdleSharedPage::open(const std::string &name)
+{
+    const int fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) < 0 || info.st_size < off_t(sizeof(Layout))) {
+        close(fd);
+        return 0;
+    }
+    void *address = mmap(0, sizeof(Layout), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        return 0;
+    }
+    Layout *layout = static_cast<Layout*>(address);
+    if (layout->magic != PageMagic || layout->version != PageVersion) {
+        munmap(address, sizeof(Layout));
+        return 0;
+    }
+    return new IdleSharedPage(layout, false, name);
+}
+
+void IdleSharedPage::publish(int64_t lastActivity, State state)
+{
+    if (!m_writer) {
+        return;
+    }
+    const uint32_t sequence = m_layout->sequence.load(std::memory_order_relaxed);
+    m_layout->sequence.store(sequence + 1, std::memory_order_relaxed);
+    // the odd sequence number must be visible before any of the new values
+    std::atomic_thread_fence(std::memory_order_release);
+    m_layout->lastActivity.store(lastActivity, std::memory_order_relaxed);
+    m_layout->state.store(state, std::memory_order_relaxed);
+    m_layout->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+IdleSharedPage::Snapshot IdleSharedPage::read() const
+{
+    Snapshot snapshot;
+    for (int attempt = 0; attempt < MaxReadAttempts; ++attempt) {
+        const uint32_t before = m_layout->sequence.load(std::memory_order_acquire);
+        if (!(before & 1)) {
+            snapshot.lastActivity = m_layout->lastActivity.load(std::memory_order_relaxed);
+            snapshot.state = State(m_layout->state.load(std::memory_order_relaxed));
+            // the values must be read before the sequence number is checked again
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_layout->sequence.load(std::memory_order_relaxed) == before) {
+                return snapshot;
+            }
+        } else {
+            // the writer is mid-update; let it run if it shares our CPU
+            std::this_thread::yield();
+        }
+        m_readRetries.fetch_add(1, std::memory_order_relaxed);
+    }
+    snapshot.lastActivity = 0;
+    snapshot.state = Stopped;
+    return snapshot;
+}
+
+int64_t IdleSharedPage::idleTime() const
+{
+    const Snapshot snapshot = read();
+    if (snapshot.state != Running) {
+        return -1;
+    }
+    MonotonicClock clock;
+    const int64_t idle = clock.now() - snapshot.lastActivity;
+    return idle > 0 ? idle : 0;
+}
+
+int64_t IdleSharedPage::readRetries() const
+{
+    return m_readRetries.load(std::memory_order_relaxed);
+}
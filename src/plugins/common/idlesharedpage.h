@@ -0,0 +1,108 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLESHAREDPAGE_H
+#define IDLESHAREDPAGE_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+/**
+ * A small POSIX shared-memory page in which the detection side (the idle daemon)
+ * publishes the time of the last user activity. Any process can map it read-only and
+ * compute the idle time with a few atomic loads and a clock read: no system call (the
+ * monotonic clock is read through the vDSO) and no round-trip to the daemon.
+ *
+ * The page is guarded by a seqlock: the writer makes the sequence number odd while it
+ * updates the fields, and even again afterwards. A reader retries when it sees an odd
+ * number or when the number changed during its read, a bounded number of times: a
+ * writer that died mid-update leaves the number odd for good. There is a single writer;
+ * readers never write to the page and cannot slow the writer down.
+ *
+ * The timestamps are in milliseconds on CLOCK_MONOTONIC (@see MonotonicClock), which is
+ * the same in all processes.
+ */
+class IdleSharedPage
+{
+public:
+    enum State {
+        /**
+         * nobody is publishing: the contents are stale
+         */
+        Stopped = 0,
+        Running = 1
+    };
+
+    struct Snapshot {
+        int64_t lastActivity;
+        State state;
+    };
+
+    ~IdleSharedPage();
+
+    /**
+     * creates (or takes over) the page @p name for writing; the page is marked Stopped
+     * when the writer goes away.
+     * @returns 0 on failure.
+     */
+    static IdleSharedPage *create(const std::string &name = defaultName());
+    /**
+     * maps an existing page read-only.
+     * @returns 0 if there is no such page, or if it has an incompatible layout.
+     */
+    static IdleSharedPage *open(const std::string &name = defaultName());
+    /**
+     * @returns "/kidletime-<uid>".
+     */
+    static std::string defaultName();
+
+    /**
+     * writer side: publishes a new last-activity time.
+     */
+    void publish(int64_t lastActivity, State state = Running);
+
+    /**
+     * reader side: takes a consistent copy of the published values.
+     * @returns a Stopped snapshot if no consistent copy could be taken after a bounded
+     * number of attempts, as when the writer died in the middle of an update.
+     */
+    Snapshot read() const;
+    /**
+     * @returns the idle time in milliseconds, or -1 if nobody is publishing or the page
+     * cannot be read (@see read()).
+     */
+    int64_t idleTime() const;
+    /**
+     * @returns how often read() had to start over because of a concurrent update.
+     */
+    int64_t readRetries() const;
+
+private:
+    struct Layout;
+
+    IdleSharedPage(Layout *layout, bool writer, const std::string &name);
+
+    Layout *m_layout;
+    bool m_writer;
+    std::string m_name;
+    mutable std::atomic<int64_t> m_readRetries;
+};
+
+#endif /* IDLESHAREDPAGE_H */
@@ -0,0 +1,109 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idlestatistics.h"
+
+IdleStatistics::IdleStatistics()
+{
+    for (int i = 0; i < CounterCount; ++i) {
+        m_counters[i].store(0, std::memory_order_relaxed);
+        m_counterBase[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < LatenessBuckets; ++i) {
+        m_lateness[i].store(0, std::memory_order_relaxed);
+        m_latenessBase[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+IdleStatistics::Snapshot IdleStatistics::snapshot() const
+{
+    Snapshot snapshot;
+    for (int i = 0; i < CounterCount; ++i) {
+        snapshot.counters[i] = m_counters[i].load(std::memory_order_relaxed)
+                               - m_counterBase[i].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < LatenessBuckets; ++i) {
+        snapshot.lateness[i] = m_lateness[i].load(std::memory_order_relaxed)
+                               - m_latenessBase[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+int64_t IdleStatistics::counter(Counter counter) const
+{
+    return m_counters[counter].load(std::memory_order_relaxed)
+           - m_counterBase[counter].load(std::memory_order_relaxed);
+}
+
+void IdleStatistics::reset()
+{
+    for (int i = 0; i < CounterCount; ++i) {
+        m_counterBase[i].store(m_counters[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    for (int i = 0; i < LatenessBuckets; ++i) {
+        m_latenessBase[i].store(m_lateness[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+int64_t IdleStatistics::bucketLowerBound(int bucket)
+{
+    return bucket > 0 ? int64_t(1) << (bucket - 1) : 0;
+}
+
+const char *IdleStatistics::counterName(Counter counter)
+{
+    switch (counter) {
+    case TimerWakeups:
+        return "timer wake-ups";
+    case IdleQueries:
+        return "idle time queries";
+    case NativeEvents:
+        return "native events";
+    case EventsActedOn:
+        return "events acted on";
+    case TimeoutsEmitted:
+        return "timeouts emitted";
+    case MissedActivity:
+        return "missed activity";
+    case Suspends:
+        return "suspends";
+    case CounterCount:
+        break;
+    }
+    return "";
+}
+
+int64_t IdleStatistics::Snapshot::latenessPercentile(double fraction) const
+{
+    int64_t total = 0;
+    for (int i = 0; i < LatenessBuckets; ++i) {
+        total += lateness[i];
+    }
+    if (!total) {
+        return 0;
+    }
+    const int64_t rank = int64_t(fraction * (total - 1));
+    int64_t seen = 0;
+    for (int i = 0; i < LatenessBuckets; ++i) {
+        seen += lateness[i];
+        if (seen > rank) {
+            return i < LatenessBuckets - 1 ? bucketLowerBound(i + 1) : bucketLowerBound(i);
+        }
+    }
+    return bucketLowerBound(LatenessBuckets - 1);
+}
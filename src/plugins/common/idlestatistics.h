@@ -0,0 +1,152 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLESTATISTICS_H
+#define IDLESTATISTICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * Runtime counters of an idle detector, and a histogram of how late the timeouts were
+ * detected.
+ *
+ * Each counter has a single writer: the thread the engine (or the event filter) runs on.
+ * That thread increments with a relaxed load and store, which costs about as much as a
+ * plain increment and never contends with the readers. Any thread can take a snapshot()
+ * at any time; the counters are read individually, so a snapshot is not an atomic view
+ * of all of them. reset() does not touch the counters either: it records their current
+ * values as the baseline that snapshot() subtracts.
+ */
+class IdleStatistics
+{
+public:
+    enum Counter {
+        /**
+         * the IdleTimer expired
+         */
+        TimerWakeups,
+        /**
+         * the system was queried for the idle time
+         */
+        IdleQueries,
+        /**
+         * native events seen by the event filter
+         */
+        NativeEvents,
+        /**
+         * native events that were forwarded to the engine
+         */
+        EventsActedOn,
+        /**
+         * timeoutReached() notifications
+         */
+        TimeoutsEmitted,
+        /**
+         * the idle time dropped without the engine having been told about user activity
+         */
+        MissedActivity,
+        /**
+         * system suspends noticed by the engine (with a suspend policy set)
+         */
+        Suspends,
+        CounterCount
+    };
+
+    /**
+     * bucket 0 counts the timeouts detected in time (< 1ms late), bucket i > 0 those
+     * detected [2^(i-1), 2^i) milliseconds late; the last bucket has no upper bound.
+     */
+    static const int LatenessBuckets = 24;
+
+    struct Snapshot {
+        int64_t counters[CounterCount];
+        int64_t lateness[LatenessBuckets];
+
+        int64_t counter(Counter counter) const
+        {
+            return counters[counter];
+        }
+        /**
+         * @returns the upper bound in milliseconds of the bucket holding the given
+         * fraction (0..1) of the detections, or 0 if there were none.
+         */
+        int64_t latenessPercentile(double fraction) const;
+    };
+
+    IdleStatistics();
+
+    void increment(Counter counter)
+    {
+        std::atomic<int64_t> &value = m_counters[counter];
+        value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    /**
+     * records a timeout that was detected @p msecs after it was reached.
+     */
+    void recordLateness(int64_t msecs)
+    {
+        std::atomic<int64_t> &value = m_lateness[latenessBucket(msecs)];
+        value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @returns the counts since construction or the last reset().
+     */
+    Snapshot snapshot() const;
+    int64_t counter(Counter counter) const;
+    void reset();
+
+    /**
+     * @returns the bucket of a lateness of @p msecs: the number of its significant bits,
+     * found in halving steps since it is counted for every timeout reported.
+     */
+    static int latenessBucket(int64_t msecs)
+    {
+        uint64_t value = msecs > 0 ? uint64_t(msecs) : 0;
+        int bucket = 0;
+        for (int shift = 32; shift > 0; shift /= 2) {
+            if (value >> shift) {
+                value >>= shift;
+                bucket += shift;
+            }
+        }
+        bucket += int(value);
+        return std::min(bucket, LatenessBuckets - 1);
+    }
+    /**
+     * @returns the smallest lateness counted in @p bucket.
+     */
+    static int64_t bucketLowerBound(int bucket);
+    static const char *counterName(Counter counter);
+
+private:
+    IdleStatistics(const IdleStatistics &) = delete;
+    IdleStatistics &operator=(const IdleStatistics &) = delete;
+
+    std::atomic<int64_t> m_counters[CounterCount];
+    std::atomic<int64_t> m_lateness[LatenessBuckets];
+    /**
+     * the values at the last reset(), owned by the readers.
+     */
+    std::atomic<int64_t> m_counterBase[CounterCount];
+    std::atomic<int64_t> m_latenessBase[LatenessBuckets];
+};
+
+#endif /* IDLESTATISTICS_H */
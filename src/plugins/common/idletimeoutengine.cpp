@@ -0,0 +1,29 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2009 Dario Freddi <drf at kde.org>
+   Copyright (C) 2015 René J.V. Bertin <rjvbertin at gmail.com>
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idletimeoutengine.h"
+
+const IdleTimeoutEngineBase::Handle IdleTimeoutEngineBase::InvalidHandle;
+const int64_t IdleTimeoutEngineBase::ClockTolerance;
+const int64_t IdleTimeoutEngineBase::SuspendThreshold;
+const int64_t IdleTimeoutEngineBase::TimerGranularity;
+
+// compiles every member of the plugins' instantiation, including those no plugin calls
+template class BasicIdleTimeoutEngine<>;
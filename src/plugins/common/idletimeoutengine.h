@@ -0,0 +1,1383 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2009 Dario Freddi <drf at kde.org>
+   Copyright (C) 2015 René J.V. Bertin <rjvbertin at gmail.com>
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLETIMEOUTENGINE_H
+#define IDLETIMEOUTENGINE_H
+
+#include "idlebackend.h"
+#include "idleenginepolicies.h"
+#include "idlestatistics.h"
+#include "idletimeoutlist.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * The types shared by all the instantiations of BasicIdleTimeoutEngine.
+ */
+class IdleTimeoutEngineBase : public IdleActivitySink
+{
+public:
+    /**
+     * identifies a single timeout registration. Several registrations may share the
+     * same timeout value; the value stays monitored as long as one of them exists.
+     * A handle remains valid until it is passed to removeTimeouts(); stale handles are ignored.
+     */
+    typedef uint64_t Handle;
+    static const Handle InvalidHandle = 0;
+
+    /**
+     * how the engine decides when the IdleTimer should wake it up next.
+     */
+    enum SchedulingMode {
+        /**
+         * re-arm the timer to the time remaining until the next timeout each time
+         * the idle time is sampled (the default).
+         */
+        AdaptiveScheduling,
+        /**
+         * poll at the fixed interval set with setPollResolution().
+         */
+        FixedScheduling,
+        /**
+         * arm a single absolute deadline for the next timeout, computed from the time of
+         * the last user activity. The timer is only re-armed when that deadline moves
+         * (user activity, registration changes). Requires an IdleClock.
+         */
+        DeadlineScheduling
+    };
+
+    /**
+     * what the engine is waiting for. In every scheduling mode, the engine stops waking up
+     * once all timeouts have been reached.
+     */
+    enum State {
+        /**
+         * no timeout has been reached since the last user activity; the timer is armed
+         * for the smallest one.
+         */
+        Active,
+        /**
+         * idle: some timeouts have been reached and the timer is armed for the next one.
+         */
+        Armed,
+        /**
+         * there is no timeout left to reach and the end of the idle period is being caught
+         * (catchIdleEvent()).
+         */
+        Catching,
+        /**
+         * there is nothing to wait for but the next user activity: no timeout left to reach
+         * (or none registered) and no idle event to catch. With activity events the engine
+         * does no work at all until the next one; without them it samples the idle time once
+         * per smallest timeout, which is enough to detect the next idle period on time.
+         * Catching costs no more than this with activity events, and a sample per
+         * resumeLatency() without.
+         */
+        Parked
+    };
+
+    /**
+     * how the time the system spends suspended enters the idle time.
+     */
+    enum SuspendPolicy {
+        /**
+         * take the idle time source's word for it, whether it counts suspend or not (the default).
+         */
+        SuspendUnaware,
+        /**
+         * suspend counts as idle time; the timeouts it went past are reported on wake-up.
+         */
+        CountSuspendAsIdle,
+        /**
+         * the idle time only grows while the system is awake.
+         */
+        IgnoreSuspend,
+        /**
+         * like CountSuspendAsIdle, but the timeouts crossed on wake-up are collapsed into a
+         * single timeoutReached() for the largest of them.
+         */
+        CollapseSuspend
+    };
+
+protected:
+    /**
+     * the disagreement tolerated between the idle time source and the clock, in milliseconds
+     */
+    static const int64_t ClockTolerance = 10;
+    /**
+     * the smallest growth of IdleClock::suspendedTime() taken as a suspend, in milliseconds.
+     * The clocks it is derived from are read one after the other, so it jitters by a
+     * millisecond or more either way while the system stays awake.
+     */
+    static const int64_t SuspendThreshold = 1000;
+    /**
+     * the lateness a timer adds to the slack it is given, in milliseconds: expiries and
+     * idle times are whole milliseconds. A lateness budget is spent as this much less slack.
+     */
+    static const int64_t TimerGranularity = 1;
+};
+
+/**
+ * Platform-independent timeout bookkeeping shared by the polling plugins.
+ *
+ * The engine keeps the list of registered timeouts, compares them to the idle time
+ * obtained from an IdleTimeSource, reports hits to an IdleEventListener and decides
+ * when the IdleTimer has to wake it up again. It knows nothing about IOKit, Qt or GCD,
+ * so it can be exercised with a VirtualClock on any platform.
+ *
+ * The engine is a template on the way it reaches the clock and the timer, and on the storage
+ * of its lists (@see idleenginepolicies.h), so that everything it does can be inlined into
+ * a build with fixed platform classes. IdleTimeoutEngine, the instantiation the plugins use,
+ * calls the IdleClock and IdleTimer interfaces and keeps up to 8 timeouts without allocating.
+ * Whatever the storage, polling, reporting timeouts and re-arming the timer do not allocate
+ * once the lists have reached their working size (checked by benchmarks/allocationcheck).
+ *
+ * The engine is not thread-safe; all calls have to be made from the same thread
+ * (or be serialised by the caller).
+ */
+template<typename ClockPolicy = IdleClockPolicy<>, typename TimerPolicy = IdleTimerPolicy<>,
+         typename StoragePolicy = InlineTimeoutStorage<8> >
+class BasicIdleTimeoutEngine : public IdleTimeoutEngineBase
+{
+public:
+    /**
+     * @param clock : the monotonic clock used by DeadlineScheduling and the suspend
+     * policies; may be null when these are not used.
+     */
+    BasicIdleTimeoutEngine(IdleTimeSource *source, typename TimerPolicy::TimerType *timer,
+                           IdleEventListener *listener, typename ClockPolicy::ClockType *clock = 0);
+
+    /**
+     * switch the idle time polling engine to the specified interval in milliseconds
+     * or back to the default adaptive engine.
+     * @param msecs : the desired polling interval in milliseconds, or -1 for the default
+     * adaptive algorithm.
+     */
+    void setPollResolution(int msecs);
+    /**
+     * @returns the current polling interval, which will be -1 for the default adaptive interval
+     */
+    int pollResolution() const;
+    /**
+     * select the scheduling mode. Selecting FixedScheduling uses the current pollResolution().
+     * @returns false if the mode cannot be used (DeadlineScheduling without a clock).
+     */
+    bool setSchedulingMode(SchedulingMode mode);
+    SchedulingMode schedulingMode() const;
+    State state() const;
+    /**
+     * allow the timer to fire late by @p percent of the time remaining until each deadline
+     * in DeadlineScheduling mode, so that the system can batch wake-ups (the default is 0).
+     */
+    void setTimerSlack(int percent);
+    int timerSlack() const;
+    /**
+     * allow each timeout to be reported up to @p msecs milliseconds after it was reached
+     * (-1, the default, to express no preference). The engine spends the budget, less the
+     * TimerGranularity, as timer slack in the adaptive and deadline modes, where it takes
+     * precedence over setTimerSlack(), so that the system can coalesce the wake-ups. In
+     * FixedScheduling mode the poll interval already bounds the lateness and the budget is
+     * not used. Requires a clock in AdaptiveScheduling mode.
+     * A timeout that was reached less than the budget before the user became active again
+     * may go unreported, as if the idle period had ended just short of it.
+     */
+    void setLatenessBudget(int msecs);
+    int latenessBudget() const;
+    /**
+     * overrides the lateness budget for the timeout value @p timeout (-1 to use the
+     * engine-wide budget again). Typically used to let long timeouts (screen locking)
+     * be reported much later than short ones (dimming).
+     */
+    void setLatenessBudget(int timeout, int msecs);
+    /**
+     * @returns the budget that applies to the timeout value @p timeout.
+     */
+    int latenessBudget(int timeout) const;
+    /**
+     * selects how system suspend is accounted for. The time spent suspended is obtained
+     * from IdleClock::suspendedTime() each time the idle time is sampled, and removed from
+     * the source's idle time when IdleTimeSource::countsSuspendedTime(); the policy
+     * then decides whether to add it back.
+     * @returns false if the engine has no clock.
+     */
+    bool setSuspendPolicy(SuspendPolicy policy);
+    SuspendPolicy suspendPolicy() const;
+    /**
+     * to be called when the platform signals that the system woke up. The engine samples
+     * the idle time once, reports the timeouts crossed during the suspend according to the
+     * policy, and re-arms the timer once. Without this call, the suspend is accounted for
+     * at the next wake-up of the timer.
+     */
+    void systemResumed();
+    /**
+     * @returns the number of times the IdleTimer woke up the engine since the last
+     * reset of the statistics.
+     */
+    int64_t timerWakeups() const;
+    /**
+     * the engine's runtime counters and detection lateness histogram; may be read and
+     * reset from any thread. The event filter feeding the engine can count into them too.
+     */
+    IdleStatistics &statistics();
+    const IdleStatistics &statistics() const;
+
+    /**
+     * registers @p count timeouts in a single operation. With n registered values and r
+     * registrations, this costs O(n + r + count log n): the sorted batch is merged into the
+     * sorted store once. A single value is inserted in place instead, or revived if it is
+     * still held in the store.
+     * @param msecs : the timeout values in milliseconds, in any order
+     * @param handles : receives one handle per timeout, in the same order
+     */
+    void addTimeouts(const int *msecs, size_t count, Handle *handles);
+    /**
+     * removes @p count registrations in a single operation, in amortised O(count). Each
+     * handle leads to its value in the store, whose reference count drops in place; a value
+     * nobody refers to any more stays in the store, skipped, until dead values make up
+     * more than half of it; registering it again revives it in place. The timer is only
+     * re-armed when the value it is armed for goes away.
+     */
+    void removeTimeouts(const Handle *handles, size_t count);
+    /**
+     * @returns the timeout value registered under @p handle, or -1 if the handle is not valid.
+     */
+    int timeoutForHandle(Handle handle) const;
+    /**
+     * @returns the number of registrations of the timeout value @p msecs, 0 if there is none.
+     */
+    int registrations(int msecs) const;
+
+    /**
+     * registers @p msecs unless it was already registered through this function.
+     * This is the AbstractSystemPoller flavour, keyed by the timeout value; O(n).
+     */
+    void addTimeout(int msecs);
+    /**
+     * removes a timeout registered through addTimeout(int); O(n) for finding the handle
+     * of the value.
+     */
+    void removeTimeout(int msecs);
+    /**
+     * @returns the registered timeouts, in ascending order, until they change. Drops the
+     * removed values still held in the store first, in O(n + r).
+     */
+    IdleTimeoutList timeouts() const;
+    int timeoutCount() const;
+    /**
+     * @returns the smallest timeout that has not been reached since the last user
+     * activity, or -1 if all timeouts have been reached. O(1).
+     */
+    int nextTimeout() const;
+
+    /**
+     * Query the idle time source for the current idle time. Also compares the current idle
+     * time to the registered list of timeouts, and reports the hits to the listener: all the
+     * timeouts the idle time went past since the last poll, in a single timeoutsReached()
+     * call when there are several.
+     * @param allowEmits : should timeoutReached() notifications be generated?
+     * @param idle : returns the current true idle time (time without input events)
+     * @returns : the simulated idle time (time without input events and since the last
+     * call to simulateUserActivity).
+     */
+    int64_t poll(bool allowEmits, int64_t &idle);
+    int64_t poll(bool allowEmits);
+    int forcePollRequest();
+
+    /**
+     * to be called each time the IdleTimer expires.
+     */
+    void timerFired();
+    /**
+     * to be called when a user input event was seen (e.g. by a native event filter).
+     */
+    void inputEvent();
+    /**
+     * to be called when user activity took place at @p time on the engine's clock,
+     * typically by an ActivityFilter. Unlike inputEvent() this does not query the idle
+     * time source. Falls back to inputEvent() when the engine has no clock.
+     */
+    void activityAt(int64_t time);
+
+    /**
+     * catch the end of the current idle period: resumingFromIdle() is reported once, at the
+     * first user activity. With activity events (setActivityEventsAvailable()) that costs no
+     * wake-up at all; otherwise the engine samples the idle time at least every
+     * resumeLatency() milliseconds and reports a resume as soon as the idle time is lower
+     * than the previous sample implies.
+     */
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+    bool isCatchingIdleEvents() const;
+    /**
+     * tells the engine whether user activity is reported to it as it happens, through
+     * inputEvent() or activityAt() (typically from an event filter). False by default.
+     */
+    void setActivityEventsAvailable(bool available);
+    bool activityEventsAvailable() const;
+    /**
+     * the longest it may take to notice the end of an idle period that is being caught
+     * when there are no activity events (1000ms by default, -1 to only rely on the
+     * sampling done for the timeouts).
+     */
+    void setResumeLatency(int msecs);
+    int resumeLatency() const;
+    /**
+     * resets the (simulated) idle time to 0 by storing the current idle time as an offset.
+     * The platform-specific part of simulating user activity is up to the caller.
+     */
+    void simulateUserActivity();
+    /**
+     * forget about the detection state, typically when unloading the poller. The list
+     * of registered timeouts is preserved.
+     */
+    void reset();
+
+private:
+    /**
+     * this function reconfigures the idle polling timer for the next timeout as a function
+     * of the current idle time, in the Active and Armed states.
+     * @returns the interval the timer runs at.
+     */
+    int64_t kickTimer(int64_t idle);
+    /**
+     * runs the timer at the low rate needed in the Catching and Parked states, if any.
+     */
+    void park();
+    /**
+     * @returns the state the registrations, the cursor and m_catch call for.
+     */
+    State nextState() const;
+    /**
+     * enters nextState() and reconfigures the timer accordingly; the single place
+     * where the state changes, except for reset() and catchIdleEvent() while parked.
+     */
+    void reschedule(int64_t idle);
+    /**
+     * @returns true if the end of the idle period has to be caught by sampling.
+     */
+    bool pollsForResume() const;
+    /**
+     * @returns the slack the timer may take for a deadline of @p timeout, @p remaining
+     * milliseconds from now.
+     */
+    int64_t timerSlackFor(int timeout, int64_t remaining) const;
+    void stopTimer();
+    /**
+     * queries the idle time source and updates the real idle time and the idle offset.
+     */
+    void sampleIdle(int64_t &idle);
+    /**
+     * accounts for the system suspends since the last sample, and @returns the part of the
+     * source's idle time @p idle that was spent awake.
+     */
+    int64_t awakeIdle(int64_t idle);
+    void resumedFromIdle();
+    void detectedActivity();
+    /**
+     * repositions m_cursor after a change to m_timeouts.
+     */
+    void updateCursor() const;
+    /**
+     * moves @p index past the values of m_timeouts that are no longer referenced.
+     */
+    void skipDead(size_t &index) const;
+    /**
+     * merges the values collected in m_pending into m_timeouts, one reference per value,
+     * drops the values that are no longer referenced, and updates the derived state and
+     * the positions of the registrations. O(n + r + k log n) for n stored values,
+     * r registrations and k pending values. Const so that timeouts() can compact the store.
+     */
+    void applyPending() const;
+    /**
+     * adds one reference to @p msecs in place, reviving a value without registrations or
+     * inserting a new one, and @returns its index in m_timeouts. O(n + r) for the shifts,
+     * without the merge of applyPending(). @returns NoPosition without changing anything
+     * when a new value would join values without registrations, which applyPending() drops
+     * rather than let them take up the storage.
+     */
+    uint32_t insertTimeout(int msecs);
+    Handle allocateRegistration(int msecs);
+
+    struct Registration {
+        int msecs;
+        uint32_t generation;
+        /**
+         * the index of msecs in m_timeouts, or NoPosition until the value is merged in.
+         */
+        uint32_t position;
+        bool used;
+    };
+    static const uint32_t NoPosition = 0xffffffff;
+    typedef typename StoragePolicy::template Array<int> IntArray;
+    typedef typename StoragePolicy::template Array<std::pair<int, int> > BudgetArray;
+    typedef typename StoragePolicy::template Array<std::pair<int, Handle> > ValueHandleArray;
+
+    IdleTimeSource *m_source;
+    TimerPolicy m_timer;
+    IdleEventListener *m_listener;
+    ClockPolicy m_clock;
+    /**
+     * the registered timeouts, sorted in ascending order. Values whose registrations are
+     * all gone stay with a reference count of 0 until the store is compacted, which
+     * timeouts() may do: the store is mutable for that reason.
+     */
+    mutable IntArray m_timeouts;
+    /**
+     * the number of registrations of each value in m_timeouts.
+     */
+    mutable IntArray m_refCounts;
+    /**
+     * the number of values in m_timeouts without registrations, and the index of the first
+     * value with some.
+     */
+    mutable size_t m_deadTimeouts,
+        m_firstLive;
+    /**
+     * registration slots, addressed by the handles, and the list of free slots.
+     */
+    mutable typename StoragePolicy::template Array<Registration> m_registrations;
+    typename StoragePolicy::template Array<uint32_t> m_freeRegistrations;
+    /**
+     * the registrations made through addTimeout(int), sorted by value.
+     */
+    ValueHandleArray m_valueHandles;
+    /**
+     * scratch storage for the batch operations, kept to avoid reallocations.
+     */
+    mutable IntArray m_pending,
+        m_mergedTimeouts,
+        m_mergedRefCounts,
+        m_positions;
+    IntArray m_reached;
+    /**
+     * index in m_timeouts of the next timeout to be reached, never a value without
+     * registrations. Everything before it has already been reported since the last
+     * user activity.
+     */
+    mutable size_t m_cursor;
+    State m_state;
+    SchedulingMode m_mode;
+    int m_pollResolution;
+    int m_timerSlack;
+    int m_latenessBudget;
+    /**
+     * the timeout values with a budget of their own, sorted by value.
+     */
+    BudgetArray m_timeoutBudgets;
+    /**
+     * the absolute time the timer is armed for in DeadlineScheduling mode, or -1.
+     */
+    int64_t m_armedDeadline;
+    IdleStatistics m_statistics;
+    /**
+     * the last timeout reported, or -1.
+     */
+    int m_lastTimeout;
+    int64_t m_realIdle,
+        m_idleOffset;
+    /**
+     * when m_realIdle was valid on the clock, or -1.
+     */
+    int64_t m_sampledAt;
+    int m_resumeLatency;
+    bool m_activityEvents;
+    SuspendPolicy m_suspendPolicy;
+    /**
+     * the clock's suspendedTime() at the last sample, and how much of it falls in the
+     * current idle period.
+     */
+    int64_t m_suspendedTotal,
+        m_suspendedIdle;
+    /**
+     * the last sample found that the system had been suspended.
+     */
+    bool m_resumedFromSuspend;
+    bool m_catch;
+};
+
+/**
+ * the engine of the plugins, with the platform's clock and timer chosen at runtime.
+ */
+typedef BasicIdleTimeoutEngine<> IdleTimeoutEngine;
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::BasicIdleTimeoutEngine(IdleTimeSource *source,
+    typename TimerPolicy::TimerType *timer, IdleEventListener *listener, typename ClockPolicy::ClockType *clock)
+    : m_source(source)
+    , m_timer(timer)
+    , m_listener(listener)
+    , m_clock(clock)
+    , m_deadTimeouts(0)
+    , m_firstLive(0)
+    , m_cursor(0)
+    , m_state(Parked)
+    , m_mode(AdaptiveScheduling)
+    , m_pollResolution(-1)
+    , m_timerSlack(0)
+    , m_latenessBudget(-1)
+    , m_armedDeadline(-1)
+    , m_lastTimeout(-1)
+    , m_realIdle(0)
+    , m_idleOffset(0)
+    , m_sampledAt(-1)
+    , m_resumeLatency(1000)
+    , m_activityEvents(false)
+    , m_suspendPolicy(SuspendUnaware)
+    , m_suspendedTotal(0)
+    , m_suspendedIdle(0)
+    , m_resumedFromSuspend(false)
+    , m_catch(false)
+{
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::setPollResolution(int msecs)
+{
+    m_pollResolution = (msecs >= 0) ? msecs : -1;
+    if (m_pollResolution >= 0) {
+        m_mode = FixedScheduling;
+        if (m_timer.isActive() && (m_state == Active || m_state == Armed)) {
+            m_timer.start(m_pollResolution);
+        }
+    } else if (m_mode == FixedScheduling) {
+        m_mode = AdaptiveScheduling;
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::pollResolution() const
+{
+    return m_pollResolution;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+bool BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::setSchedulingMode(SchedulingMode mode)
+{
+    if (mode == DeadlineScheduling && !m_clock.isValid()) {
+        return false;
+    }
+    if (mode == FixedScheduling && m_pollResolution < 0) {
+        return false;
+    }
+    if (mode != FixedScheduling) {
+        m_pollResolution = -1;
+    }
+    m_mode = mode;
+    m_armedDeadline = -1;
+    if (!m_timeouts.empty()) {
+        poll(false);
+    }
+    return true;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+IdleTimeoutEngineBase::SchedulingMode BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::schedulingMode() const
+{
+    return m_mode;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+IdleTimeoutEngineBase::State BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::state() const
+{
+    return m_state;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+bool BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::setSuspendPolicy(SuspendPolicy policy)
+{
+    if (policy != SuspendUnaware && !m_clock.isValid()) {
+        return false;
+    }
+    m_suspendPolicy = policy;
+    m_suspendedTotal = m_clock.isValid() ? m_clock.suspendedTime() : 0;
+    m_suspendedIdle = 0;
+    m_resumedFromSuspend = false;
+    return true;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+IdleTimeoutEngineBase::SuspendPolicy BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::suspendPolicy() const
+{
+    return m_suspendPolicy;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::systemResumed()
+{
+    if (!m_timeouts.empty() || m_catch) {
+        poll(true);
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::setTimerSlack(int percent)
+{
+    m_timerSlack = percent > 0 ? percent : 0;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::timerSlack() const
+{
+    return m_timerSlack;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::setLatenessBudget(int msecs)
+{
+    m_latenessBudget = msecs >= 0 ? msecs : -1;
+    // the new budget applies from the next deadline on
+    m_armedDeadline = -1;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::latenessBudget() const
+{
+    return m_latenessBudget;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::setLatenessBudget(int timeout, int msecs)
+{
+    typename BudgetArray::iterator it = std::lower_bound(m_timeoutBudgets.begin(),
+        m_timeoutBudgets.end(), std::make_pair(timeout, -1));
+    const bool found = it != m_timeoutBudgets.end() && it->first == timeout;
+    if (msecs >= 0) {
+        if (found) {
+            it->second = msecs;
+        } else {
+            m_timeoutBudgets.insert(it, std::make_pair(timeout, msecs));
+        }
+    } else if (found) {
+        m_timeoutBudgets.erase(it);
+    }
+    m_armedDeadline = -1;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::latenessBudget(int timeout) const
+{
+    if (!m_timeoutBudgets.empty()) {
+        typename BudgetArray::const_iterator it = std::lower_bound(m_timeoutBudgets.begin(),
+            m_timeoutBudgets.end(), std::make_pair(timeout, -1));
+        if (it != m_timeoutBudgets.end() && it->first == timeout) {
+            return it->second;
+        }
+    }
+    return m_latenessBudget;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int64_t BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::timerSlackFor(int timeout, int64_t remaining) const
+{
+    const int budget = latenessBudget(timeout);
+    if (budget >= 0) {
+        // deadline + slack + granularity stays within the budget
+        return std::max(budget - TimerGranularity, int64_t(0));
+    }
+    return std::max(remaining, int64_t(0)) * m_timerSlack / 100;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int64_t BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::timerWakeups() const
+{
+    return m_statistics.counter(IdleStatistics::TimerWakeups);
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+IdleStatistics &BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::statistics()
+{
+    return m_statistics;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+const IdleStatistics &BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::statistics() const
+{
+    return m_statistics;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+IdleTimeoutList BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::timeouts() const
+{
+    if (m_deadTimeouts) {
+        applyPending();
+    }
+    return IdleTimeoutList(m_timeouts.data(), m_timeouts.size());
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::timeoutCount() const
+{
+    return int(m_timeouts.size() - m_deadTimeouts);
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::nextTimeout() const
+{
+    return m_cursor < m_timeouts.size() ? m_timeouts[m_cursor] : -1;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::updateCursor() const
+{
+    // the timeouts up to and including the last one reported are considered
+    // reached until the next user activity, whether they were added before or after.
+    m_cursor = std::upper_bound(m_timeouts.begin(), m_timeouts.end(), m_lastTimeout) - m_timeouts.begin();
+    skipDead(m_cursor);
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::skipDead(size_t &index) const
+{
+    while (index < m_refCounts.size() && !m_refCounts[index]) {
+        ++index;
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+IdleTimeoutEngineBase::Handle BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::allocateRegistration(int msecs)
+{
+    uint32_t index;
+    if (!m_freeRegistrations.empty()) {
+        index = m_freeRegistrations.back();
+        m_freeRegistrations.pop_back();
+    } else {
+        index = uint32_t(m_registrations.size());
+        Registration registration = { 0, 1, NoPosition, false };
+        m_registrations.push_back(registration);
+    }
+    Registration &registration = m_registrations[index];
+    registration.msecs = msecs;
+    registration.position = NoPosition;
+    registration.used = true;
+    // the index is offset by one so that no valid handle equals InvalidHandle
+    return (Handle(registration.generation) << 32) | (index + 1);
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::timeoutForHandle(Handle handle) const
+{
+    const uint32_t index = uint32_t(handle & 0xffffffff) - 1;
+    if (index < m_registrations.size()) {
+        const Registration &registration = m_registrations[index];
+        if (registration.used && registration.generation == uint32_t(handle >> 32)) {
+            return registration.msecs;
+        }
+    }
+    return -1;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::registrations(int msecs) const
+{
+    const int *it = std::lower_bound(m_timeouts.data(), m_timeouts.data() + m_timeouts.size(), msecs);
+    if (it != m_timeouts.data() + m_timeouts.size() && *it == msecs) {
+        // 0 for a removed value still in the store
+        return m_refCounts[it - m_timeouts.data()];
+    }
+    return 0;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::applyPending() const
+{
+    std::sort(m_pending.begin(), m_pending.end());
+    m_mergedTimeouts.clear();
+    m_mergedRefCounts.clear();
+    // where each stored value ends up, for moving the registrations along
+    m_positions.clear();
+    size_t i = 0, j = 0;
+    const size_t n = m_timeouts.size(), k = m_pending.size();
+    while (i < n || j < k) {
+        if (j == k || (i < n && m_timeouts[i] < m_pending[j])) {
+            m_positions.push_back(m_refCounts[i] ? int(m_mergedTimeouts.size()) : -1);
+            if (m_refCounts[i]) {
+                m_mergedTimeouts.push_back(m_timeouts[i]);
+                m_mergedRefCounts.push_back(m_refCounts[i]);
+            }
+            ++i;
+        } else {
+            const int value = m_pending[j];
+            int refs = 0;
+            for (; j < k && m_pending[j] == value; ++j) {
+                ++refs;
+            }
+            if (i < n && m_timeouts[i] == value) {
+                refs += m_refCounts[i];
+                m_positions.push_back(int(m_mergedTimeouts.size()));
+                ++i;
+            }
+            m_mergedTimeouts.push_back(value);
+            m_mergedRefCounts.push_back(refs);
+        }
+    }
+    m_timeouts.swap(m_mergedTimeouts);
+    m_refCounts.swap(m_mergedRefCounts);
+    m_pending.clear();
+    m_deadTimeouts = 0;
+    m_firstLive = 0;
+
+    for (size_t r = 0; r < m_registrations.size(); ++r) {
+        Registration &registration = m_registrations[r];
+        if (!registration.used) {
+            continue;
+        }
+        if (registration.position != NoPosition) {
+            registration.position = uint32_t(m_positions[registration.position]);
+        } else {
+            // registered in this batch
+            registration.position = uint32_t(std::lower_bound(m_timeouts.begin(), m_timeouts.end(),
+                                                              registration.msecs) - m_timeouts.begin());
+        }
+    }
+    updateCursor();
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+uint32_t BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::insertTimeout(int msecs)
+{
+    const size_t position = std::lower_bound(m_timeouts.begin(), m_timeouts.end(), msecs) - m_timeouts.begin();
+    if (position < m_timeouts.size() && m_timeouts[position] == msecs) {
+        if (m_refCounts[position]++ == 0) {
+            --m_deadTimeouts;
+        }
+    } else if (m_deadTimeouts) {
+        return NoPosition;
+    } else {
+        m_timeouts.insert(m_timeouts.begin() + position, msecs);
+        m_refCounts.insert(m_refCounts.begin() + position, 1);
+        for (size_t r = 0; r < m_registrations.size(); ++r) {
+            Registration &registration = m_registrations[r];
+            if (registration.used && registration.position != NoPosition && registration.position >= position) {
+                ++registration.position;
+            }
+        }
+        if (m_firstLive > position) {
+            ++m_firstLive;
+        }
+    }
+    m_firstLive = std::min(m_firstLive, position);
+    updateCursor();
+    return uint32_t(position);
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::addTimeouts(const int *msecs, size_t count, Handle *handles)
+{
+    if (!count) {
+        return;
+    }
+    // what addTimeout(int) does: no sorting or merging for a single value, mostly
+    const uint32_t position = count == 1 ? insertTimeout(msecs[0]) : NoPosition;
+    if (position != NoPosition) {
+        handles[0] = allocateRegistration(msecs[0]);
+        m_registrations[uint32_t(handles[0] & 0xffffffff) - 1].position = position;
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            handles[i] = allocateRegistration(msecs[i]);
+            m_pending.push_back(msecs[i]);
+        }
+        applyPending();
+    }
+    // this is about the only place except for reset() where
+    // we can reset m_realIdle;
+    m_realIdle = 0;
+    poll(false);
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::removeTimeouts(const Handle *handles, size_t count)
+{
+    bool died = false,
+        rearm = false;
+    for (size_t i = 0; i < count; ++i) {
+        if (timeoutForHandle(handles[i]) < 0) {
+            continue;
+        }
+        const uint32_t index = uint32_t(handles[i] & 0xffffffff) - 1;
+        Registration &registration = m_registrations[index];
+        registration.used = false;
+        // invalidate the handles that still refer to this slot
+        ++registration.generation;
+        m_freeRegistrations.push_back(index);
+        const size_t position = registration.position;
+        if (--m_refCounts[position] == 0) {
+            ++m_deadTimeouts;
+            died = true;
+            // the value the timer is armed for, or the smallest one, which paces the
+            // sampling while parked
+            rearm = rearm || position == m_cursor || (position == m_firstLive && m_cursor == m_timeouts.size());
+        }
+    }
+    if (!died) {
+        return;
+    }
+    if (m_deadTimeouts * 2 > m_timeouts.size()) {
+        // amortised over the removals that left the dead values behind
+        applyPending();
+    } else {
+        skipDead(m_firstLive);
+        skipDead(m_cursor);
+    }
+    if (rearm) {
+        poll(false);
+    } else {
+        // at most from Armed back to Active, which the timer does not care about
+        m_state = nextState();
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::addTimeout(int msecs)
+{
+    typename ValueHandleArray::iterator it = std::lower_bound(m_valueHandles.begin(),
+        m_valueHandles.end(), std::make_pair(msecs, InvalidHandle));
+    if (it == m_valueHandles.end() || it->first != msecs) {
+        Handle handle;
+        addTimeouts(&msecs, 1, &handle);
+        m_valueHandles.insert(it, std::make_pair(msecs, handle));
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::removeTimeout(int msecs)
+{
+    typename ValueHandleArray::iterator it = std::lower_bound(m_valueHandles.begin(),
+        m_valueHandles.end(), std::make_pair(msecs, InvalidHandle));
+    if (it != m_valueHandles.end() && it->first == msecs) {
+        const Handle handle = it->second;
+        m_valueHandles.erase(it);
+        removeTimeouts(&handle, 1);
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::stopTimer()
+{
+    m_timer.stop();
+    m_armedDeadline = -1;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int64_t BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::kickTimer(int64_t idle)
+{
+    const int64_t currentMinTimeout = m_timeouts[m_cursor];
+    const bool resumePolling = pollsForResume();
+    if (m_mode == DeadlineScheduling) {
+        const int64_t now = m_clock.now();
+        // the time of the last (simulated) user activity does not change while idling,
+        // so neither does the deadline, and the timer is left alone.
+        int64_t deadline = now - idle + currentMinTimeout;
+        int64_t slack = timerSlackFor(int(currentMinTimeout), deadline - now);
+        if (resumePolling && deadline - now > m_resumeLatency) {
+            // a single low-rate deadline for catching the resume; it is kept as long
+            // as it is close enough.
+            if (m_armedDeadline >= now && m_armedDeadline - now <= m_resumeLatency) {
+                return m_armedDeadline - now;
+            }
+            deadline = now + m_resumeLatency;
+            slack = 0;
+        }
+        if (deadline != m_armedDeadline) {
+            m_armedDeadline = deadline;
+            m_timer.startAt(deadline, now, slack);
+        }
+        return deadline - now;
+    }
+    // change the poll timer interval if there is reason to change it.
+    // NB: to minimise CPU load wake-ups to the utmost extent, we could consider an
+    // option to set the interval to "remainingTime - 1ms" as long as that is >= 1ms,
+    // but then the question becomes how to continue polling from there.
+    // a timeout can already be due when the previous one was detected late enough; it
+    // is then picked up by an immediate wake-up rather than at the old interval.
+    int64_t interval = m_pollResolution >= 0 ? m_pollResolution : std::max(currentMinTimeout - idle, int64_t(0));
+    int budget = m_pollResolution < 0 && m_clock.isValid() ? latenessBudget(int(currentMinTimeout)) : -1;
+    if (resumePolling && interval >= m_resumeLatency) {
+        interval = m_resumeLatency;
+        budget = -1;
+    }
+    if (budget > 0) {
+        const int64_t now = m_clock.now();
+        m_timer.startAt(now + interval, now, std::max(budget - TimerGranularity, int64_t(0)));
+    } else {
+        m_timer.start(interval);
+    }
+    return interval;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::park()
+{
+    // nothing can happen before the user becomes active again. That is signalled by the
+    // activity events when there are any; otherwise it has to be noticed by sampling, within
+    // the resume latency when it is caught, and before the smallest timeout could have been
+    // reached again so that the next idle period is detected on time.
+    int64_t interval = -1;
+    if (!m_activityEvents) {
+        if (pollsForResume()) {
+            interval = m_resumeLatency;
+        }
+        const int minTimeout = m_firstLive < m_timeouts.size() ? m_timeouts[m_firstLive] : -1;
+        if (minTimeout > 0 && (interval < 0 || minTimeout < interval)) {
+            interval = minTimeout;
+        }
+    }
+    if (interval < 0) {
+        if (m_timer.isActive()) {
+            stopTimer();
+        }
+        m_armedDeadline = -1;
+        return;
+    }
+    if (m_mode == DeadlineScheduling) {
+        const int64_t now = m_clock.now();
+        // a single low-rate deadline, kept as long as it is close enough
+        if (m_armedDeadline >= now && m_armedDeadline - now <= interval) {
+            return;
+        }
+        m_armedDeadline = now + interval;
+        m_timer.startAt(m_armedDeadline, now, 0);
+    } else if (!m_timer.isActive() || m_timer.interval() != interval) {
+        m_timer.start(interval);
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+IdleTimeoutEngineBase::State BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::nextState() const
+{
+    if (m_cursor < m_timeouts.size()) {
+        return m_cursor == m_firstLive ? Active : Armed;
+    }
+    return m_catch ? Catching : Parked;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::reschedule(int64_t idle)
+{
+    m_state = nextState();
+    if (m_state == Active || m_state == Armed) {
+        kickTimer(idle);
+    } else {
+        park();
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+bool BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::pollsForResume() const
+{
+    return m_catch && !m_activityEvents && m_resumeLatency > 0;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::sampleIdle(int64_t &idle)
+{
+    m_statistics.increment(IdleStatistics::IdleQueries);
+    if (m_source->queryIdleTime(idle)) {
+        if (m_suspendPolicy != SuspendUnaware) {
+            idle = awakeIdle(idle);
+        }
+        bool active = idle < m_realIdle;
+        const int64_t now = m_clock.isValid() ? m_clock.now() : -1;
+        if (!active && !m_activityEvents && m_sampledAt >= 0) {
+            // without activity events, an idle time lower than what the previous sample implies
+            // reveals activity, even if the idle time has grown again since
+            active = idle + ClockTolerance < m_realIdle + (now - m_sampledAt);
+        }
+        if (active) {
+            // an input event was missed, possibly because the event filter could not be installed
+            m_statistics.increment(IdleStatistics::MissedActivity);
+            resumedFromIdle();
+        } else if (idle < m_idleOffset) {
+            // reset the idle offset if the idle time dropped below it
+            m_idleOffset = 0;
+        }
+        m_realIdle = idle;
+        m_sampledAt = now;
+        if (active && m_catch) {
+            detectedActivity();
+        }
+    } else {
+        idle = m_realIdle;
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int64_t BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::awakeIdle(int64_t idle)
+{
+    // the jitter is neither a suspend nor a reason to move the reference, in either direction
+    const int64_t suspended = m_clock.suspendedTime();
+    if (suspended - m_suspendedTotal >= SuspendThreshold) {
+        m_statistics.increment(IdleStatistics::Suspends);
+        m_suspendedIdle += suspended - m_suspendedTotal;
+        m_resumedFromSuspend = true;
+        m_suspendedTotal = suspended;
+    }
+    if (m_source->countsSuspendedTime()) {
+        if (idle < m_suspendedIdle) {
+            // the user was active after the suspend
+            m_suspendedIdle = 0;
+        } else {
+            idle -= m_suspendedIdle;
+        }
+    }
+    return idle;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int64_t BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::poll(bool allowEmit, int64_t &idle)
+{
+    sampleIdle(idle);
+
+    int64_t offsetIdle = idle - m_idleOffset;
+    const bool resumedFromSuspend = m_resumedFromSuspend;
+    if (allowEmit) {
+        m_resumedFromSuspend = false;
+    }
+    if (m_suspendPolicy == CountSuspendAsIdle || m_suspendPolicy == CollapseSuspend) {
+        offsetIdle += m_suspendedIdle;
+    }
+    if (allowEmit) {
+        // m_timeouts is sorted and everything before m_cursor has been reported already,
+        // so the new hits are the timeouts from the cursor up to the idle time.
+        if (m_cursor < m_timeouts.size() && offsetIdle >= m_timeouts[m_cursor]) {
+            // Bingo!
+            const size_t first = m_cursor;
+            size_t crossed = 0;
+            while (m_cursor < m_timeouts.size() && offsetIdle >= m_timeouts[m_cursor]) {
+                m_statistics.increment(IdleStatistics::TimeoutsEmitted);
+                if (!resumedFromSuspend) {
+                    // the lateness of a timeout crossed while the system was asleep is meaningless
+                    m_statistics.recordLateness(offsetIdle - m_timeouts[m_cursor]);
+                }
+                m_lastTimeout = m_timeouts[m_cursor];
+                ++crossed;
+                ++m_cursor;
+                skipDead(m_cursor);
+            }
+            reschedule(offsetIdle);
+            if (crossed == 1 || (resumedFromSuspend && m_suspendPolicy == CollapseSuspend)) {
+                m_listener->timeoutReached(m_lastTimeout);
+            } else {
+                // the listener may change the registrations, or even poll again
+                IntArray reached;
+                reached.swap(m_reached);
+                reached.clear();
+                for (size_t i = first; i < m_cursor; ++i) {
+                    if (m_refCounts[i]) {
+                        reached.push_back(m_timeouts[i]);
+                    }
+                }
+                m_listener->timeoutsReached(reached.data(), reached.size());
+                reached.swap(m_reached);
+            }
+            return offsetIdle;
+        }
+    }
+    reschedule(offsetIdle);
+
+    // return the "virtual" idle i.e. the time since the last simulateUserActivity(),
+    // not the actual idle time!
+    return offsetIdle;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int64_t BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::poll(bool allowEmits)
+{
+    int64_t idle;
+    return poll(allowEmits, idle);
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::forcePollRequest()
+{
+    return int(poll(false));
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::timerFired()
+{
+    m_statistics.increment(IdleStatistics::TimerWakeups);
+    // the deadline has been consumed, whether the timer is single-shot or repeating
+    m_armedDeadline = -1;
+    if (!m_timeouts.empty() || m_catch) {
+        const int64_t idle = poll(true);
+        if (idle == 0 && m_catch) {
+            // the user is active right now
+            resumedFromIdle();
+            detectedActivity();
+        }
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::inputEvent()
+{
+    if (m_catch) {
+        detectedActivity();
+    }
+    if (!m_timeouts.empty()) {
+        poll(true);
+    } else {
+        // nothing samples the drop in idle time; the timeouts registered from now on
+        // belong to the new idle period
+        resumedFromIdle();
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::activityAt(int64_t time)
+{
+    if (!m_clock.isValid()) {
+        inputEvent();
+        return;
+    }
+    if (m_catch) {
+        detectedActivity();
+    }
+    // also without timeouts: those registered from now on belong to the new idle period
+    resumedFromIdle();
+    if (!m_timeouts.empty()) {
+        // this is what poll() would conclude from the idle time dropping
+        const int64_t idle = std::max(m_clock.now() - time, int64_t(0));
+        m_realIdle = idle;
+        // an estimate, not a sample: the source may have seen later activity
+        m_sampledAt = -1;
+        reschedule(idle);
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::detectedActivity()
+{
+    if (m_catch) {
+        m_listener->resumingFromIdle();
+    }
+    stopCatchingIdleEvents();
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::catchIdleEvent()
+{
+    if (!m_catch && !m_activityEvents && m_resumeLatency > 0) {
+        // sample first, so that activity before this call is not taken for the resume,
+        // then arm the fallback deadline
+        const int64_t idle = poll(false);
+        m_catch = true;
+        reschedule(idle);
+        return;
+    }
+    m_catch = true;
+    if (m_state == Parked) {
+        // the resume is signalled by the activity events: still nothing to do
+        m_state = Catching;
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::stopCatchingIdleEvents()
+{
+    // this is called after resumingFromIdle, and should not stop the poll timer
+    // because that also drives the timeout detection. The m_catch state variable
+    // indicates whether resuming-from-idle events should be caught or not.
+    m_catch = false;
+    if (m_state == Catching) {
+        // the timer may only have been running to catch the resume
+        reschedule(m_realIdle - m_idleOffset);
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::setActivityEventsAvailable(bool available)
+{
+    m_activityEvents = available;
+    if (!m_timeouts.empty() || m_catch) {
+        // parking may need sampling now, or no longer
+        poll(false);
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+bool BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::activityEventsAvailable() const
+{
+    return m_activityEvents;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::setResumeLatency(int msecs)
+{
+    m_resumeLatency = msecs > 0 ? msecs : -1;
+    m_armedDeadline = -1;
+    if (pollsForResume()) {
+        poll(false);
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+int BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::resumeLatency() const
+{
+    return m_resumeLatency;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+bool BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::isCatchingIdleEvents() const
+{
+    return m_catch;
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::resumedFromIdle()
+{
+    m_idleOffset = 0;
+    m_lastTimeout = -1;
+    m_cursor = m_firstLive;
+    // a suspend before the activity is not part of the new idle period
+    m_suspendedIdle = 0;
+    if (m_suspendPolicy != SuspendUnaware) {
+        m_suspendedTotal = std::max(m_suspendedTotal, m_clock.suspendedTime());
+    }
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::simulateUserActivity()
+{
+    // store an idle offset in order to simulate a (software) reset
+    resumedFromIdle();
+    int64_t idle;
+    sampleIdle(idle);
+    m_idleOffset = idle;
+    reschedule(0);
+}
+
+template<typename ClockPolicy, typename TimerPolicy, typename StoragePolicy>
+void BasicIdleTimeoutEngine<ClockPolicy, TimerPolicy, StoragePolicy>::reset()
+{
+    stopTimer();
+    // until the next poll
+    m_state = Parked;
+    m_lastTimeout = -1;
+    m_cursor = m_firstLive;
+    m_realIdle = 0;
+    m_idleOffset = 0;
+    m_suspendedIdle = 0;
+}
+
+#endif /* IDLETIMEOUTENGINE_H */
@@ -0,0 +1,93 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLETIMEOUTLIST_H
+#define IDLETIMEOUTLIST_H
+
+#include <stddef.h>
+
+#include <vector>
+
+/**
+ * A read-only view of a list of timeouts, whatever stores them. It does not copy
+ * anything, and is only valid until the list it looks at changes.
+ */
+class IdleTimeoutList
+{
+public:
+    typedef const int *const_iterator;
+
+    IdleTimeoutList()
+        : m_begin(0)
+        , m_end(0)
+    {
+    }
+
+    IdleTimeoutList(const int *data, size_t size)
+        : m_begin(data)
+        , m_end(data + size)
+    {
+    }
+
+    const_iterator begin() const
+    {
+        return m_begin;
+    }
+    const_iterator end() const
+    {
+        return m_end;
+    }
+    const int *data() const
+    {
+        return m_begin;
+    }
+    size_t size() const
+    {
+        return m_end - m_begin;
+    }
+    bool empty() const
+    {
+        return m_begin == m_end;
+    }
+    int operator[](size_t index) const
+    {
+        return m_begin[index];
+    }
+    int front() const
+    {
+        return *m_begin;
+    }
+    int back() const
+    {
+        return m_end[-1];
+    }
+
+    /**
+     * @returns a copy that outlives the list.
+     */
+    std::vector<int> toVector() const
+    {
+        return std::vector<int>(m_begin, m_end);
+    }
+
+private:
+    const int *m_begin;
+    const int *m_end;
+};
+
+#endif /* IDLETIMEOUTLIST_H */
@@ -0,0 +1,73 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idletimerstrategy.h"
+
+#include <cstdlib>
+#include <strings.h>
+
+namespace
+{
+
+const char *const StrategyNames[] = {"qt", "gcd", "timerfd", "thread"};
+
+}
+
+IdleTimerStrategy idleTimerStrategyFromName(const char *name, IdleTimerStrategy fallback)
+{
+    if (!name) {
+        return fallback;
+    }
+    for (int i = QtTimerStrategy; i <= ThreadStrategy; ++i) {
+        if (strcasecmp(name, StrategyNames[i]) == 0) {
+            return IdleTimerStrategy(i);
+        }
+    }
+    return fallback;
+}
+
+const char *idleTimerStrategyName(IdleTimerStrategy strategy)
+{
+    return StrategyNames[strategy];
+}
+
+IdleTimerStrategy idleTimerStrategyFromEnvironment(IdleTimerStrategy fallback)
+{
+    const IdleTimerStrategy strategy = idleTimerStrategyFromName(getenv("KIDLETIME_TIMER_STRATEGY"), fallback);
+    return idleTimerStrategyAvailable(strategy) ? strategy : fallback;
+}
+
+bool idleTimerStrategyAvailable(IdleTimerStrategy strategy)
+{
+    switch (strategy) {
+    case GcdTimerStrategy:
+#ifdef __APPLE__
+        return true;
+#else
+        return false;
+#endif
+    case TimerFdStrategy:
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return true;
+    }
+}
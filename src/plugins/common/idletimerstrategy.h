@@ -0,0 +1,64 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLETIMERSTRATEGY_H
+#define IDLETIMERSTRATEGY_H
+
+/**
+ * what wakes up the idle-timeout engine of a poller (@see IdleDetector).
+ */
+enum IdleTimerStrategy {
+    /**
+     * a QTimer on the owner's thread, re-armed adaptively (LocalIdleDetector)
+     */
+    QtTimerStrategy,
+    /**
+     * a GCD timer source on the main queue, armed for absolute deadlines with leeway
+     * (LocalIdleDetector, OS X only)
+     */
+    GcdTimerStrategy,
+    /**
+     * a timerfd armed for absolute deadlines, in the owner's event loop (LocalIdleDetector,
+     * Linux only)
+     */
+    TimerFdStrategy,
+    /**
+     * a detection thread waiting on a condition variable for the next deadline
+     * (ThreadedIdleDetector)
+     */
+    ThreadStrategy
+};
+
+/**
+ * @returns the strategy called @p name ("qt", "gcd", "timerfd" or "thread", case-insensitive),
+ * or @p fallback when the name is unknown or null.
+ */
+IdleTimerStrategy idleTimerStrategyFromName(const char *name, IdleTimerStrategy fallback);
+const char *idleTimerStrategyName(IdleTimerStrategy strategy);
+/**
+ * @returns the strategy named by the KIDLETIME_TIMER_STRATEGY environment variable if it
+ * is available on this platform, @p fallback otherwise.
+ */
+IdleTimerStrategy idleTimerStrategyFromEnvironment(IdleTimerStrategy fallback);
+/**
+ * @returns true if @p strategy can be used on this platform (the plugin still has to
+ * support it).
+ */
+bool idleTimerStrategyAvailable(IdleTimerStrategy strategy);
+
+#endif /* IDLETIMERSTRATEGY_H */
@@ -0,0 +1,172 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "idletracesimulator.h"
+#include "activitytrace.h"
+#include "idletimeoutengine.h"
+#include "virtualclock.h"
+
+#include <cstring>
+
+namespace
+{
+
+const int64_t LatenessBuckets = 60001;
+
+class SimulatorListener : public IdleEventListener
+{
+public:
+    void timeoutReached(int msecs)
+    {
+        reached(msecs);
+        // as a KIdleTime client would, in order to learn about the end of the idle period
+        engine->catchIdleEvent();
+    }
+
+    void resumingFromIdle() {}
+
+    std::function<void(int)> reached;
+    IdleTimeoutEngine *engine;
+};
+
+}
+
+IdleTraceSimulator::IdleTraceSimulator(Policy policy, const std::vector<int> &thresholds, int resolution)
+    : m_policy(policy)
+    , m_thresholds(thresholds)
+    , m_resolution(resolution)
+    , m_lateness(LatenessBuckets, 0)
+{
+    memset(&m_report, 0, sizeof(m_report));
+}
+
+void IdleTraceSimulator::replay(ActivityTraceReader &trace, int64_t tail)
+{
+    if (!trace.isValid()) {
+        return;
+    }
+    trace.rewind();
+    const int64_t origin = trace.origin();
+    VirtualClock clock(origin);
+    VirtualIdleSource source(&clock);
+    // QTimers repeat, GCD timer sources are single-shot
+    VirtualTimer timer(&clock, m_policy == DeadlineTimer);
+    SimulatorListener listener;
+    IdleTimeoutEngine engine(&source, &timer, &listener, &clock);
+    listener.engine = &engine;
+    // the trace feeds every activity to the engine
+    engine.setActivityEventsAvailable(true);
+    timer.setCallback([&engine]() { engine.timerFired(); });
+    if (m_policy == DeadlineTimer) {
+        engine.setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+    } else if (m_policy == FixedPolling) {
+        engine.setPollResolution(m_resolution);
+    }
+
+    int64_t lastActivity = origin;
+    listener.reached = [&](int msecs) {
+        const int64_t lateness = clock.now() - (lastActivity + msecs);
+        if (lateness < 0) {
+            ++m_report.spurious;
+        } else {
+            ++m_report.detected;
+            recordLateness(lateness);
+        }
+    };
+    for (int msecs : m_thresholds) {
+        engine.addTimeout(msecs);
+    }
+
+    const auto idlePeriod = [&](int64_t length) {
+        for (int msecs : m_thresholds) {
+            if (msecs <= length) {
+                ++m_report.expected;
+            }
+        }
+    };
+    int64_t timestamp;
+    while (trace.next(timestamp)) {
+        // the timers due up to (and at) the activity expire first
+        clock.advanceTo(timestamp);
+        idlePeriod(timestamp - lastActivity);
+        source.userActivity();
+        engine.activityAt(timestamp);
+        lastActivity = timestamp;
+        ++m_report.activities;
+    }
+    clock.advanceTo(lastActivity + tail);
+    idlePeriod(tail);
+
+    m_report.timerWakeups += timer.expirations();
+    m_report.timerArms += timer.starts();
+    m_report.idleQueries += source.queries();
+    m_report.simulatedTime += lastActivity + tail - origin;
+}
+
+void IdleTraceSimulator::recordLateness(int64_t lateness)
+{
+    ++m_lateness[size_t(lateness < LatenessBuckets - 1 ? lateness : LatenessBuckets - 1)];
+}
+
+int64_t IdleTraceSimulator::percentile(double fraction) const
+{
+    int64_t total = 0;
+    for (int64_t count : m_lateness) {
+        total += count;
+    }
+    if (!total) {
+        return 0;
+    }
+    const int64_t rank = int64_t(fraction * (total - 1));
+    int64_t seen = 0;
+    for (size_t i = 0; i < m_lateness.size(); ++i) {
+        seen += m_lateness[i];
+        if (seen > rank) {
+            return int64_t(i);
+        }
+    }
+    return LatenessBuckets - 1;
+}
+
+IdleTraceSimulator::Report IdleTraceSimulator::report() const
+{
+    Report report = m_report;
+    report.latenessP50 = percentile(0.5);
+    report.latenessP90 = percentile(0.9);
+    report.latenessP99 = percentile(0.99);
+    report.latenessMax = percentile(1.0);
+    return report;
+}
+
+IdleTraceSimulator::Policy IdleTraceSimulator::policy() const
+{
+    return m_policy;
+}
+
+const char *IdleTraceSimulator::policyName(Policy policy)
+{
+    switch (policy) {
+    case AdaptivePolling:
+        return "adaptive";
+    case DeadlineTimer:
+        return "deadline";
+    case FixedPolling:
+        return "fixed";
+    }
+    return "";
+}
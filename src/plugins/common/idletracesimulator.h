@@ -0,0 +1,106 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef IDLETRACESIMULATOR_H
+#define IDLETRACESIMULATOR_H
+
+#include <stdint.h>
+
+#include <vector>
+
+class ActivityTraceReader;
+
+/**
+ * Replays activity traces (@see ActivityTraceReader) through an IdleTimeoutEngine in virtual
+ * time, in order to compare detection policies on real user behaviour:
+ * - AdaptivePolling: a repeating timer re-armed to the time left until the next timeout,
+ *   as OSXIdleDispatcher does with its QTimer (the "qt" timer strategy);
+ * - DeadlineTimer: a single-shot timer armed once per deadline, as OSXIdleDispatcher does
+ *   with its GCD source ("gcd") or its detection thread ("thread");
+ * - FixedPolling: a repeating timer at a fixed resolution.
+ * In all cases the activity reaches the engine through activityAt(), as it does from the
+ * plugins' event filters, and the client is assumed to ask for the next resume event after
+ * each timeout (KIdleTime::catchNextResumeEvent()).
+ *
+ * For each idle period of the trace the simulator knows when every threshold should have
+ * been detected, and compares that with the time the engine reported it. Several traces
+ * can be replayed in a row; the report accumulates over all of them.
+ */
+class IdleTraceSimulator
+{
+public:
+    enum Policy {
+        AdaptivePolling,
+        DeadlineTimer,
+        FixedPolling
+    };
+
+    struct Report {
+        /**
+         * threshold crossings in the traces, and how many of them were reported
+         */
+        int64_t expected;
+        int64_t detected;
+        /**
+         * reports of a threshold that hadn't been crossed (never expected to happen)
+         */
+        int64_t spurious;
+        int64_t timerWakeups;
+        int64_t timerArms;
+        int64_t idleQueries;
+        int64_t activities;
+        int64_t simulatedTime;
+        /**
+         * detection lateness percentiles, in milliseconds
+         */
+        int64_t latenessP50;
+        int64_t latenessP90;
+        int64_t latenessP99;
+        int64_t latenessMax;
+    };
+
+    /**
+     * @param thresholds : the idle timeouts registered during the replay
+     * @param resolution : the interval of FixedPolling, in milliseconds
+     */
+    IdleTraceSimulator(Policy policy, const std::vector<int> &thresholds, int resolution = 1000);
+
+    /**
+     * replays @p trace from its start with a fresh engine, and @p tail milliseconds of
+     * inactivity after its last record.
+     */
+    void replay(ActivityTraceReader &trace, int64_t tail = 0);
+    Report report() const;
+    Policy policy() const;
+    static const char *policyName(Policy policy);
+
+private:
+    void recordLateness(int64_t lateness);
+    int64_t percentile(double fraction) const;
+
+    Policy m_policy;
+    std::vector<int> m_thresholds;
+    int m_resolution;
+    Report m_report;
+    /**
+     * lateness histogram with 1ms buckets; the last one collects everything beyond
+     */
+    std::vector<int64_t> m_lateness;
+};
+
+#endif /* IDLETRACESIMULATOR_H */
@@ -0,0 +1,239 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef INLINEARRAY_H
+#define INLINEARRAY_H
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <iterator>
+
+/**
+ * A growable array that keeps its first @p N elements inside the object, so that small
+ * sets never touch the heap. Past @p N the elements move to a heap buffer, which is kept
+ * (like a std::vector's) until the array is destroyed.
+ *
+ * It offers the part of the std::vector interface the engine uses, with pointers as
+ * iterators. Meant for small value types: elements are copied with assignments, and the
+ * unused slots are default-constructed.
+ */
+template<typename T, size_t N>
+class InlineArray
+{
+public:
+    typedef T value_type;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+
+    InlineArray()
+        : m_data(m_inline)
+        , m_size(0)
+        , m_capacity(N)
+    {
+    }
+
+    InlineArray(const InlineArray &other)
+        : m_data(m_inline)
+        , m_size(0)
+        , m_capacity(N)
+    {
+        assign(other.begin(), other.end());
+    }
+
+    ~InlineArray()
+    {
+        if (m_data != m_inline) {
+            delete[] m_data;
+        }
+    }
+
+    InlineArray &operator=(const InlineArray &other)
+    {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    iterator begin()
+    {
+        return m_data;
+    }
+    const_iterator begin() const
+    {
+        return m_data;
+    }
+    iterator end()
+    {
+        return m_data + m_size;
+    }
+    const_iterator end() const
+    {
+        return m_data + m_size;
+    }
+    T *data()
+    {
+        return m_data;
+    }
+    const T *data() const
+    {
+        return m_data;
+    }
+    size_t size() const
+    {
+        return m_size;
+    }
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+    T &operator[](size_t index)
+    {
+        return m_data[index];
+    }
+    const T &operator[](size_t index) const
+    {
+        return m_data[index];
+    }
+    T &front()
+    {
+        return m_data[0];
+    }
+    const T &front() const
+    {
+        return m_data[0];
+    }
+    T &back()
+    {
+        return m_data[m_size - 1];
+    }
+    const T &back() const
+    {
+        return m_data[m_size - 1];
+    }
+
+    void clear()
+    {
+        m_size = 0;
+    }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity > m_capacity) {
+            grow(capacity);
+        }
+    }
+
+    void push_back(const T &value)
+    {
+        if (m_size == m_capacity) {
+            // @p value may live in this array
+            const T copy = value;
+            grow(2 * m_capacity);
+            m_data[m_size++] = copy;
+        } else {
+            m_data[m_size++] = value;
+        }
+    }
+
+    void pop_back()
+    {
+        --m_size;
+    }
+
+    iterator insert(iterator position, const T &value)
+    {
+        const size_t index = position - m_data;
+        const T copy = value;
+        if (m_size == m_capacity) {
+            grow(2 * m_capacity);
+        }
+        std::copy_backward(m_data + index, m_data + m_size, m_data + m_size + 1);
+        m_data[index] = copy;
+        ++m_size;
+        return m_data + index;
+    }
+
+    iterator erase(iterator position)
+    {
+        std::copy(position + 1, end(), position);
+        --m_size;
+        return position;
+    }
+
+    /**
+     * replaces the contents with [@p first, @p last), which must not be part of this array.
+     */
+    template<typename Iterator>
+    void assign(Iterator first, Iterator last)
+    {
+        const size_t count = std::distance(first, last);
+        m_size = 0;
+        reserve(count);
+        std::copy(first, last, m_data);
+        m_size = count;
+    }
+
+    /**
+     * exchanges the heap buffers and the inline elements, without allocating.
+     */
+    void swap(InlineArray &other)
+    {
+        const bool inlined = m_data == m_inline;
+        const bool otherInlined = other.m_data == other.m_inline;
+        if (inlined && otherInlined) {
+            std::swap_ranges(m_inline, m_inline + std::max(m_size, other.m_size), other.m_inline);
+        } else if (inlined) {
+            std::copy(m_inline, m_inline + m_size, other.m_inline);
+            m_data = other.m_data;
+            other.m_data = other.m_inline;
+        } else if (otherInlined) {
+            std::copy(other.m_inline, other.m_inline + other.m_size, m_inline);
+            other.m_data = m_data;
+            m_data = m_inline;
+        } else {
+            std::swap(m_data, other.m_data);
+        }
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+private:
+    void grow(size_t capacity)
+    {
+        T *data = new T[capacity];
+        std::copy(m_data, m_data + m_size, data);
+        if (m_data != m_inline) {
+            delete[] m_data;
+        }
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    T m_inline[N];
+    T *m_data;
+    size_t m_size;
+    size_t m_capacity;
+};
+
+#endif /* INLINEARRAY_H */
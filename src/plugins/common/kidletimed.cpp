@@ -0,0 +1,85 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+/*
+ * kidletimed: the session's idle daemon (@see IdleDaemon). It reads the input devices
+ * through evdev, so it works under any display server (or none); the user running it
+ * needs read access to /dev/input/event*.
+ *
+ *     kidletimed [socket path]
+ */
+
+#include "activityfilter.h"
+#include "evdevactivitysource.h"
+#include "idledaemon.h"
+#include "idlesharedpage.h"
+#include "monotonicclock.h"
+
+#include <csignal>
+#include <cstdio>
+
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+int main(int argc, char **argv)
+{
+    const std::string path = argc > 1 ? std::string(argv[1]) : idleDaemonSocketPath();
+    if (path.empty()) {
+        fprintf(stderr, "kidletimed: XDG_RUNTIME_DIR is not set; pass the socket path or set KIDLETIME_DAEMON_SOCKET\n");
+        return 1;
+    }
+
+    MonotonicClock clock;
+    EvdevActivitySource source(&clock);
+    if (source.openDevices() == 0) {
+        fprintf(stderr, "kidletimed: could not open any input device in /dev/input\n");
+        return 1;
+    }
+
+    IdleDaemon daemon(&source, &clock);
+    ActivityFilter filter(daemon.engine(), &clock);
+    source.setActivityFilter(&filter);
+    // resuming from idle is seen as it happens, without sampling
+    daemon.engine()->setActivityEventsAvailable(true);
+    if (!daemon.listen(path)) {
+        fprintf(stderr, "kidletimed: cannot listen on %s (is another kidletimed running?)\n", path.c_str());
+        return 1;
+    }
+    // clients that only want the idle time read it from the shared page
+    IdleSharedPage *page = IdleSharedPage::create();
+    daemon.setSharedPage(page);
+    daemon.publishActivity(source.lastActivity());
+    daemon.watch(source.epollFd(), [&source, &daemon]() {
+        source.dispatch();
+        daemon.publishActivity(source.lastActivity());
+    });
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, 0);
+    const int signalFd = signalfd(-1, &signals, SFD_CLOEXEC);
+    daemon.watch(signalFd, [&daemon]() { daemon.quit(); });
+
+    daemon.exec();
+    daemon.setSharedPage(0);
+    delete page;
+    close(signalFd);
+    return 0;
+}
@@ -0,0 +1,194 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "localidledetector.h"
+
+void LocalIdleDetector::GatedTimer::start(int64_t msecs)
+{
+    if (open) {
+        timer->start(msecs);
+    }
+}
+
+void LocalIdleDetector::GatedTimer::startAt(int64_t deadline, int64_t now, int64_t slack)
+{
+    if (open) {
+        timer->startAt(deadline, now, slack);
+    }
+}
+
+void LocalIdleDetector::GatedTimer::stop()
+{
+    timer->stop();
+}
+
+bool LocalIdleDetector::GatedTimer::isActive() const
+{
+    return open && timer->isActive();
+}
+
+int64_t LocalIdleDetector::GatedTimer::interval() const
+{
+    return timer->interval();
+}
+
+LocalIdleDetector::LocalIdleDetector(IdleTimeSource *source, IdleTimer *timer, IdleEventListener *listener,
+                                     IdleClock *clock, IdleTimeoutEngine::SchedulingMode mode)
+    : m_engine(source, &m_timer, listener, clock)
+    , m_mode(mode)
+{
+    m_timer.timer = timer;
+    m_timer.open = false;
+    if (!m_engine.setSchedulingMode(m_mode)) {
+        m_mode = IdleTimeoutEngine::AdaptiveScheduling;
+    }
+}
+
+LocalIdleDetector::~LocalIdleDetector()
+{
+    stop();
+}
+
+void LocalIdleDetector::timerFired()
+{
+    if (m_timer.open) {
+        m_engine.timerFired();
+    }
+}
+
+IdleTimeoutEngine *LocalIdleDetector::engine()
+{
+    return &m_engine;
+}
+
+void LocalIdleDetector::setWakeUp(const std::function<void()> &)
+{
+}
+
+void LocalIdleDetector::start()
+{
+    if (m_timer.open) {
+        return;
+    }
+    m_timer.open = true;
+    m_engine.reset();
+    m_engine.forcePollRequest();
+}
+
+void LocalIdleDetector::stop()
+{
+    if (!m_timer.open) {
+        return;
+    }
+    m_timer.stop();
+    m_timer.open = false;
+}
+
+bool LocalIdleDetector::isRunning() const
+{
+    return m_timer.open;
+}
+
+void LocalIdleDetector::addTimeout(int msecs)
+{
+    m_engine.addTimeout(msecs);
+}
+
+void LocalIdleDetector::removeTimeout(int msecs)
+{
+    m_engine.removeTimeout(msecs);
+}
+
+IdleTimeoutList LocalIdleDetector::timeouts() const
+{
+    return m_engine.timeouts();
+}
+
+void LocalIdleDetector::catchIdleEvent()
+{
+    m_engine.catchIdleEvent();
+}
+
+void LocalIdleDetector::stopCatchingIdleEvents()
+{
+    m_engine.stopCatchingIdleEvents();
+}
+
+void LocalIdleDetector::simulateUserActivity()
+{
+    m_engine.simulateUserActivity();
+}
+
+void LocalIdleDetector::activityAt(int64_t time)
+{
+    m_engine.activityAt(time);
+}
+
+void LocalIdleDetector::setPollResolution(int msecs)
+{
+    if (msecs >= 0) {
+        m_engine.setPollResolution(msecs);
+    } else {
+        m_engine.setSchedulingMode(m_mode);
+    }
+}
+
+void LocalIdleDetector::setLatenessBudget(int msecs)
+{
+    m_engine.setLatenessBudget(msecs);
+}
+
+void LocalIdleDetector::setLatenessBudget(int timeout, int msecs)
+{
+    m_engine.setLatenessBudget(timeout, msecs);
+}
+
+void LocalIdleDetector::setSuspendPolicy(IdleTimeoutEngine::SuspendPolicy policy)
+{
+    m_engine.setSuspendPolicy(policy);
+}
+
+void LocalIdleDetector::systemResumed()
+{
+    m_engine.systemResumed();
+}
+
+void LocalIdleDetector::setActivityEventsAvailable(bool available)
+{
+    m_engine.setActivityEventsAvailable(available);
+}
+
+void LocalIdleDetector::setResumeLatency(int msecs)
+{
+    m_engine.setResumeLatency(msecs);
+}
+
+int LocalIdleDetector::forcePollRequest()
+{
+    return m_engine.forcePollRequest();
+}
+
+int LocalIdleDetector::deliverEvents()
+{
+    return 0;
+}
+
+IdleStatistics &LocalIdleDetector::statistics()
+{
+    return m_engine.statistics();
+}
@@ -0,0 +1,109 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef LOCALIDLEDETECTOR_H
+#define LOCALIDLEDETECTOR_H
+
+#include "idlebackend.h"
+#include "idledetector.h"
+#include "idletimeoutengine.h"
+
+/**
+ * Runs an IdleTimeoutEngine on the owner's thread, woken up by an IdleTimer of the owner's
+ * choosing (a QTimer, a GCD timer source, a timerfd, ...). The owner calls timerFired() when
+ * that timer expires; the listener is called synchronously, from the engine.
+ *
+ * While the detector is stopped the timer is never started, so that the owner can stop
+ * detecting without forgetting the registrations.
+ */
+class LocalIdleDetector : public IdleDetector
+{
+public:
+    /**
+     * @param timer : the timer that wakes up the engine; not owned
+     * @param clock : required by DeadlineScheduling and the lateness budgets; may be null
+     * @param mode : the scheduling mode that suits @p timer, also restored by
+     * setPollResolution(-1)
+     */
+    LocalIdleDetector(IdleTimeSource *source, IdleTimer *timer, IdleEventListener *listener,
+                      IdleClock *clock,
+                      IdleTimeoutEngine::SchedulingMode mode = IdleTimeoutEngine::AdaptiveScheduling);
+    ~LocalIdleDetector();
+
+    /**
+     * to be called each time the timer expires.
+     */
+    void timerFired();
+    IdleTimeoutEngine *engine();
+
+    // the events are delivered as they are detected: there is nothing to wake up
+    void setWakeUp(const std::function<void()> &wakeUp);
+    /**
+     * starts the detection from a fresh sample of the idle time.
+     */
+    void start();
+    /**
+     * stops the timer. The detection state is only forgotten at the next start(), so this
+     * may be called from the listener.
+     */
+    void stop();
+    bool isRunning() const;
+
+    void addTimeout(int msecs);
+    void removeTimeout(int msecs);
+    IdleTimeoutList timeouts() const;
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+    void simulateUserActivity();
+    void activityAt(int64_t time);
+
+    void setPollResolution(int msecs);
+    void setLatenessBudget(int msecs);
+    void setLatenessBudget(int timeout, int msecs);
+    void setSuspendPolicy(IdleTimeoutEngine::SuspendPolicy policy);
+    void systemResumed();
+    void setActivityEventsAvailable(bool available);
+    void setResumeLatency(int msecs);
+
+    int forcePollRequest();
+    int deliverEvents();
+    IdleStatistics &statistics();
+
+private:
+    /**
+     * passes the engine's requests on to the owner's timer while the detector is running.
+     */
+    class GatedTimer : public IdleTimer
+    {
+    public:
+        void start(int64_t msecs);
+        void startAt(int64_t deadline, int64_t now, int64_t slack);
+        void stop();
+        bool isActive() const;
+        int64_t interval() const;
+
+        IdleTimer *timer;
+        bool open;
+    };
+
+    GatedTimer m_timer;
+    IdleTimeoutEngine m_engine;
+    IdleTimeoutEngine::SchedulingMode m_mode;
+};
+
+#endif /* LOCALIDLEDETECTOR_H */
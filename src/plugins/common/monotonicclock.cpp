@@ -0,0 +1,66 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "monotonicclock.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#include <time.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#endif
+
+int64_t MonotonicClock::now()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t MonotonicClock::suspendedTime()
+{
+#if defined(__linux__)
+    // truncated once, from the difference in nanoseconds; the two reads are still apart
+    timespec boot, monotonic;
+    clock_gettime(CLOCK_BOOTTIME, &boot);
+    clock_gettime(CLOCK_MONOTONIC, &monotonic);
+    const int64_t asleep = (int64_t(boot.tv_sec) - monotonic.tv_sec) * 1000000000 + (boot.tv_nsec - monotonic.tv_nsec);
+    return std::max(asleep, int64_t(0)) / 1000000;
+#elif defined(__APPLE__)
+    // mach_continuous_time() appeared in 10.12; binaries built for older targets look it up
+    if (__builtin_available(macOS 10.12, *)) {
+        static mach_timebase_info_data_t timebase;
+        if (!timebase.denom) {
+            mach_timebase_info(&timebase);
+        }
+        // the absolute time is read last, so without a suspend the difference can be negative
+        const int64_t ticks = int64_t(mach_continuous_time()) - int64_t(mach_absolute_time());
+        if (ticks <= 0) {
+            return 0;
+        }
+        // in milliseconds before scaling, so that the multiplication cannot overflow
+        const int64_t msecs = ticks / 1000000;
+        const int64_t rest = ticks % 1000000;
+        return (msecs * timebase.numer + rest * timebase.numer / 1000000) / timebase.denom;
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,35 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef MONOTONICCLOCK_H
+#define MONOTONICCLOCK_H
+
+#include "idlebackend.h"
+
+/**
+ * The system's monotonic clock (CLOCK_MONOTONIC on Linux), in milliseconds. The time spent
+ * suspended is measured against CLOCK_BOOTTIME on Linux and mach_continuous_time() on OS X.
+ */
+class MonotonicClock : public IdleClock
+{
+public:
+    int64_t now();
+    int64_t suspendedTime();
+};
+
+#endif /* MONOTONICCLOCK_H */
@@ -0,0 +1,105 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <stddef.h>
+
+#include <atomic>
+#include <vector>
+
+/**
+ * A bounded, lock-free queue for exactly one producer thread and one consumer thread.
+ * The producer only writes m_tail and the consumer only writes m_head, so each side
+ * needs a single acquire load of the other's index and a release store of its own;
+ * the two indices live on separate cache lines.
+ *
+ * @tparam T : a copyable type; items are copied in and out of a ring of preallocated
+ * slots, so push() and pop() never allocate.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    /**
+     * @param capacity : rounded up to a power of two
+     */
+    explicit SpscQueue(size_t capacity)
+        : m_head(0)
+        , m_tail(0)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    /**
+     * producer side.
+     * @returns false if the queue is full.
+     */
+    bool push(const T &item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask) {
+            return false;
+        }
+        m_slots[tail & m_mask] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * consumer side.
+     * @returns false if the queue is empty.
+     */
+    bool pop(T &item)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * may be called from either side; the answer can be outdated by the time it returns.
+     */
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+    alignas(64) std::vector<T> m_slots;
+    size_t m_mask;
+};
+
+#endif /* SPSCQUEUE_H */
@@ -0,0 +1,471 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "threadedidledetector.h"
+#include "idletimeoutengine.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+
+/**
+ * how often the detection thread tries again to queue the coalesced events, in ms.
+ */
+const int64_t OverflowRetry = 10;
+
+}
+
+/**
+ * the engine's timer, idle time source and listener, all used on the detection thread.
+ */
+class ThreadedIdleDetector::Backend : public IdleTimeSource, public IdleTimer, public IdleEventListener
+{
+public:
+    bool queryIdleTime(int64_t &idle)
+    {
+        if (!detector->m_source->queryIdleTime(idle)) {
+            return false;
+        }
+        detector->m_lastIdle.store(idle, std::memory_order_relaxed);
+        return true;
+    }
+
+    void start(int64_t msecs)
+    {
+        detector->m_interval = msecs;
+        detector->m_deadline = detector->m_clock->now() + msecs;
+        detector->m_timerActive = true;
+    }
+
+    void startAt(int64_t deadline, int64_t now, int64_t slack)
+    {
+        // coalesced like a TimerFdIdleTimer, so that a budget lets the thread sleep longer
+        detector->m_interval = deadline - now;
+        detector->m_deadline = coalescedDeadline(deadline, slack);
+        detector->m_timerActive = true;
+    }
+
+    void stop()
+    {
+        detector->m_timerActive = false;
+    }
+
+    bool isActive() const
+    {
+        return detector->m_timerActive;
+    }
+
+    int64_t interval() const
+    {
+        return detector->m_interval;
+    }
+
+    void timeoutReached(int msecs)
+    {
+        detector->emitEvent(Event::TimeoutReached, msecs);
+    }
+
+    void resumingFromIdle()
+    {
+        detector->emitEvent(Event::ResumingFromIdle, 0);
+    }
+
+    ThreadedIdleDetector *detector;
+};
+
+ThreadedIdleDetector::ThreadedIdleDetector(IdleTimeSource *source, IdleEventListener *listener, IdleClock *clock)
+    : m_source(source)
+    , m_listener(listener)
+    , m_clock(clock)
+    , m_backend(new Backend)
+    , m_engine(0)
+    , m_timerActive(false)
+    , m_deadline(0)
+    , m_interval(0)
+    , m_commands(1024)
+    , m_events(256)
+    , m_running(false)
+    , m_wakeUpPending(false)
+    , m_lastIdle(0)
+    , m_polledIdle(0)
+    , m_pollsAnswered(0)
+    , m_coalescedEvents(0)
+    , m_pollsRequested(0)
+{
+    m_backend->detector = this;
+    m_engine = new IdleTimeoutEngine(m_backend, m_backend, m_backend, m_clock);
+    m_engine->setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+}
+
+ThreadedIdleDetector::~ThreadedIdleDetector()
+{
+    stop();
+    delete m_engine;
+    delete m_backend;
+}
+
+void ThreadedIdleDetector::setWakeUp(const std::function<void()> &wakeUp)
+{
+    m_wakeUp = wakeUp;
+}
+
+void ThreadedIdleDetector::start()
+{
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+    m_thread = std::thread(&ThreadedIdleDetector::run, this);
+}
+
+void ThreadedIdleDetector::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_commandPosted.notify_one();
+    m_thread.join();
+    Event event;
+    while (m_events.pop(event)) {
+    }
+    m_overflow.clear();
+    m_wakeUpPending = false;
+}
+
+bool ThreadedIdleDetector::isRunning() const
+{
+    return m_running;
+}
+
+void ThreadedIdleDetector::post(Command::Type type, int64_t value)
+{
+    Command command;
+    command.type = type;
+    command.value = value;
+    if (!m_running) {
+        // nobody else is using the engine, and nobody would drain the queue
+        execute(command);
+        return;
+    }
+    while (!m_commands.push(command)) {
+        // the detection thread is behind: let it catch up
+        m_commandPosted.notify_one();
+        std::this_thread::yield();
+    }
+    {
+        // taking the mutex orders the push before the detection thread's check for commands
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_commandPosted.notify_one();
+}
+
+void ThreadedIdleDetector::addTimeout(int msecs)
+{
+    std::vector<int>::iterator it = std::lower_bound(m_timeouts.begin(), m_timeouts.end(), msecs);
+    if (it != m_timeouts.end() && *it == msecs) {
+        return;
+    }
+    m_timeouts.insert(it, msecs);
+    post(Command::AddTimeout, msecs);
+}
+
+void ThreadedIdleDetector::removeTimeout(int msecs)
+{
+    std::vector<int>::iterator it = std::lower_bound(m_timeouts.begin(), m_timeouts.end(), msecs);
+    if (it == m_timeouts.end() || *it != msecs) {
+        return;
+    }
+    m_timeouts.erase(it);
+    post(Command::RemoveTimeout, msecs);
+}
+
+IdleTimeoutList ThreadedIdleDetector::timeouts() const
+{
+    return IdleTimeoutList(m_timeouts.data(), m_timeouts.size());
+}
+
+void ThreadedIdleDetector::catchIdleEvent()
+{
+    post(Command::CatchIdleEvent);
+}
+
+void ThreadedIdleDetector::stopCatchingIdleEvents()
+{
+    post(Command::StopCatchingIdleEvents);
+}
+
+void ThreadedIdleDetector::simulateUserActivity()
+{
+    post(Command::SimulateUserActivity);
+}
+
+void ThreadedIdleDetector::activityAt(int64_t time)
+{
+    post(Command::ActivityAt, time);
+}
+
+void ThreadedIdleDetector::setLatenessBudget(int msecs)
+{
+    post(Command::SetLatenessBudget, msecs);
+}
+
+void ThreadedIdleDetector::setLatenessBudget(int timeout, int msecs)
+{
+    post(Command::SetTimeoutLatenessBudget, int64_t(uint64_t(uint32_t(timeout)) << 32 | uint32_t(msecs)));
+}
+
+void ThreadedIdleDetector::setSuspendPolicy(IdleTimeoutEngine::SuspendPolicy policy)
+{
+    post(Command::SetSuspendPolicy, policy);
+}
+
+void ThreadedIdleDetector::systemResumed()
+{
+    post(Command::SystemResumed);
+}
+
+void ThreadedIdleDetector::setActivityEventsAvailable(bool available)
+{
+    post(Command::SetActivityEventsAvailable, available);
+}
+
+void ThreadedIdleDetector::setResumeLatency(int msecs)
+{
+    post(Command::SetResumeLatency, msecs);
+}
+
+void ThreadedIdleDetector::setPollResolution(int msecs)
+{
+    post(Command::SetPollResolution, msecs);
+}
+
+int ThreadedIdleDetector::forcePollRequest()
+{
+    if (!m_running) {
+        // nobody else is using the engine
+        return m_engine->forcePollRequest();
+    }
+    const uint64_t request = ++m_pollsRequested;
+    post(Command::ForcePollRequest, int64_t(request));
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const bool answered = m_pollAnswered.wait_for(lock, std::chrono::seconds(1), [this, request]() {
+        return m_pollsAnswered.load() >= request;
+    });
+    // rather than the answer to an earlier request
+    return answered ? int(m_polledIdle.load()) : -1;
+}
+
+int ThreadedIdleDetector::deliverEvents()
+{
+    return deliverEvents(std::function<void(const Event&)>());
+}
+
+int ThreadedIdleDetector::deliverEvents(const std::function<void(const Event&)> &handler)
+{
+    // cleared first, so that an event pushed while we drain triggers a new wake-up
+    m_wakeUpPending.store(false);
+    int count = 0;
+    Event event;
+    while (m_events.pop(event)) {
+        if (event.type == Event::TimeoutReached
+                && !std::binary_search(m_timeouts.begin(), m_timeouts.end(), event.msecs)) {
+            // removed while the event was in flight
+            continue;
+        }
+        ++count;
+        if (handler) {
+            handler(event);
+        }
+        if (event.type == Event::TimeoutReached) {
+            if (!m_reached.empty() && event.msecs <= m_reached.back()) {
+                // from another idle period (after simulateUserActivity())
+                deliverTimeouts();
+            }
+            m_reached.push_back(event.msecs);
+        } else {
+            deliverTimeouts();
+            m_listener->resumingFromIdle();
+        }
+    }
+    deliverTimeouts();
+    return count;
+}
+
+void ThreadedIdleDetector::deliverTimeouts()
+{
+    if (m_reached.size() == 1) {
+        m_listener->timeoutReached(m_reached.front());
+    } else if (!m_reached.empty()) {
+        m_listener->timeoutsReached(m_reached.data(), m_reached.size());
+    }
+    m_reached.clear();
+}
+
+int64_t ThreadedIdleDetector::lastIdleTime() const
+{
+    return m_lastIdle.load(std::memory_order_relaxed);
+}
+
+int64_t ThreadedIdleDetector::timerWakeups() const
+{
+    return m_engine->timerWakeups();
+}
+
+int64_t ThreadedIdleDetector::coalescedEvents() const
+{
+    return m_coalescedEvents.load(std::memory_order_relaxed);
+}
+
+IdleStatistics &ThreadedIdleDetector::statistics()
+{
+    return m_engine->statistics();
+}
+
+void ThreadedIdleDetector::run()
+{
+    while (m_running) {
+        Command command;
+        while (m_commands.pop(command)) {
+            execute(command);
+        }
+        if (m_timerActive && m_clock->now() >= m_deadline) {
+            m_timerActive = false;
+            m_engine->timerFired();
+            continue;
+        }
+
+        // the owner may have made room in the event queue
+        const bool flushed = flushOverflow();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const auto woken = [this]() { return !m_running || !m_commands.isEmpty(); };
+        if (m_timerActive || !flushed) {
+            int64_t remaining = m_timerActive ? m_deadline - m_clock->now() : OverflowRetry;
+            if (!flushed) {
+                remaining = std::min(remaining, OverflowRetry);
+            }
+            m_commandPosted.wait_for(lock, std::chrono::milliseconds(std::max(remaining, int64_t(0))), woken);
+        } else {
+            m_commandPosted.wait(lock, woken);
+        }
+    }
+    m_engine->reset();
+}
+
+void ThreadedIdleDetector::execute(const Command &command)
+{
+    switch (command.type) {
+    case Command::AddTimeout:
+        m_engine->addTimeout(int(command.value));
+        break;
+    case Command::RemoveTimeout:
+        m_engine->removeTimeout(int(command.value));
+        break;
+    case Command::CatchIdleEvent:
+        m_engine->catchIdleEvent();
+        break;
+    case Command::StopCatchingIdleEvents:
+        m_engine->stopCatchingIdleEvents();
+        break;
+    case Command::SimulateUserActivity:
+        m_engine->simulateUserActivity();
+        break;
+    case Command::ActivityAt:
+        m_engine->activityAt(command.value);
+        break;
+    case Command::SetLatenessBudget:
+        m_engine->setLatenessBudget(int(command.value));
+        break;
+    case Command::SetTimeoutLatenessBudget:
+        m_engine->setLatenessBudget(int32_t(uint64_t(command.value) >> 32), int32_t(uint32_t(command.value)));
+        break;
+    case Command::SetSuspendPolicy:
+        m_engine->setSuspendPolicy(IdleTimeoutEngine::SuspendPolicy(command.value));
+        break;
+    case Command::SystemResumed:
+        m_engine->systemResumed();
+        break;
+    case Command::SetActivityEventsAvailable:
+        m_engine->setActivityEventsAvailable(command.value != 0);
+        break;
+    case Command::SetResumeLatency:
+        m_engine->setResumeLatency(int(command.value));
+        break;
+    case Command::SetPollResolution:
+        if (command.value >= 0) {
+            m_engine->setPollResolution(int(command.value));
+        } else {
+            // rather than the engine's adaptive mode: this thread waits for deadlines
+            m_engine->setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+        }
+        break;
+    case Command::ForcePollRequest:
+        m_polledIdle.store(m_engine->forcePollRequest());
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pollsAnswered.store(uint64_t(command.value));
+        }
+        m_pollAnswered.notify_all();
+        break;
+    }
+}
+
+void ThreadedIdleDetector::emitEvent(Event::Type type, int msecs)
+{
+    Event event;
+    event.type = type;
+    event.msecs = msecs;
+    event.detectedAt = m_clock->now();
+    // behind the coalesced events, if any, to keep the order
+    if (!flushOverflow() || !m_events.push(event)) {
+        // the owner is not draining the queue: an earlier event of the same kind is superseded
+        for (std::vector<Event>::iterator it = m_overflow.begin(); it != m_overflow.end(); ++it) {
+            if (it->type == type && (type == Event::ResumingFromIdle || it->msecs == msecs)) {
+                m_overflow.erase(it);
+                m_coalescedEvents.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+        m_overflow.push_back(event);
+    }
+    if (!m_wakeUpPending.exchange(true) && m_wakeUp) {
+        m_wakeUp();
+    }
+}
+
+bool ThreadedIdleDetector::flushOverflow()
+{
+    if (m_overflow.empty()) {
+        return true;
+    }
+    size_t moved = 0;
+    while (moved < m_overflow.size() && m_events.push(m_overflow[moved])) {
+        ++moved;
+    }
+    m_overflow.erase(m_overflow.begin(), m_overflow.begin() + moved);
+    if (moved && !m_wakeUpPending.exchange(true) && m_wakeUp) {
+        m_wakeUp();
+    }
+    return m_overflow.empty();
+}
@@ -0,0 +1,244 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef THREADEDIDLEDETECTOR_H
+#define THREADEDIDLEDETECTOR_H
+
+#include "idlebackend.h"
+#include "idledetector.h"
+#include "idlestatistics.h"
+#include "idletimeoutengine.h"
+#include "spscqueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Runs an IdleTimeoutEngine on a detection thread of its own, so that detection stays
+ * on time when the owner's (GUI) thread is busy, without sharing any engine state between
+ * threads:
+ *
+ * - the owner's calls (addTimeout(), catchIdleEvent(), activityAt(), ...) are posted to the
+ *   detection thread through a lock-free single-producer/single-consumer command queue;
+ * - the engine's events travel back through a second SPSC queue. The detection thread then
+ *   calls the wake-up function set with setWakeUp() (at most once until the owner has drained
+ *   the queue), and the owner calls deliverEvents() on its own thread, which is where the
+ *   IdleEventListener is invoked.
+ *
+ * The detection thread never waits for the owner. When the owner does not drain the event
+ * queue and it fills up, the events that follow are coalesced on the detection thread: the
+ * latest event per timeout and a single resume are kept, in the order of their last
+ * occurrence, and are moved to the queue as soon as there is room (see coalescedEvents()).
+ * The owner, on the other hand, waits for the detection thread when the command queue is
+ * full, which is never for long since that thread does not block.
+ *
+ * The detection thread sleeps on a condition variable until the engine's next deadline
+ * (IdleTimeoutEngine::DeadlineScheduling) or until a command arrives. The idle time source
+ * and the clock are used from the detection thread only, except that the clock also
+ * timestamps the events for the owner; both must therefore be thread-safe.
+ *
+ * All public methods except lastIdleTime() must be called from the owner's thread.
+ */
+class ThreadedIdleDetector : public IdleDetector
+{
+public:
+    struct Event {
+        enum Type {
+            TimeoutReached,
+            ResumingFromIdle
+        };
+        Type type;
+        int msecs;
+        /**
+         * when the detection thread generated the event, on the clock
+         */
+        int64_t detectedAt;
+    };
+
+    ThreadedIdleDetector(IdleTimeSource *source, IdleEventListener *listener, IdleClock *clock);
+    ~ThreadedIdleDetector();
+
+    /**
+     * @param wakeUp : called from the detection thread when events are waiting; it should
+     * arrange for deliverEvents() to be called on the owner's thread (e.g. through a queued
+     * invocation). Must be set before start().
+     */
+    void setWakeUp(const std::function<void()> &wakeUp);
+    void start();
+    /**
+     * stops and joins the detection thread; pending events are discarded. The engine keeps
+     * its registrations, and until the next start() the calls are executed right away on
+     * the owner's thread.
+     */
+    void stop();
+    bool isRunning() const;
+
+    void addTimeout(int msecs);
+    void removeTimeout(int msecs);
+    /**
+     * @returns the registered timeouts, in ascending order, as the owner requested them.
+     */
+    IdleTimeoutList timeouts() const;
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+    void simulateUserActivity();
+    void activityAt(int64_t time);
+    /**
+     * @see IdleTimeoutEngine::setLatenessBudget()
+     */
+    void setLatenessBudget(int msecs);
+    void setLatenessBudget(int timeout, int msecs);
+    /**
+     * @see IdleTimeoutEngine::setSuspendPolicy(); the clock has to be able to tell the
+     * time spent suspended.
+     */
+    void setSuspendPolicy(IdleTimeoutEngine::SuspendPolicy policy);
+    /**
+     * @see IdleTimeoutEngine::systemResumed()
+     */
+    void systemResumed();
+    /**
+     * @see IdleTimeoutEngine::setActivityEventsAvailable()
+     */
+    void setActivityEventsAvailable(bool available);
+    /**
+     * @see IdleTimeoutEngine::setResumeLatency()
+     */
+    void setResumeLatency(int msecs);
+    /**
+     * polls every @p msecs milliseconds on the detection thread, or (-1) goes back to
+     * waiting for the engine's next deadline.
+     */
+    void setPollResolution(int msecs);
+    /**
+     * has the detection thread poll the idle time, and waits for the answer.
+     * @returns the idle time, or -1 if the detection thread did not answer within a second.
+     */
+    int forcePollRequest();
+
+    /**
+     * calls the listener for each pending event. Consecutive timeouts, in ascending order,
+     * are passed to IdleEventListener::timeoutsReached() together.
+     * @returns the number of events delivered.
+     */
+    int deliverEvents();
+    /**
+     * @param handler : called with each event before the listener (e.g. to measure the
+     * delivery latency)
+     */
+    int deliverEvents(const std::function<void(const Event&)> &handler);
+
+    /**
+     * @returns the idle time seen by the last poll of the detection thread; callable
+     * from any thread.
+     */
+    int64_t lastIdleTime() const;
+    /**
+     * @returns how many times the detection thread woke up because of its deadline.
+     */
+    int64_t timerWakeups() const;
+    /**
+     * @returns how many events were superseded by a later one of the same kind while the
+     * event queue was full; callable from any thread.
+     */
+    int64_t coalescedEvents() const;
+    /**
+     * @returns the statistics of the engine running on the detection thread, which can be
+     * read and reset from any thread.
+     */
+    IdleStatistics &statistics();
+
+private:
+    struct Command {
+        enum Type {
+            AddTimeout,
+            RemoveTimeout,
+            CatchIdleEvent,
+            StopCatchingIdleEvents,
+            SimulateUserActivity,
+            ActivityAt,
+            ForcePollRequest,
+            SetLatenessBudget,
+            /**
+             * the timeout in the upper, the budget in the lower 32 bits of the value
+             */
+            SetTimeoutLatenessBudget,
+            SetSuspendPolicy,
+            SystemResumed,
+            SetActivityEventsAvailable,
+            SetResumeLatency,
+            SetPollResolution
+        };
+        Type type;
+        int64_t value;
+    };
+    class Backend;
+    friend class Backend;
+
+    void post(Command::Type type, int64_t value = 0);
+    void run();
+    void execute(const Command &command);
+    void emitEvent(Event::Type type, int msecs);
+    /**
+     * moves the coalesced events to the event queue as far as there is room.
+     * @returns true if none is left.
+     */
+    bool flushOverflow();
+    void deliverTimeouts();
+
+    IdleTimeSource *m_source;
+    IdleEventListener *m_listener;
+    IdleClock *m_clock;
+    std::function<void()> m_wakeUp;
+    std::vector<int> m_timeouts;
+    /**
+     * the timeouts being collected by deliverEvents().
+     */
+    std::vector<int> m_reached;
+
+    // detection thread only
+    Backend *m_backend;
+    IdleTimeoutEngine *m_engine;
+    bool m_timerActive;
+    int64_t m_deadline;
+    int64_t m_interval;
+    /**
+     * the events that did not fit in the queue, at most one per timeout and one resume.
+     */
+    std::vector<Event> m_overflow;
+
+    SpscQueue<Command> m_commands;
+    SpscQueue<Event> m_events;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_commandPosted;
+    std::condition_variable m_pollAnswered;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_wakeUpPending;
+    std::atomic<int64_t> m_lastIdle;
+    std::atomic<int64_t> m_polledIdle;
+    std::atomic<uint64_t> m_pollsAnswered;
+    std::atomic<int64_t> m_coalescedEvents;
+    uint64_t m_pollsRequested;
+};
+
+#endif /* THREADEDIDLEDETECTOR_H */
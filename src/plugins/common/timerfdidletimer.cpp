@@ -0,0 +1,169 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "timerfdidletimer.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace
+{
+
+int64_t monotonicMicroseconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return int64_t(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+}
+
+TimerFdIdleTimer::TimerFdIdleTimer()
+    : m_fd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC))
+    , m_active(false)
+    , m_interval(0)
+    , m_deadline(0)
+    , m_expiry(0)
+{
+    resetStatistics();
+}
+
+TimerFdIdleTimer::~TimerFdIdleTimer()
+{
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+int TimerFdIdleTimer::fd() const
+{
+    return m_fd;
+}
+
+void TimerFdIdleTimer::start(int64_t msecs)
+{
+    const int64_t now = monotonicMicroseconds() / 1000;
+    startAt(now + msecs, now, 0);
+}
+
+void TimerFdIdleTimer::startAt(int64_t deadline, int64_t now, int64_t slack)
+{
+    const int64_t expiry = coalescedDeadline(deadline, slack);
+    m_interval = deadline - now;
+    m_deadline = deadline;
+    m_expiry = expiry;
+
+    itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (expiry > 0) {
+        spec.it_value.tv_sec = expiry / 1000;
+        spec.it_value.tv_nsec = long(expiry % 1000) * 1000000;
+    } else {
+        // a zero it_value would disarm the timer; anything in the past expires at once
+        spec.it_value.tv_nsec = 1;
+    }
+    m_active = timerfd_settime(m_fd, TFD_TIMER_ABSTIME, &spec, 0) == 0;
+}
+
+void TimerFdIdleTimer::stop()
+{
+    if (!m_active) {
+        return;
+    }
+    itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    timerfd_settime(m_fd, 0, &spec, 0);
+    m_active = false;
+    // drop an expiration that happened before the disarm
+    uint64_t expirations;
+    while (read(m_fd, &expirations, sizeof(expirations)) < 0 && errno == EINTR) {
+    }
+}
+
+bool TimerFdIdleTimer::isActive() const
+{
+    return m_active;
+}
+
+int64_t TimerFdIdleTimer::interval() const
+{
+    return m_interval;
+}
+
+int64_t TimerFdIdleTimer::deadline() const
+{
+    return m_deadline;
+}
+
+int64_t TimerFdIdleTimer::expiry() const
+{
+    return m_expiry;
+}
+
+bool TimerFdIdleTimer::acknowledge()
+{
+    uint64_t expirations = 0;
+    ssize_t length;
+    do {
+        length = read(m_fd, &expirations, sizeof(expirations));
+    } while (length < 0 && errno == EINTR);
+    if (length != sizeof(expirations) || !expirations || !m_active) {
+        return false;
+    }
+    m_active = false;
+    const int64_t lateness = monotonicMicroseconds() - m_deadline * 1000;
+    m_lastLateness = lateness;
+    m_totalLateness += lateness;
+    if (lateness > m_maxLateness) {
+        m_maxLateness = lateness;
+    }
+    ++m_expirations;
+    return true;
+}
+
+int64_t TimerFdIdleTimer::expirations() const
+{
+    return m_expirations;
+}
+
+int64_t TimerFdIdleTimer::meanLateness() const
+{
+    return m_expirations ? m_totalLateness / m_expirations : 0;
+}
+
+int64_t TimerFdIdleTimer::maxLateness() const
+{
+    return m_maxLateness;
+}
+
+int64_t TimerFdIdleTimer::lastLateness() const
+{
+    return m_lastLateness;
+}
+
+void TimerFdIdleTimer::resetStatistics()
+{
+    m_expirations = 0;
+    m_totalLateness = 0;
+    m_maxLateness = 0;
+    m_lastLateness = 0;
+}
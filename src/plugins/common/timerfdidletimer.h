@@ -0,0 +1,94 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef TIMERFDIDLETIMER_H
+#define TIMERFDIDLETIMER_H
+
+#include "idlebackend.h"
+
+/**
+ * A single-shot IdleTimer on a Linux timerfd. Deadlines are programmed as absolute
+ * CLOCK_MONOTONIC times (TFD_TIMER_ABSTIME), so they do not drift with the time spent
+ * between computing an interval and arming the timer, and re-arming for the same deadline
+ * gives the same expiry. The engine's clock must therefore be a MonotonicClock.
+ *
+ * The descriptor (fd()) becomes readable on expiry; it goes into the owner's epoll set
+ * (or a QSocketNotifier), and the owner calls acknowledge() before IdleTimeoutEngine::timerFired().
+ *
+ * Slack: a timerfd has no leeway of its own (unlike a GCD timer source), so the timer uses it
+ * to round the expiry up to a multiple of the largest power-of-two number of milliseconds not
+ * exceeding the slack. Deadlines that are close together, here or in other processes doing
+ * the same, thus end up on the same instant and share a wake-up.
+ *
+ * Every expiry is compared with the requested deadline (not the rounded one), and the lateness
+ * statistics are kept in microseconds.
+ */
+class TimerFdIdleTimer : public IdleTimer
+{
+public:
+    TimerFdIdleTimer();
+    ~TimerFdIdleTimer();
+
+    /**
+     * @returns the timerfd, or -1 if it could not be created.
+     */
+    int fd() const;
+
+    void start(int64_t msecs);
+    void startAt(int64_t deadline, int64_t now, int64_t slack);
+    void stop();
+    bool isActive() const;
+    int64_t interval() const;
+    /**
+     * @returns the requested deadline and the programmed expiry time, in milliseconds on
+     * CLOCK_MONOTONIC; only meaningful when the timer is active.
+     */
+    int64_t deadline() const;
+    int64_t expiry() const;
+
+    /**
+     * reads the expiration from the descriptor.
+     * @returns true if the timer did expire (false for spurious wake-ups or after stop()).
+     */
+    bool acknowledge();
+
+    /**
+     * lateness of the expiries with respect to the requested deadlines, in microseconds.
+     */
+    int64_t expirations() const;
+    int64_t meanLateness() const;
+    int64_t maxLateness() const;
+    /**
+     * @returns the lateness of the last expiry.
+     */
+    int64_t lastLateness() const;
+    void resetStatistics();
+
+private:
+    int m_fd;
+    bool m_active;
+    int64_t m_interval;
+    int64_t m_deadline;
+    int64_t m_expiry;
+    int64_t m_expirations;
+    int64_t m_totalLateness;
+    int64_t m_maxLateness;
+    int64_t m_lastLateness;
+};
+
+#endif /* TIMERFDIDLETIMER_H */
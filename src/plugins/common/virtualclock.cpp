@@ -0,0 +1,194 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "virtualclock.h"
+
+#include <algorithm>
+
+VirtualClock::VirtualClock(int64_t start)
+    : m_now(start)
+    , m_suspended(0)
+{
+}
+
+int64_t VirtualClock::now()
+{
+    return m_now;
+}
+
+VirtualTimer *VirtualClock::nextDue(int64_t time) const
+{
+    VirtualTimer *due = 0;
+    for (VirtualTimer *timer : m_timers) {
+        if (timer->m_active && timer->m_deadline <= time
+                && (!due || timer->m_deadline < due->m_deadline)) {
+            due = timer;
+        }
+    }
+    return due;
+}
+
+int VirtualClock::advanceTo(int64_t time)
+{
+    int fired = 0;
+    while (VirtualTimer *timer = nextDue(time)) {
+        m_now = std::max(m_now, timer->m_deadline);
+        timer->expire();
+        ++fired;
+    }
+    m_now = std::max(m_now, time);
+    return fired;
+}
+
+int VirtualClock::advance(int64_t msecs)
+{
+    return advanceTo(m_now + msecs);
+}
+
+void VirtualClock::suspend(int64_t msecs)
+{
+    m_suspended += std::max(msecs, int64_t(0));
+}
+
+int64_t VirtualClock::suspendedTime()
+{
+    return m_suspended;
+}
+
+VirtualTimer::VirtualTimer(VirtualClock *clock, bool singleShot)
+    : m_clock(clock)
+    , m_interval(0)
+    , m_deadline(0)
+    , m_expirations(0)
+    , m_starts(0)
+    , m_singleShot(singleShot)
+    , m_active(false)
+{
+    m_clock->m_timers.push_back(this);
+}
+
+VirtualTimer::~VirtualTimer()
+{
+    std::vector<VirtualTimer*> &timers = m_clock->m_timers;
+    timers.erase(std::remove(timers.begin(), timers.end(), this), timers.end());
+}
+
+void VirtualTimer::setCallback(const std::function<void()> &callback)
+{
+    m_callback = callback;
+}
+
+void VirtualTimer::start(int64_t msecs)
+{
+    m_interval = std::max(msecs, int64_t(0));
+    m_deadline = m_clock->now() + m_interval;
+    m_active = true;
+    ++m_starts;
+}
+
+void VirtualTimer::startAt(int64_t deadline, int64_t now, int64_t slack)
+{
+    m_interval = std::max(deadline - now, int64_t(0));
+    m_deadline = std::max(coalescedDeadline(deadline, slack), now);
+    m_active = true;
+    ++m_starts;
+}
+
+void VirtualTimer::stop()
+{
+    m_active = false;
+}
+
+bool VirtualTimer::isActive() const
+{
+    return m_active;
+}
+
+int64_t VirtualTimer::interval() const
+{
+    return m_interval;
+}
+
+int64_t VirtualTimer::deadline() const
+{
+    return m_deadline;
+}
+
+int VirtualTimer::expirations() const
+{
+    return m_expirations;
+}
+
+int VirtualTimer::starts() const
+{
+    return m_starts;
+}
+
+void VirtualTimer::expire()
+{
+    ++m_expirations;
+    if (m_singleShot) {
+        m_active = false;
+    } else {
+        // a repeating timer with a zero interval would never let time advance
+        m_deadline += std::max(m_interval, int64_t(1));
+    }
+    if (m_callback) {
+        m_callback();
+    }
+}
+
+VirtualIdleSource::VirtualIdleSource(VirtualClock *clock)
+    : m_clock(clock)
+    , m_lastActivity(clock->now())
+    , m_suspendedAtActivity(clock->suspendedTime())
+    , m_queries(0)
+    , m_countsSuspendedTime(false)
+{
+}
+
+bool VirtualIdleSource::queryIdleTime(int64_t &idle)
+{
+    ++m_queries;
+    idle = m_clock->now() - m_lastActivity;
+    if (m_countsSuspendedTime) {
+        idle += m_clock->suspendedTime() - m_suspendedAtActivity;
+    }
+    return true;
+}
+
+void VirtualIdleSource::userActivity()
+{
+    m_lastActivity = m_clock->now();
+    m_suspendedAtActivity = m_clock->suspendedTime();
+}
+
+void VirtualIdleSource::setCountsSuspendedTime(bool counts)
+{
+    m_countsSuspendedTime = counts;
+}
+
+bool VirtualIdleSource::countsSuspendedTime() const
+{
+    return m_countsSuspendedTime;
+}
+
+int VirtualIdleSource::queries() const
+{
+    return m_queries;
+}
@@ -0,0 +1,148 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef VIRTUALCLOCK_H
+#define VIRTUALCLOCK_H
+
+#include "idlebackend.h"
+
+#include <functional>
+#include <vector>
+
+class VirtualTimer;
+
+/**
+ * A manually advanced clock for driving the IdleTimeoutEngine in virtual time,
+ * e.g. in benchmarks or when replaying user behaviour. Time only moves when
+ * advanceTo() or advance() is called; the VirtualTimers attached to the clock
+ * expire as their deadlines are passed.
+ */
+class VirtualClock : public IdleClock
+{
+public:
+    explicit VirtualClock(int64_t start = 0);
+
+    int64_t now();
+    /**
+     * moves the clock to @p time, expiring the attached timers in deadline order
+     * on the way. Timers re-armed by their callbacks expire again if their new
+     * deadline is not beyond @p time.
+     * @returns the number of timer expirations.
+     */
+    int advanceTo(int64_t time);
+    int advance(int64_t msecs);
+    /**
+     * simulates a system suspend of @p msecs milliseconds: suspendedTime() grows, now()
+     * does not move and no timer expires.
+     */
+    void suspend(int64_t msecs);
+    int64_t suspendedTime();
+
+private:
+    friend class VirtualTimer;
+    VirtualTimer *nextDue(int64_t time) const;
+
+    int64_t m_now;
+    int64_t m_suspended;
+    std::vector<VirtualTimer*> m_timers;
+};
+
+/**
+ * An IdleTimer running on a VirtualClock. It can behave either like a QTimer
+ * (repeating) or like a GCD timer source (single-shot).
+ */
+class VirtualTimer : public IdleTimer
+{
+public:
+    VirtualTimer(VirtualClock *clock, bool singleShot = true);
+    ~VirtualTimer();
+
+    /**
+     * sets the function invoked on expiry, typically IdleTimeoutEngine::timerFired().
+     */
+    void setCallback(const std::function<void()> &callback);
+
+    void start(int64_t msecs);
+    /**
+     * honours the slack the way TimerFdIdleTimer does, so that the wake-ups saved by
+     * coalescing can be counted in virtual time.
+     */
+    void startAt(int64_t deadline, int64_t now, int64_t slack);
+    void stop();
+    bool isActive() const;
+    int64_t interval() const;
+    /**
+     * @returns the absolute expiry time; only meaningful when the timer is active.
+     */
+    int64_t deadline() const;
+    /**
+     * @returns the number of times the timer expired.
+     */
+    int expirations() const;
+    /**
+     * @returns the number of times the timer was (re)armed.
+     */
+    int starts() const;
+
+private:
+    friend class VirtualClock;
+    void expire();
+
+    VirtualClock *m_clock;
+    std::function<void()> m_callback;
+    int64_t m_interval,
+        m_deadline;
+    int m_expirations;
+    int m_starts;
+    bool m_singleShot;
+    bool m_active;
+};
+
+/**
+ * An IdleTimeSource on a VirtualClock: the idle time is the time elapsed since
+ * the last call to userActivity().
+ */
+class VirtualIdleSource : public IdleTimeSource
+{
+public:
+    explicit VirtualIdleSource(VirtualClock *clock);
+
+    bool queryIdleTime(int64_t &idle);
+    /**
+     * registers a (virtual) user input event at the current time.
+     */
+    void userActivity();
+    /**
+     * @returns the number of idle time queries made so far.
+     */
+    int queries() const;
+    /**
+     * whether the idle time includes the time the clock spent suspended (false by default).
+     */
+    void setCountsSuspendedTime(bool counts);
+    bool countsSuspendedTime() const;
+
+private:
+    VirtualClock *m_clock;
+    int64_t m_lastActivity;
+    int64_t m_suspendedAtActivity;
+    int m_queries;
+    bool m_countsSuspendedTime;
+};
+
+#endif /* VIRTUALCLOCK_H */
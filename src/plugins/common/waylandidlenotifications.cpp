@@ -0,0 +1,221 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "waylandidlenotifications.h"
+
+#include "ext-idle-notify-v1-client-protocol.h"
+
+#include <wayland-client.h>
+
+#include <algorithm>
+#include <cstring>
+
+const wl_registry_listener WaylandIdleNotifications::s_registryListener = {
+    &WaylandIdleNotifications::registryGlobal,
+    &WaylandIdleNotifications::registryGlobalRemove,
+};
+
+const ext_idle_notification_v1_listener WaylandIdleNotifications::s_notificationListener = {
+    &WaylandIdleNotifications::idled,
+    &WaylandIdleNotifications::resumed,
+};
+
+WaylandIdleNotifications::WaylandIdleNotifications(wl_display *display, IdleEventListener *listener, IdleClock *clock)
+    : m_display(display)
+    , m_tracker(listener, clock)
+    , m_notifier(0)
+    , m_seat(0)
+    , m_catchNotification(0)
+{
+}
+
+WaylandIdleNotifications::~WaylandIdleNotifications()
+{
+    for (Notification *notification : m_notifications) {
+        destroyNotification(notification);
+    }
+    if (m_catchNotification) {
+        destroyNotification(m_catchNotification);
+    }
+    if (m_notifier) {
+        ext_idle_notifier_v1_destroy(m_notifier);
+    }
+    if (m_seat) {
+        wl_seat_destroy(m_seat);
+    }
+    if (m_display) {
+        wl_display_flush(m_display);
+    }
+}
+
+bool WaylandIdleNotifications::initialise()
+{
+    if (m_notifier) {
+        return m_seat != 0;
+    }
+    if (!m_display) {
+        return false;
+    }
+    // enumerate the globals on a private queue so that the round-trip doesn't dispatch
+    // anybody else's events, then hand the bound objects over to the default queue.
+    wl_event_queue *queue = wl_display_create_queue(m_display);
+    wl_display *wrapper = static_cast<wl_display*>(wl_proxy_create_wrapper(m_display));
+    wl_proxy_set_queue(reinterpret_cast<wl_proxy*>(wrapper), queue);
+    wl_registry *registry = wl_display_get_registry(wrapper);
+    wl_proxy_wrapper_destroy(wrapper);
+    wl_registry_add_listener(registry, &s_registryListener, this);
+    wl_display_roundtrip_queue(m_display, queue);
+    wl_registry_destroy(registry);
+
+    if (m_notifier) {
+        wl_proxy_set_queue(reinterpret_cast<wl_proxy*>(m_notifier), 0);
+    }
+    if (m_seat) {
+        wl_proxy_set_queue(reinterpret_cast<wl_proxy*>(m_seat), 0);
+    }
+    wl_event_queue_destroy(queue);
+    return isAvailable();
+}
+
+bool WaylandIdleNotifications::isAvailable() const
+{
+    return m_notifier && m_seat;
+}
+
+void WaylandIdleNotifications::registryGlobal(void *data, wl_registry *registry, uint32_t name,
+                                              const char *interface, uint32_t version)
+{
+    WaylandIdleNotifications *self = static_cast<WaylandIdleNotifications*>(data);
+    (void) version;
+    if (!self->m_notifier && strcmp(interface, ext_idle_notifier_v1_interface.name) == 0) {
+        self->m_notifier = static_cast<ext_idle_notifier_v1*>(
+            wl_registry_bind(registry, name, &ext_idle_notifier_v1_interface, 1));
+    } else if (!self->m_seat && strcmp(interface, wl_seat_interface.name) == 0) {
+        // idle time is tracked per seat; like the other backends we follow the first one
+        self->m_seat = static_cast<wl_seat*>(wl_registry_bind(registry, name, &wl_seat_interface, 1));
+    }
+}
+
+void WaylandIdleNotifications::registryGlobalRemove(void *data, wl_registry *registry, uint32_t name)
+{
+    (void) data;
+    (void) registry;
+    (void) name;
+}
+
+WaylandIdleNotifications::Notification *WaylandIdleNotifications::createNotification(int msecs)
+{
+    Notification *notification = new Notification;
+    notification->owner = this;
+    notification->msecs = msecs;
+    notification->object = ext_idle_notifier_v1_get_idle_notification(m_notifier, uint32_t(msecs), m_seat);
+    ext_idle_notification_v1_add_listener(notification->object, &s_notificationListener, notification);
+    wl_display_flush(m_display);
+    return notification;
+}
+
+void WaylandIdleNotifications::destroyNotification(Notification *notification)
+{
+    ext_idle_notification_v1_destroy(notification->object);
+    delete notification;
+}
+
+void WaylandIdleNotifications::addTimeout(int msecs)
+{
+    if (!isAvailable() || msecs <= 0) {
+        return;
+    }
+    for (const Notification *notification : m_notifications) {
+        if (notification->msecs == msecs) {
+            return;
+        }
+    }
+    m_notifications.push_back(createNotification(msecs));
+    m_tracker.addTimeout(msecs);
+}
+
+void WaylandIdleNotifications::removeTimeout(int msecs)
+{
+    for (std::vector<Notification*>::iterator it = m_notifications.begin(); it != m_notifications.end(); ++it) {
+        if ((*it)->msecs == msecs) {
+            destroyNotification(*it);
+            m_notifications.erase(it);
+            m_tracker.removeTimeout(msecs);
+            wl_display_flush(m_display);
+            return;
+        }
+    }
+}
+
+std::vector<int> WaylandIdleNotifications::timeouts() const
+{
+    std::vector<int> result;
+    result.reserve(m_notifications.size());
+    for (const Notification *notification : m_notifications) {
+        result.push_back(notification->msecs);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void WaylandIdleNotifications::catchIdleEvent()
+{
+    if (!isAvailable() || m_catchNotification) {
+        return;
+    }
+    // a zero timeout goes idle immediately, so the next input event is reported as "resumed"
+    m_catchNotification = createNotification(0);
+}
+
+void WaylandIdleNotifications::stopCatchingIdleEvents()
+{
+    if (m_catchNotification) {
+        destroyNotification(m_catchNotification);
+        m_catchNotification = 0;
+        wl_display_flush(m_display);
+    }
+}
+
+int WaylandIdleNotifications::idleTime() const
+{
+    return m_tracker.idleTime();
+}
+
+void WaylandIdleNotifications::idled(void *data, ext_idle_notification_v1 *object)
+{
+    Notification *notification = static_cast<Notification*>(data);
+    (void) object;
+    if (notification == notification->owner->m_catchNotification) {
+        return;
+    }
+    notification->owner->m_tracker.idled(notification->msecs);
+}
+
+void WaylandIdleNotifications::resumed(void *data, ext_idle_notification_v1 *object)
+{
+    Notification *notification = static_cast<Notification*>(data);
+    WaylandIdleNotifications *self = notification->owner;
+    (void) object;
+    // the threshold notifications re-arm themselves
+    if (notification == self->m_catchNotification) {
+        self->stopCatchingIdleEvents();
+        self->m_tracker.caughtActivity();
+    } else {
+        self->m_tracker.resumed(notification->msecs);
+    }
+}
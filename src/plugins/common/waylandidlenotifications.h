@@ -0,0 +1,109 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef WAYLANDIDLENOTIFICATIONS_H
+#define WAYLANDIDLENOTIFICATIONS_H
+
+#include "idlebackend.h"
+#include "idlenotificationtracker.h"
+
+#include <vector>
+
+struct wl_display;
+struct wl_registry;
+struct wl_seat;
+struct ext_idle_notifier_v1;
+struct ext_idle_notification_v1;
+struct wl_registry_listener;
+struct ext_idle_notification_v1_listener;
+
+/**
+ * Idle timeouts pushed by a Wayland compositor through the ext-idle-notify-v1 protocol.
+ * Every registered timeout gets its own ext_idle_notification_v1 object, for which the
+ * compositor sends "idled" once the seat has been idle for that long and "resumed" at the
+ * next user activity; the client does no polling and needs no timer.
+ *
+ * Notifications are created and destroyed as timeouts are added and removed. Waiting for
+ * activity (catchIdleEvent()) uses a notification with a zero timeout: it becomes idle right
+ * away and reports the next input event as "resumed".
+ *
+ * The protocol cannot be asked for the idle time; idleTime() estimates it from the
+ * notifications' events (@see IdleNotificationTracker).
+ *
+ * The protocol objects live on the display's default event queue: their events are
+ * delivered by whoever dispatches that queue, the Qt event loop in the plugin, or
+ * wl_display_dispatch() in a standalone client (e.g. against a headless weston).
+ */
+class WaylandIdleNotifications
+{
+public:
+    /**
+     * @param clock : measures the time since the events, for idleTime()
+     */
+    WaylandIdleNotifications(wl_display *display, IdleEventListener *listener, IdleClock *clock);
+    ~WaylandIdleNotifications();
+
+    /**
+     * binds the ext_idle_notifier_v1 and wl_seat globals (one round-trip).
+     * @returns false if the compositor doesn't support the protocol.
+     */
+    bool initialise();
+    bool isAvailable() const;
+
+    void addTimeout(int msecs);
+    void removeTimeout(int msecs);
+    /**
+     * @returns the registered timeouts, in ascending order.
+     */
+    std::vector<int> timeouts() const;
+
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+
+    /**
+     * @returns an estimate of the idle time in milliseconds, without a round-trip.
+     */
+    int idleTime() const;
+
+private:
+    struct Notification {
+        WaylandIdleNotifications *owner;
+        ext_idle_notification_v1 *object;
+        int msecs;
+    };
+
+    Notification *createNotification(int msecs);
+    void destroyNotification(Notification *notification);
+
+    static void registryGlobal(void *data, wl_registry *registry, uint32_t name,
+                               const char *interface, uint32_t version);
+    static void registryGlobalRemove(void *data, wl_registry *registry, uint32_t name);
+    static void idled(void *data, ext_idle_notification_v1 *object);
+    static void resumed(void *data, ext_idle_notification_v1 *object);
+    static const wl_registry_listener s_registryListener;
+    static const ext_idle_notification_v1_listener s_notificationListener;
+
+    wl_display *m_display;
+    IdleNotificationTracker m_tracker;
+    ext_idle_notifier_v1 *m_notifier;
+    wl_seat *m_seat;
+    std::vector<Notification*> m_notifications;
+    Notification *m_catchNotification;
+};
+
+#endif /* WAYLANDIDLENOTIFICATIONS_H */
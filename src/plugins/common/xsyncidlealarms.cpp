@@ -0,0 +1,271 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "xsyncidlealarms.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+
+int64_t toInt64(const xcb_sync_int64_t &value)
+{
+    return (int64_t(value.hi) << 32) | value.lo;
+}
+
+}
+
+XSyncIdleAlarms::XSyncIdleAlarms(xcb_connection_t *connection, IdleEventListener *listener)
+    : m_connection(connection)
+    , m_listener(listener)
+    , m_idleCounter(XCB_NONE)
+    , m_alarmNotify(0)
+    , m_resetAlarm(XCB_NONE)
+    , m_resetArmed(false)
+    , m_catch(false)
+    , m_alarmEvents(0)
+{
+}
+
+XSyncIdleAlarms::~XSyncIdleAlarms()
+{
+    for (const Alarm &alarm : m_alarms) {
+        xcb_sync_destroy_alarm(m_connection, alarm.alarm);
+    }
+    if (m_resetAlarm != XCB_NONE) {
+        xcb_sync_destroy_alarm(m_connection, m_resetAlarm);
+    }
+    if (m_connection) {
+        xcb_flush(m_connection);
+    }
+}
+
+bool XSyncIdleAlarms::initialise()
+{
+    if (m_idleCounter != XCB_NONE) {
+        return true;
+    }
+    if (!m_connection) {
+        return false;
+    }
+    const xcb_query_extension_reply_t *extension = xcb_get_extension_data(m_connection, &xcb_sync_id);
+    if (!extension || !extension->present) {
+        return false;
+    }
+    m_alarmNotify = extension->first_event + XCB_SYNC_ALARM_NOTIFY;
+
+    xcb_sync_initialize_reply_t *version = xcb_sync_initialize_reply(m_connection,
+        xcb_sync_initialize(m_connection, XCB_SYNC_MAJOR_VERSION, XCB_SYNC_MINOR_VERSION), 0);
+    if (!version) {
+        return false;
+    }
+    free(version);
+
+    xcb_sync_list_system_counters_reply_t *counters = xcb_sync_list_system_counters_reply(m_connection,
+        xcb_sync_list_system_counters(m_connection), 0);
+    if (!counters) {
+        return false;
+    }
+    xcb_sync_systemcounter_iterator_t it = xcb_sync_list_system_counters_counters_iterator(counters);
+    for (; it.rem; xcb_sync_systemcounter_next(&it)) {
+        const char *name = xcb_sync_systemcounter_name(it.data);
+        const int length = xcb_sync_systemcounter_name_length(it.data);
+        if (length == 8 && strncmp(name, "IDLETIME", 8) == 0) {
+            m_idleCounter = it.data->counter;
+            break;
+        }
+    }
+    free(counters);
+    return m_idleCounter != XCB_NONE;
+}
+
+bool XSyncIdleAlarms::isAvailable() const
+{
+    return m_idleCounter != XCB_NONE;
+}
+
+void XSyncIdleAlarms::setAlarm(xcb_sync_alarm_t alarm, bool create, int64_t value, xcb_sync_testtype_t test)
+{
+    // the values appear in the order of the mask bits; 64-bit values as (hi, lo)
+    const uint32_t mask = XCB_SYNC_CA_COUNTER | XCB_SYNC_CA_VALUE_TYPE | XCB_SYNC_CA_VALUE
+        | XCB_SYNC_CA_TEST_TYPE | XCB_SYNC_CA_DELTA | XCB_SYNC_CA_EVENTS;
+    const uint32_t values[] = {
+        m_idleCounter,
+        XCB_SYNC_VALUETYPE_ABSOLUTE,
+        uint32_t(value >> 32), uint32_t(value & 0xffffffff),
+        uint32_t(test),
+        0, 0,
+        1
+    };
+    if (create) {
+        xcb_sync_create_alarm(m_connection, alarm, mask, values);
+    } else {
+        xcb_sync_change_alarm(m_connection, alarm, mask, values);
+    }
+}
+
+void XSyncIdleAlarms::addTimeout(int msecs)
+{
+    if (!isAvailable()) {
+        return;
+    }
+    for (const Alarm &alarm : m_alarms) {
+        if (alarm.msecs == msecs) {
+            return;
+        }
+    }
+    Alarm alarm = { msecs, xcb_generate_id(m_connection), false };
+    // a PositiveComparison alarm fires as soon as IDLETIME >= msecs, including right
+    // away if that is already the case
+    setAlarm(alarm.alarm, true, msecs, XCB_SYNC_TESTTYPE_POSITIVE_COMPARISON);
+    m_alarms.push_back(alarm);
+    xcb_flush(m_connection);
+}
+
+void XSyncIdleAlarms::removeTimeout(int msecs)
+{
+    for (std::vector<Alarm>::iterator it = m_alarms.begin(); it != m_alarms.end(); ++it) {
+        if (it->msecs == msecs) {
+            xcb_sync_destroy_alarm(m_connection, it->alarm);
+            m_alarms.erase(it);
+            xcb_flush(m_connection);
+            return;
+        }
+    }
+}
+
+std::vector<int> XSyncIdleAlarms::timeouts() const
+{
+    std::vector<int> list;
+    list.reserve(m_alarms.size());
+    for (const Alarm &alarm : m_alarms) {
+        list.push_back(alarm.msecs);
+    }
+    std::sort(list.begin(), list.end());
+    return list;
+}
+
+void XSyncIdleAlarms::armResetAlarm()
+{
+    if (m_resetArmed || !isAvailable()) {
+        return;
+    }
+    // fires when IDLETIME goes from >= 1 to < 1, i.e. at the next input event
+    const bool create = (m_resetAlarm == XCB_NONE);
+    if (create) {
+        m_resetAlarm = xcb_generate_id(m_connection);
+    }
+    setAlarm(m_resetAlarm, create, 1, XCB_SYNC_TESTTYPE_NEGATIVE_TRANSITION);
+    m_resetArmed = true;
+    xcb_flush(m_connection);
+}
+
+void XSyncIdleAlarms::catchIdleEvent()
+{
+    m_catch = true;
+    armResetAlarm();
+}
+
+void XSyncIdleAlarms::stopCatchingIdleEvents()
+{
+    // the reset alarm stays armed if timeouts are waiting to be re-armed
+    m_catch = false;
+}
+
+void XSyncIdleAlarms::resumed()
+{
+    m_resetArmed = false;
+    // re-activate the alarms that fired: they will fire again when the idle time
+    // reaches their value anew
+    bool changed = false;
+    for (Alarm &alarm : m_alarms) {
+        if (alarm.reached) {
+            alarm.reached = false;
+            setAlarm(alarm.alarm, false, alarm.msecs, XCB_SYNC_TESTTYPE_POSITIVE_COMPARISON);
+            changed = true;
+        }
+    }
+    if (changed) {
+        xcb_flush(m_connection);
+    }
+    if (m_catch) {
+        m_catch = false;
+        m_listener->resumingFromIdle();
+    }
+}
+
+bool XSyncIdleAlarms::handleEvent(const xcb_generic_event_t *event)
+{
+    if (!m_alarmNotify || (event->response_type & ~0x80) != m_alarmNotify) {
+        return false;
+    }
+    const xcb_sync_alarm_notify_event_t *notify = reinterpret_cast<const xcb_sync_alarm_notify_event_t*>(event);
+    if (notify->state == XCB_SYNC_ALARMSTATE_DESTROYED) {
+        return notify->alarm == m_resetAlarm || std::any_of(m_alarms.begin(), m_alarms.end(),
+            [notify](const Alarm &alarm) { return alarm.alarm == notify->alarm; });
+    }
+    if (notify->alarm == m_resetAlarm) {
+        ++m_alarmEvents;
+        if (m_resetArmed && toInt64(notify->counter_value) < toInt64(notify->alarm_value)) {
+            resumed();
+        }
+        return true;
+    }
+    for (Alarm &alarm : m_alarms) {
+        if (alarm.alarm == notify->alarm) {
+            ++m_alarmEvents;
+            // AlarmNotify is also sent when an alarm is changed or destroyed;
+            // only report actual crossings
+            if (!alarm.reached && toInt64(notify->counter_value) >= alarm.msecs) {
+                alarm.reached = true;
+                armResetAlarm();
+                m_listener->timeoutReached(alarm.msecs);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool XSyncIdleAlarms::queryIdleTime(int64_t &idle)
+{
+    if (!isAvailable()) {
+        return false;
+    }
+    xcb_sync_query_counter_reply_t *reply = xcb_sync_query_counter_reply(m_connection,
+        xcb_sync_query_counter(m_connection, m_idleCounter), 0);
+    if (!reply) {
+        return false;
+    }
+    idle = toInt64(reply->counter_value);
+    free(reply);
+    return true;
+}
+
+void XSyncIdleAlarms::resetIdleTime()
+{
+    xcb_force_screen_saver(m_connection, XCB_SCREEN_SAVER_RESET);
+    xcb_flush(m_connection);
+}
+
+int64_t XSyncIdleAlarms::alarmEvents() const
+{
+    return m_alarmEvents;
+}
@@ -0,0 +1,110 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef XSYNCIDLEALARMS_H
+#define XSYNCIDLEALARMS_H
+
+#include "idlebackend.h"
+
+#include <xcb/xcb.h>
+#include <xcb/sync.h>
+
+#include <vector>
+
+/**
+ * Idle timeouts signalled by the X server. The SYNC extension exposes the idle time as
+ * the IDLETIME system counter, and alarms can be put on counters: the server then sends
+ * an AlarmNotify event exactly when the counter crosses the alarm's value.
+ *
+ * Each registered timeout is mapped onto a PositiveComparison alarm, which fires when the
+ * idle time reaches the timeout. A single NegativeTransition alarm, armed while something
+ * is waiting for user activity (a timeout was reached, or catchIdleEvent() was called),
+ * fires when the idle time drops back to zero. No timer is involved at any point.
+ *
+ * The owner has to pass the events it receives on the connection to handleEvent().
+ * Only IdleTimeSource::queryIdleTime() needs a round-trip to the server.
+ */
+class XSyncIdleAlarms : public IdleTimeSource
+{
+public:
+    XSyncIdleAlarms(xcb_connection_t *connection, IdleEventListener *listener);
+    ~XSyncIdleAlarms();
+
+    /**
+     * initialises the SYNC extension and looks up the IDLETIME counter.
+     * @returns false if the server doesn't provide them.
+     */
+    bool initialise();
+    bool isAvailable() const;
+
+    void addTimeout(int msecs);
+    void removeTimeout(int msecs);
+    /**
+     * @returns the registered timeouts, in ascending order.
+     */
+    std::vector<int> timeouts() const;
+
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+
+    /**
+     * handles @p event if it is an AlarmNotify for one of our alarms.
+     * @returns true if the event was ours
+     */
+    bool handleEvent(const xcb_generic_event_t *event);
+
+    /**
+     * reads the IDLETIME counter (one round-trip).
+     */
+    bool queryIdleTime(int64_t &idle);
+    /**
+     * resets the server's idle time, as user input would.
+     */
+    void resetIdleTime();
+
+    /**
+     * @returns the number of AlarmNotify events handled.
+     */
+    int64_t alarmEvents() const;
+
+private:
+    struct Alarm {
+        int msecs;
+        xcb_sync_alarm_t alarm;
+        bool reached;
+    };
+
+    /**
+     * creates or (re)activates @p alarm on the IDLETIME counter.
+     */
+    void setAlarm(xcb_sync_alarm_t alarm, bool create, int64_t value, xcb_sync_testtype_t test);
+    void armResetAlarm();
+    void resumed();
+
+    xcb_connection_t *m_connection;
+    IdleEventListener *m_listener;
+    xcb_sync_counter_t m_idleCounter;
+    uint8_t m_alarmNotify;
+    std::vector<Alarm> m_alarms;
+    xcb_sync_alarm_t m_resetAlarm;
+    bool m_resetArmed;
+    bool m_catch;
+    int64_t m_alarmEvents;
+};
+
+#endif /* XSYNCIDLEALARMS_H */
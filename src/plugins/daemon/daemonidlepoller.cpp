@@ -0,0 +1,173 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "logging.h"
+#include "daemonidlepoller.h"
+
+#include <QSocketNotifier>
+#include <QTimer>
+
+namespace
+{
+// the delay before the first attempt to reconnect, doubled up to the maximum after each failure
+const int FirstReconnectDelay = 1000;
+const int MaxReconnectDelay = 60000;
+}
+
+class DaemonIdlePollerBackend : public IdleEventListener
+{
+public:
+    void timeoutReached(int msecs)
+    {
+        emit poller->timeoutReached(msecs);
+    }
+
+    void resumingFromIdle()
+    {
+        emit poller->resumingFromIdle();
+    }
+
+    DaemonIdlePoller *poller;
+};
+
+DaemonIdlePoller::DaemonIdlePoller(QObject *parent)
+    : AbstractSystemPoller(parent)
+    , m_backend(new DaemonIdlePollerBackend)
+    , m_client(0)
+    , m_notifier(0)
+    , m_reconnectTimer(new QTimer(this))
+    , m_reconnectDelay(FirstReconnectDelay)
+{
+    m_backend->poller = this;
+    m_client = new IdleDaemonClient(m_backend);
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, SIGNAL(timeout()), this, SLOT(reconnect()));
+}
+
+DaemonIdlePoller::~DaemonIdlePoller()
+{
+    unloadPoller();
+    delete m_client;
+    delete m_backend;
+}
+
+bool DaemonIdlePoller::isAvailable()
+{
+    return m_client->isConnected() || m_client->connectToDaemon();
+}
+
+bool DaemonIdlePoller::setUpPoller()
+{
+    // May already be init'ed.
+    if (m_notifier) {
+        return true;
+    }
+    if (!m_client->isConnected() && !m_client->connectToDaemon()) {
+        const std::string path = idleDaemonSocketPath();
+        if (path.empty()) {
+            qCWarning(KIDLETIME) << "XDG_RUNTIME_DIR is not set: cannot locate the idle daemon";
+        } else {
+            qCWarning(KIDLETIME) << "no idle daemon listening on" << path.c_str();
+        }
+        return false;
+    }
+    watchSocket();
+    return true;
+}
+
+void DaemonIdlePoller::watchSocket()
+{
+    m_notifier = new QSocketNotifier(m_client->fd(), QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(readEvents()));
+}
+
+void DaemonIdlePoller::unloadPoller()
+{
+    m_reconnectTimer->stop();
+    m_reconnectDelay = FirstReconnectDelay;
+    delete m_notifier;
+    m_notifier = 0;
+    m_client->disconnectFromDaemon();
+}
+
+QList<int> DaemonIdlePoller::timeouts() const
+{
+    const std::vector<int> &timeouts = m_client->timeouts();
+    QList<int> list;
+    list.reserve(int(timeouts.size()));
+    for (std::vector<int>::const_iterator it = timeouts.begin(); it != timeouts.end(); ++it) {
+        list.append(*it);
+    }
+    return list;
+}
+
+void DaemonIdlePoller::addTimeout(int nextTimeout)
+{
+    m_client->addTimeout(nextTimeout);
+}
+
+void DaemonIdlePoller::removeTimeout(int timeout)
+{
+    m_client->removeTimeout(timeout);
+}
+
+int DaemonIdlePoller::forcePollRequest()
+{
+    // a round trip to the daemon would block the GUI thread
+    return m_client->idleTime();
+}
+
+void DaemonIdlePoller::catchIdleEvent()
+{
+    m_client->catchIdleEvent();
+}
+
+void DaemonIdlePoller::stopCatchingIdleEvents()
+{
+    m_client->stopCatchingIdleEvents();
+}
+
+void DaemonIdlePoller::simulateUserActivity()
+{
+    m_client->simulateUserActivity();
+}
+
+void DaemonIdlePoller::readEvents()
+{
+    m_client->dispatch();
+    if (!m_client->isConnected()) {
+        qCWarning(KIDLETIME) << "the idle daemon went away; reconnecting";
+        // we are in a slot connected to the notifier
+        m_notifier->deleteLater();
+        m_notifier = 0;
+        m_reconnectDelay = FirstReconnectDelay;
+        m_reconnectTimer->start(m_reconnectDelay);
+    }
+}
+
+void DaemonIdlePoller::reconnect()
+{
+    // the client registers the timeouts again, and the catching of the idle period
+    if (m_client->connectToDaemon()) {
+        m_reconnectDelay = FirstReconnectDelay;
+        watchSocket();
+        return;
+    }
+    m_reconnectDelay = qMin(m_reconnectDelay * 2, MaxReconnectDelay);
+    m_reconnectTimer->start(m_reconnectDelay);
+}
@@ -0,0 +1,84 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef DAEMONIDLEPOLLER_H
+#define DAEMONIDLEPOLLER_H
+
+#include "abstractsystempoller.h"
+#include "idledaemonclient.h"
+
+class QSocketNotifier;
+class QTimer;
+class DaemonIdlePollerBackend;
+
+/**
+ * A thin proxy (plugin) for KIdleTime that leaves idle detection to the session's
+ * kidletimed daemon (@see IdleDaemon): the timeouts are registered with the daemon over
+ * its Unix-domain socket, and the events it pushes back are read when a QSocketNotifier
+ * signals them. The plugin runs no timer, queries nothing and installs no event filter,
+ * however many processes use KIdleTime.
+ *
+ * The plugin is only available while the daemon is running (@see idleDaemonSocketPath()).
+ * If the daemon goes away later, the plugin reconnects with a growing delay, and registers
+ * its timeouts again with the next daemon.
+ *
+ * forcePollRequest() reads the idle time from the daemon's shared page (@see IdleSharedPage)
+ * and returns -1 when it cannot, rather than waiting for the daemon.
+ */
+class DaemonIdlePoller: public AbstractSystemPoller
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "org.kde.kidletime.AbstractSystemPoller" FILE "daemon.json")
+    Q_INTERFACES(AbstractSystemPoller)
+
+public:
+    DaemonIdlePoller(QObject *parent = 0);
+    virtual ~DaemonIdlePoller();
+
+    bool isAvailable();
+    bool setUpPoller();
+    void unloadPoller();
+
+public Q_SLOTS:
+    void addTimeout(int nextTimeout);
+    void removeTimeout(int nextTimeout);
+    QList<int> timeouts() const;
+    int forcePollRequest();
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+    void simulateUserActivity();
+
+private Q_SLOTS:
+    void readEvents();
+    void reconnect();
+
+private:
+    void watchSocket();
+
+    /**
+     * signal relay for the client.
+     */
+    DaemonIdlePollerBackend *m_backend;
+    IdleDaemonClient *m_client;
+    QSocketNotifier *m_notifier;
+    QTimer *m_reconnectTimer;
+    int m_reconnectDelay;
+    friend class DaemonIdlePollerBackend;
+};
+
+#endif /* DAEMONIDLEPOLLER_H */
@@ -0,0 +1,165 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "logging.h"
+#include "evdevpoller.h"
+
+#include <QSocketNotifier>
+
+class EvdevIdlePollerBackend : public IdleEventListener
+{
+public:
+    void timeoutReached(int msecs)
+    {
+        emit poller->timeoutReached(msecs);
+    }
+
+    void resumingFromIdle()
+    {
+        emit poller->resumingFromIdle();
+    }
+
+    EvdevIdlePoller *poller;
+};
+
+EvdevIdlePoller::EvdevIdlePoller(QObject *parent)
+    : AbstractSystemPoller(parent)
+    , m_source(new EvdevActivitySource(&m_clock))
+    , m_notifier(0)
+    , m_timerNotifier(0)
+    , m_backend(new EvdevIdlePollerBackend)
+    , m_engine(0)
+    , m_activityFilter(0)
+{
+    m_backend->poller = this;
+    if (m_timer.fd() >= 0) {
+        m_timerNotifier = new QSocketNotifier(m_timer.fd(), QSocketNotifier::Read, this);
+        connect(m_timerNotifier, SIGNAL(activated(int)), this, SLOT(checkForIdle()));
+    }
+    m_engine = new IdleTimeoutEngine(m_source, &m_timer, m_backend, &m_clock);
+    // absolute deadlines on the timerfd, which shares the engine's clock
+    m_engine->setSchedulingMode(IdleTimeoutEngine::DeadlineScheduling);
+    m_activityFilter = new ActivityFilter(m_engine, &m_clock);
+    // every input event reaches the engine: no sampling while parked or catching
+    m_source->attachEngine(m_engine, m_activityFilter);
+}
+
+EvdevIdlePoller::~EvdevIdlePoller()
+{
+    unloadPoller();
+    // before m_timer closes the descriptor it watches
+    delete m_timerNotifier;
+    delete m_activityFilter;
+    delete m_engine;
+    delete m_backend;
+    delete m_source;
+}
+
+bool EvdevIdlePoller::isAvailable()
+{
+    return m_timerNotifier && (m_source->deviceCount() > 0 || m_source->openDevices() > 0);
+}
+
+bool EvdevIdlePoller::setUpPoller()
+{
+    // May already be init'ed.
+    if (m_notifier) {
+        return true;
+    }
+    if (!m_source->deviceCount() && !m_source->openDevices()) {
+        qCWarning(KIDLETIME) << "could not open any input device in /dev/input (is the user in the \"input\" group?)";
+        return false;
+    }
+    if (!m_timerNotifier) {
+        qCWarning(KIDLETIME) << "could not create a timerfd";
+        return false;
+    }
+    m_notifier = new QSocketNotifier(m_source->epollFd(), QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(readEvents()));
+    return true;
+}
+
+void EvdevIdlePoller::unloadPoller()
+{
+    delete m_notifier;
+    m_notifier = 0;
+    m_engine->reset();
+}
+
+IdleTimeoutList EvdevIdlePoller::timeoutList() const
+{
+    return m_engine->timeouts();
+}
+
+QList<int> EvdevIdlePoller::timeouts() const
+{
+    const IdleTimeoutList timeouts = timeoutList();
+    QList<int> list;
+    list.reserve(int(timeouts.size()));
+    for (IdleTimeoutList::const_iterator it = timeouts.begin(); it != timeouts.end(); ++it) {
+        list.append(*it);
+    }
+    return list;
+}
+
+void EvdevIdlePoller::addTimeout(int nextTimeout)
+{
+    m_engine->addTimeout(nextTimeout);
+}
+
+void EvdevIdlePoller::removeTimeout(int timeout)
+{
+    m_engine->removeTimeout(timeout);
+}
+
+int EvdevIdlePoller::forcePollRequest()
+{
+    // pick up the events that are pending but haven't been signalled yet
+    m_source->dispatch();
+    return m_engine->forcePollRequest();
+}
+
+void EvdevIdlePoller::catchIdleEvent()
+{
+    m_engine->catchIdleEvent();
+}
+
+void EvdevIdlePoller::stopCatchingIdleEvents()
+{
+    m_engine->stopCatchingIdleEvents();
+}
+
+void EvdevIdlePoller::checkForIdle()
+{
+    // the notifier can also fire for an expiry the engine has re-armed past since
+    if (m_timer.acknowledge()) {
+        m_engine->timerFired();
+    }
+}
+
+void EvdevIdlePoller::readEvents()
+{
+    // the events reach the engine through m_activityFilter
+    m_source->dispatch();
+}
+
+void EvdevIdlePoller::simulateUserActivity()
+{
+    // evdev is read-only: store an idle offset in order to simulate a (software) reset
+    m_engine->simulateUserActivity();
+}
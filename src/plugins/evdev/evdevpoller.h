@@ -0,0 +1,93 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef EVDEVPOLLER_H
+#define EVDEVPOLLER_H
+
+#include "abstractsystempoller.h"
+#include "activityfilter.h"
+#include "evdevactivitysource.h"
+#include "idletimeoutengine.h"
+#include "monotonicclock.h"
+#include "timerfdidletimer.h"
+
+class QSocketNotifier;
+class EvdevIdlePollerBackend;
+
+/**
+ * A Linux backend (plugin) implementation for KIdleTime that does not need a display
+ * server, intended for kiosks and headless machines. It reads the input events directly
+ * from the evdev devices (/dev/input/event*) through an epoll instance that is watched
+ * by a QSocketNotifier; the idle time is the time since the last event.
+ *
+ * There is no polling: the only timer is a single-shot timerfd armed for the next timeout
+ * (IdleTimeoutEngine::DeadlineScheduling), watched by a second QSocketNotifier, and input
+ * events re-arm it only when they move that deadline. Being a TimerFdIdleTimer, it spends
+ * the timer slack and lateness budgets on coalescing its expiries with other wake-ups.
+ *
+ * @note the user needs read access to the event devices, which usually means membership
+ * of the "input" group. The plugin reports itself as unavailable otherwise.
+ */
+class EvdevIdlePoller: public AbstractSystemPoller
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "org.kde.kidletime.AbstractSystemPoller" FILE "evdev.json")
+    Q_INTERFACES(AbstractSystemPoller)
+
+public:
+    EvdevIdlePoller(QObject *parent = 0);
+    virtual ~EvdevIdlePoller();
+
+    bool isAvailable();
+    bool setUpPoller();
+    void unloadPoller();
+    /**
+     * @returns the registered timeouts in ascending order, like timeouts() but without
+     * copying them; the view is valid until the next registration change.
+     */
+    IdleTimeoutList timeoutList() const;
+
+public Q_SLOTS:
+    void addTimeout(int nextTimeout);
+    void removeTimeout(int nextTimeout);
+    QList<int> timeouts() const;
+    int forcePollRequest();
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+    void simulateUserActivity();
+
+private Q_SLOTS:
+    void checkForIdle();
+    void readEvents();
+
+private:
+    MonotonicClock m_clock;
+    EvdevActivitySource *m_source;
+    QSocketNotifier *m_notifier;
+    TimerFdIdleTimer m_timer;
+    QSocketNotifier *m_timerNotifier;
+    /**
+     * signal relay for the engine.
+     */
+    EvdevIdlePollerBackend *m_backend;
+    IdleTimeoutEngine *m_engine;
+    ActivityFilter *m_activityFilter;
+    friend class EvdevIdlePollerBackend;
+};
+
+#endif /* EVDEVPOLLER_H */
@@ -22,23 +22,97 @@
 
 #include "logging.h"
 #include "macdispatcher.h"
+#include "localidledetector.h"
+#include "mactimers.h"
+#include "monotonicclock.h"
+#include "threadedidledetector.h"
 #include <CoreServices/CoreServices.h>
-#include <dispatch/dispatch.h>
 
 // #include <QDebug>
-#include <QTimer>
-
-#include <algorithm>
-
-#include <stdio.h>
+#include <QElapsedTimer>
 
 typedef OSErr(*UpdateSystemActivityPtr)(UInt8 activity);
 static UpdateSystemActivityPtr updateSystemActivity;
 
-class DispatchCallback
+// the idle time source and the clock are used from the detection thread, if there is one
+class OSXIdleDispatcherBackend : public IdleTimeSource, public IdleEventListener, public IdleClock
 {
 public:
-    static void idleHandler(void *ref);
+    OSXIdleDispatcherBackend()
+    {
+        clock.start();
+        // both count mach_absolute_time(): the GCD timer arms the engine's deadlines from here
+        clockOrigin = dispatch_time(DISPATCH_TIME_NOW, 0);
+    }
+
+    int64_t now()
+    {
+        return clock.elapsed();
+    }
+
+    int64_t suspendedTime()
+    {
+        // QElapsedTimer uses mach_absolute_time() too
+        return monotonicClock.suspendedTime();
+    }
+
+    bool queryIdleTime(int64_t &idle)
+    {
+        if (!poller->ioObject) {
+            return false;
+        }
+        // only the property we need, rather than a dictionary of all of them per poll
+        CFTypeRef cfIdle = IORegistryEntryCreateCFProperty(poller->ioObject, CFSTR("HIDIdleTime"),
+                                                           kCFAllocatorDefault, 0);
+        if (!cfIdle) {
+            return false;
+        }
+        uint64_t time = 0;
+        // cfIdle can have different types: handle them properly:
+        const CFTypeID type = CFGetTypeID(cfIdle);
+        if (type == CFDataGetTypeID()) {
+            CFDataGetBytes((CFDataRef)cfIdle, CFRangeMake(0, sizeof(time) ), (UInt8*)&time);
+        } else if (type == CFNumberGetTypeID()) {
+            CFNumberGetValue((CFNumberRef)cfIdle, kCFNumberSInt64Type, &time);
+        }
+        CFRelease(cfIdle);
+        // convert nanoseconds to milliseconds:
+        idle = int64_t(time / 1000000);
+        return true;
+    }
+
+    void timeoutReached(int msecs)
+    {
+        emit poller->timeoutReached(msecs);
+        emit poller->timeoutsReached(QList<int>() << msecs);
+    }
+
+    void timeoutsReached(const int *msecs, size_t count)
+    {
+        QList<int> list;
+        list.reserve(int(count));
+        for (size_t i = 0; i < count; ++i) {
+            list.append(msecs[i]);
+            emit poller->timeoutReached(msecs[i]);
+        }
+        emit poller->timeoutsReached(list);
+    }
+
+    void resumingFromIdle()
+    {
+        // the engine stopped catching; a slot that catches the next one acquires again
+        const bool caught = poller->m_catching;
+        poller->m_catching = false;
+        emit poller->resumingFromIdle();
+        if (caught) {
+            poller->m_activation.release();
+        }
+    }
+
+    OSXIdleDispatcher *poller;
+    QElapsedTimer clock;
+    dispatch_time_t clockOrigin;
+    MonotonicClock monotonicClock;
 };
 
 OSXIdleDispatcher::OSXIdleDispatcher(QObject *parent)
@@ -46,33 +120,114 @@ OSXIdleDispatcher::OSXIdleDispatcher(QObject *parent)
     , ioPort(0)
     , ioIterator(0)
     , ioObject(0)
-    , m_minTimeout(-1)
-    , m_maxTimeout(-1)
-    , m_lastTimeout(-1)
-    , m_nextTimeout(-1)
-    , m_NTimeouts(0)
-    , m_catch(false)
-    , m_idleDispatch(0)
-    , m_nativeGrabber(0)
+    , m_backend(new OSXIdleDispatcherBackend)
+    , m_detector(0)
+    , m_timer(0)
+    , m_strategy(idleTimerStrategyFromEnvironment(ThreadStrategy))
+    , m_activityFilter(0)
+    , m_activation([this]() { return activate(); }, [this]() { deactivate(); })
+    , m_catching(false)
+    , m_latenessBudget(-1)
+    , m_suspendPolicy(IdleTimeoutEngine::SuspendUnaware)
+    , m_pollResolution(-1)
     , m_available(true)
+    , m_nativeGrabber(0)
 {
+    m_backend->poller = this;
+    createDetector(std::vector<int>());
 }
 
 OSXIdleDispatcher::~OSXIdleDispatcher()
 {
     unloadPoller();
+    destroyDetector();
+    delete m_backend;
 }
 
-void OSXIdleDispatcher::unloadPoller()
+void OSXIdleDispatcher::createDetector(const std::vector<int> &timeouts)
 {
-    if (m_idleDispatch) {
-        if (dispatch_source_testcancel(m_idleDispatch) || !m_idleDispatchRunning) {
-            dispatch_resume(m_idleDispatch);
-        }
-        dispatch_release(m_idleDispatch);
-        m_idleDispatch = 0;
+    switch (m_strategy) {
+    case QtTimerStrategy: {
+        QtIdleTimer *timer = new QtIdleTimer;
+        LocalIdleDetector *detector = new LocalIdleDetector(m_backend, timer, m_backend, m_backend);
+        timer->setCallback([detector]() { detector->timerFired(); });
+        m_timer = timer;
+        m_detector = detector;
+        break;
     }
-    additionalUnload();
+    case GcdTimerStrategy: {
+        GcdIdleTimer *timer = new GcdIdleTimer(m_backend->clockOrigin);
+        LocalIdleDetector *detector = new LocalIdleDetector(m_backend, timer, m_backend, m_backend,
+                                                            IdleTimeoutEngine::DeadlineScheduling);
+        timer->setCallback([detector]() { detector->timerFired(); });
+        m_timer = timer;
+        m_detector = detector;
+        break;
+    }
+    default:
+        m_detector = new ThreadedIdleDetector(m_backend, m_backend, m_backend);
+        m_detector->setWakeUp([this]() {
+            QMetaObject::invokeMethod(this, "deliverEvents", Qt::QueuedConnection);
+        });
+        break;
+    }
+    m_activityFilter = new ActivityFilter(m_detector, m_backend);
+    // the filter runs on this thread, the engine possibly on another: each counts its own events
+    m_activityFilter->setStatistics(&m_detector->statistics());
+
+    if (m_pollResolution >= 0) {
+        m_detector->setPollResolution(m_pollResolution);
+    }
+    if (m_latenessBudget >= 0) {
+        m_detector->setLatenessBudget(m_latenessBudget);
+    }
+    for (QMap<int, int>::const_iterator it = m_timeoutBudgets.constBegin(); it != m_timeoutBudgets.constEnd(); ++it) {
+        m_detector->setLatenessBudget(it.key(), it.value());
+    }
+    if (m_suspendPolicy != IdleTimeoutEngine::SuspendUnaware) {
+        m_detector->setSuspendPolicy(m_suspendPolicy);
+    }
+    for (std::vector<int>::const_iterator it = timeouts.begin(); it != timeouts.end(); ++it) {
+        m_detector->addTimeout(*it);
+    }
+}
+
+void OSXIdleDispatcher::destroyDetector()
+{
+    delete m_activityFilter;
+    m_activityFilter = 0;
+    // the detector stops its timer
+    delete m_detector;
+    m_detector = 0;
+    delete m_timer;
+    m_timer = 0;
+}
+
+bool OSXIdleDispatcher::setTimerStrategy(IdleTimerStrategy strategy)
+{
+    if (strategy == m_strategy) {
+        return true;
+    }
+    if (m_activation.isActive() || !idleTimerStrategyAvailable(strategy)) {
+        return false;
+    }
+    const std::vector<int> timeouts = m_detector->timeouts().toVector();
+    destroyDetector();
+    m_strategy = strategy;
+    createDetector(timeouts);
+    return true;
+}
+
+IdleTimerStrategy OSXIdleDispatcher::timerStrategy() const
+{
+    return m_strategy;
+}
+
+void OSXIdleDispatcher::unloadPoller()
+{
+    // the detector (possibly on its own thread) uses ioObject
+    m_activation.reset();
+    m_catching = false;
     if (ioObject) {
         IOObjectRelease( ioObject );
         ioObject = 0;
@@ -81,8 +236,6 @@ void OSXIdleDispatcher::unloadPoller()
         IOObjectRelease( ioIterator );
         ioIterator = 0;
     }
-    m_lastTimeout = -1;
-    m_nextTimeout = -1;
     m_available = false;
 }
 
@@ -92,6 +245,17 @@ bool OSXIdleDispatcher::isAvailable()
 }
 
 bool OSXIdleDispatcher::setUpPoller()
+{
+    // everything else waits for the first consumer: see activate()
+    m_available = true;
+    if (!m_detector->timeouts().empty() && !m_activation.isActive()) {
+        // set up again after unloadPoller()
+        m_activation.acquire();
+    }
+    return true;
+}
+
+bool OSXIdleDispatcher::setUpIdleSource()
 {
     // May already be init'ed.
     if (ioObject) {
@@ -138,241 +302,149 @@ bool OSXIdleDispatcher::setUpPoller()
     IOObjectRetain(ioObject);
     IOObjectRetain(ioIterator);
 
-    m_idleDispatch = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER,
-        0, DISPATCH_TIMER_STRICT, DISPATCH_TARGET_QUEUE_DEFAULT);
-    if (m_idleDispatch) {
-        dispatch_source_set_event_handler_f(m_idleDispatch, DispatchCallback::idleHandler);
-        dispatch_set_context(m_idleDispatch, this);
-        m_idleDispatchRunning = false;
-    } else {
-        qCWarning(KIDLETIME) << "failure creating a GCD timer source";
-        return false;
-    }
+    return true;
+}
 
-    if (!additionalSetUp()) {
-        qCWarning(KIDLETIME) << "failure installing the native Cocoa filter for detecting end-of-idle events";
+bool OSXIdleDispatcher::activate()
+{
+    if (!setUpIdleSource()) {
+        m_available = false;
         return false;
     }
-    m_realIdle = 0;
-    m_available = true;
+    m_detector->start();
 
+    // without the filter, the end of an idle period is caught by sampling the idle time
+    const bool filtering = additionalSetUp();
+    if (!filtering) {
+        qCWarning(KIDLETIME) << "failure installing the native Cocoa filter for detecting end-of-idle events,"
+                                " falling back to polling";
+    }
+    m_detector->setActivityEventsAvailable(filtering);
     return true;
 }
 
+void OSXIdleDispatcher::deactivate()
+{
+    additionalUnload();
+    // the engine keeps the registrations while the detector is stopped
+    m_detector->stop();
+}
+
+IdleTimeoutList OSXIdleDispatcher::timeoutList() const
+{
+    return m_detector->timeouts();
+}
+
 QList<int> OSXIdleDispatcher::timeouts() const
 {
-    return m_timeouts;
+    const IdleTimeoutList timeouts = timeoutList();
+    QList<int> list;
+    list.reserve(int(timeouts.size()));
+    for (IdleTimeoutList::const_iterator it = timeouts.begin(); it != timeouts.end(); ++it) {
+        list.append(*it);
+    }
+    return list;
 }
 
 void OSXIdleDispatcher::addTimeout(int nextTimeout)
 {
-    if (!m_timeouts.contains(nextTimeout)) {
-        m_timeouts.append(nextTimeout);
-        std::sort(m_timeouts.begin(), m_timeouts.end());
-        if (nextTimeout < m_minTimeout || m_minTimeout < 0) {
-            m_minTimeout = nextTimeout;
-        }
-        if (nextTimeout > m_maxTimeout) {
-            m_maxTimeout = nextTimeout;
-        }
-        m_NTimeouts = m_timeouts.count();
-        // this is about the only place except for setUpPoller() where
-        // we can reset m_realIdle;
-        m_realIdle = 0;
-        kickTimer(poll(false));
+    const bool first = m_detector->timeouts().empty();
+    m_detector->addTimeout(nextTimeout);
+    if (first) {
+        m_activation.acquire();
     }
 }
 
 void OSXIdleDispatcher::removeTimeout(int timeout)
 {
-    m_timeouts.removeOne(timeout);
-    std::sort(m_timeouts.begin(), m_timeouts.end());
-    m_minTimeout = -1, m_maxTimeout = -1;
-    Q_FOREACH (int i, m_timeouts) {
-        if (i < m_minTimeout || m_minTimeout < 0) {
-            m_minTimeout = i;
-        }
-        if (i > m_maxTimeout) {
-            m_maxTimeout = i;
-        }
+    if (m_detector->timeouts().empty()) {
+        return;
     }
-    if (m_lastTimeout == timeout) {
-        m_lastTimeout = -1;
-        m_nextTimeout = -2;
+    m_detector->removeTimeout(timeout);
+    if (m_detector->timeouts().empty()) {
+        m_activation.release();
     }
-    m_NTimeouts = m_timeouts.count();
-    poll(false);
 }
 
-void DispatchCallback::idleHandler(void *ref)
+void OSXIdleDispatcher::deliverEvents()
 {
-    OSXIdleDispatcher *poller = static_cast<OSXIdleDispatcher*>(ref);
-    int64_t elapsed = dispatch_time(DISPATCH_TIME_NOW, 0ll) - poller->timerSet;
-    fprintf( stderr, "idleHandler called after %gms\n", elapsed / 1000000.0 ); fflush(stderr);
-    poller->checkForIdleFunction();
+    m_detector->deliverEvents();
 }
 
-void OSXIdleDispatcher::kickTimer(int64_t idle)
+void OSXIdleDispatcher::setLatenessBudget(int msecs)
 {
-    if (!m_NTimeouts) {
-        qDebug() << "kickTimer called with an empty timeouts list";
-    } else {
-        if (m_nextTimeout < 0) {
-            m_nextTimeout = m_minTimeout;
-        }
-        int64_t currentMinTimeout = m_nextTimeout;
-        // change the poll timer interval if there is reason to change it.
-        // NB: to minimise CPU load wake-ups to the utmost extent, we could consider an
-        // option to set the interval to "remainingTime - 1ms" as long as that is >= 1ms,
-        // but then the question becomes how to continue polling from there.
-        if (idle < currentMinTimeout) {
-            int interval = currentMinTimeout - idle;
-//             fprintf( stderr, "idleTimer interval set to (%lld-%lld)/2=%d, next timeout=%d\n",
-//                      currentMinTimeout, idle, interval, m_nextTimeout);
-            if (m_idleDispatch) {
-                timerSet = dispatch_time(DISPATCH_TIME_NOW, 0ll);
-                int64_t delta = interval * 1000000ull;
-                // set the source to dispatch first when we want to read out the idle time (= ballistically)
-                dispatch_source_set_timer(m_idleDispatch, timerSet + delta, DISPATCH_TIME_FOREVER, interval * 10000ull);
-                if (!m_idleDispatchRunning) {
-                    dispatch_resume(m_idleDispatch);
-                    m_idleDispatchRunning = true;
-                }
-            }
-        }
-    }
+    m_latenessBudget = msecs >= 0 ? msecs : -1;
+    m_detector->setLatenessBudget(msecs);
 }
 
-int64_t OSXIdleDispatcher::poll(bool allowEmit, int64_t &idle)
+bool OSXIdleDispatcher::setPollerResolution(int msecs)
 {
-    kern_return_t status;
-    CFTypeRef cfIdle;
-    CFTypeID type;
-    uint64_t time = 0;
-    CFMutableDictionaryRef properties = 0;
-    status = IORegistryEntryCreateCFProperties(ioObject, &properties, kCFAllocatorDefault, 0);
-    if (status == KERN_SUCCESS && properties) {
-        cfIdle = CFDictionaryGetValue(properties, CFSTR("HIDIdleTime"));
-        if (cfIdle) {
-            CFRetain(cfIdle);
-            // cfIdle can have different types: handle them properly:
-            type = CFGetTypeID(cfIdle);
-            if (type == CFDataGetTypeID()) {
-                CFDataGetBytes((CFDataRef)cfIdle, CFRangeMake(0, sizeof(time) ), (UInt8*)&time);
-            } else if (type == CFNumberGetTypeID()) {
-                CFNumberGetValue((CFNumberRef)cfIdle, kCFNumberSInt64Type, &time);
-            }
-            CFRelease(cfIdle);
-        }
-        CFRelease((CFTypeRef)properties);
-        // convert nanoseconds to milliseconds:
-        idle = int64_t(time / 1000000);
-        if (idle < m_realIdle) {
-            fprintf(stderr, "idle==%lld < previous value %lld\n", idle, m_realIdle); fflush(stderr);
-            // an input event was missed, possibly because additionalSetUp() failed
-            resumedFromIdle();
-        } else if (idle < m_idleOffset) {
-            // reset the idle offset if the idle time dropped below it
-            m_idleOffset = 0;
-        }
-        m_realIdle = idle;
-    }
-
-    int64_t offsetIdle = idle - m_idleOffset;
-    if (allowEmit) {
-        // we don't use Q_FOREACH because we want an easy access to the timeout value after the current one
-        QList<int>::const_iterator iter;
-        for (iter = m_timeouts.constBegin(); iter != m_timeouts.constEnd(); ++iter) {
-            int i = *iter;
-            // m_timeouts is sorted so we can simply check for offsetIdle>=i
-            if (i != m_lastTimeout && i > m_lastTimeout && offsetIdle >= i) {
-                // Bingo!
-                m_lastTimeout = i;
-                if (i < m_maxTimeout) {
-                    m_nextTimeout = iter[1];
-                }
-                qDebug() << ">>> timeout" << i << "hit at idle" << offsetIdle << "(offset,real idle=="
-                    << m_idleOffset << idle << "); next timeout:" << m_nextTimeout;
-
-                if (m_minTimeout > 0) {
-                    kickTimer(offsetIdle);
-                } else {
-                    // there are no valid timeout periods; stop the timer to avoid
-                    // useless overhead
-                    if (m_idleDispatchRunning) {
-                        dispatch_suspend(m_idleDispatch);
-                        m_idleDispatchRunning = false;
-                    }
-                }
-
-                emit timeoutReached(i);
-                return offsetIdle;
-            }
-        }
-    }
-
-    // return the "virtual" idle i.e. the time since the last simulateUserActivity(),
-    // not the actual idle time!
-    return offsetIdle;
+    m_pollResolution = msecs >= 0 ? msecs : -1;
+    m_detector->setPollResolution(m_pollResolution);
+    return true;
 }
 
-int64_t OSXIdleDispatcher::poll(bool allowEmits)
+bool OSXIdleDispatcher::getPollerResolution(int &msecs)
 {
-    int64_t idle;
-    return poll(allowEmits, idle);
+    msecs = m_pollResolution;
+    // this plugin supports setting the polling resolution so we return true
+    return true;
 }
 
-int OSXIdleDispatcher::forcePollRequest()
+int OSXIdleDispatcher::latenessBudget() const
 {
-    return int(poll(false));
+    return m_latenessBudget;
 }
 
-void OSXIdleDispatcher::detectedActivity()
+void OSXIdleDispatcher::setLatenessBudget(int timeout, int msecs)
 {
-    if (m_catch) {
-        emit resumingFromIdle();
+    if (msecs >= 0) {
+        m_timeoutBudgets.insert(timeout, msecs);
+    } else {
+        m_timeoutBudgets.remove(timeout);
     }
-    stopCatchingIdleEvents();
+    m_detector->setLatenessBudget(timeout, msecs);
 }
 
-void OSXIdleDispatcher::catchIdleEvent()
+void OSXIdleDispatcher::setSuspendPolicy(IdleTimeoutEngine::SuspendPolicy policy)
 {
-    m_catch = true;
+    m_suspendPolicy = policy;
+    m_detector->setSuspendPolicy(policy);
 }
 
-void OSXIdleDispatcher::stopCatchingIdleEvents()
+IdleStatistics::Snapshot OSXIdleDispatcher::statistics() const
 {
-    // this slot is called after resumingFromIdle, and should not stop the poll timer
-    // because that also drives the timeout detection. The m_catch state variable
-    // indicates whether resuming-from-idle events should be caught or not.
-    m_catch = false;
+    return m_detector->statistics().snapshot();
 }
 
-void OSXIdleDispatcher::resumedFromIdle()
+void OSXIdleDispatcher::resetStatistics()
 {
-    m_idleOffset = 0;
-    m_lastTimeout = -1;
-    m_nextTimeout = m_minTimeout;
+    m_detector->statistics().reset();
 }
 
-void OSXIdleDispatcher::checkForIdleFunction()
+int OSXIdleDispatcher::forcePollRequest()
 {
-    if (m_NTimeouts || m_catch) {
-        int64_t idle = poll(true);
-//         fprintf(stderr, "checkForIdleFunction: idle=%lld, nextTimeout=%d\n", idle, m_nextTimeout); fflush(stderr);
-        if (m_NTimeouts && idle < m_nextTimeout) {
-            kickTimer(idle);
-        }
-        if (idle == 0 && m_catch) {
-            resumedFromIdle();
-            emit resumingFromIdle();
-        }
+    // querying the idle time does not need the event filter nor a running detector
+    setUpIdleSource();
+    return m_detector->forcePollRequest();
+}
+
+void OSXIdleDispatcher::catchIdleEvent()
+{
+    if (!m_catching) {
+        m_catching = true;
+        m_activation.acquire();
     }
+    m_detector->catchIdleEvent();
 }
 
-void OSXIdleDispatcher::checkForIdle()
+void OSXIdleDispatcher::stopCatchingIdleEvents()
 {
-    checkForIdleFunction();
+    m_detector->stopCatchingIdleEvents();
+    if (m_catching) {
+        m_catching = false;
+        m_activation.release();
+    }
 }
 
 void OSXIdleDispatcher::simulateUserActivity()
@@ -381,6 +453,7 @@ void OSXIdleDispatcher::simulateUserActivity()
     //     IOReturn success = IOPMAssertionCreateWithName(kIOPMAssertionTypeNoDisplaySleep,
     //                                                    kIOPMAssertionLevelOn, CFSTR("simulated user activity"), &assertionID);
     // coupled with a timer to re-allow sleep, but there are reports that isn't very reliable.
+    setUpIdleSource();
     if (updateSystemActivity) {
         (*updateSystemActivity)(UsrActivity);
     }
@@ -397,8 +470,6 @@ void OSXIdleDispatcher::simulateUserActivity()
 //     CFRelease(move1);
 //     CFRelease(event);
     // store an idle offset in order to simulate a (software) reset
-    resumedFromIdle();
-    kickTimer(poll(false, m_idleOffset));
-//     m_nextTimeout = -1;
+    m_detector->simulateUserActivity();
 }
 
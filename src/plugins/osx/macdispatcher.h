@@ -21,18 +21,20 @@
 #define MACPOLLER_H
 
 #include "abstractsystempoller.h"
+#include "activityfilter.h"
+#include "idleactivation.h"
+#include "idledetector.h"
+#include "idletimerstrategy.h"
 
 #include <QAbstractNativeEventFilter>
-
-#include <QTimer>
+#include <QMap>
 
 // Use IOKIT instead of the deprecated Carbon interface
 #include <IOKit/IOKitLib.h>
-// Use GCD instead of a QTimer
-#include <dispatch/dispatch.h>
 
 class QWidget;
-class DispatchCallback;
+class OSXIdleDispatcherBackend;
+class IdleTimer;
 
 /**
  * This is a modernised Macintosh backend (plugin) implementation for KIdleTime.
@@ -46,6 +48,22 @@ class DispatchCallback;
  * good detection accuracy. The class does provide a mechanism to switch it to a
  * fixed-frequency polling strategy of configurable resolution, but that mechanism
  * isn't yet accessible via the KIdleTime class.
+ *
+ * What wakes up the detection is selected at runtime (@see IdleTimerStrategy), with
+ * setTimerStrategy() or the KIDLETIME_TIMER_STRATEGY environment variable:
+ * - "thread" (the default): detection runs on a thread of its own (@see ThreadedIdleDetector),
+ *   so that it is not delayed when the GUI thread is busy; the events are handed back to the
+ *   GUI thread through a queue and signalled from there, and the registrations travel the
+ *   other way;
+ * - "qt": a QTimer on the GUI thread, re-armed adaptively;
+ * - "gcd": a GCD timer source on the main queue, armed for absolute deadlines whose leeway
+ *   lets the system coalesce the wake-ups.
+ * "timerfd" does not exist on OS X and selects the default.
+ *
+ * setUpPoller() only does what is cheap. The IOKit service is looked up by the first call
+ * that needs the idle time; the event monitor and the detection thread are set up when the
+ * first timeout is added or catchIdleEvent() is called, and torn down again once there
+ * are no timeouts left and no idle event to catch (@see IdleActivation).
  * 
  * @note polling comes at a cost. This cost is minimised with the default, adaptive interval
  * configuration, but applications should not let the KIdleTime instance active when it 
@@ -66,6 +84,57 @@ public:
     bool setUpPoller();
     void unloadPoller();
 
+    /**
+     * @returns the runtime counters and the detection lateness histogram accumulated since
+     * the poller was created or resetStatistics() was last called. Cheap enough to be
+     * called from a debugging UI at any rate.
+     */
+    IdleStatistics::Snapshot statistics() const;
+    void resetStatistics();
+    /**
+     * allow timeouts to be reported up to @p msecs milliseconds late (-1 for no preference),
+     * so that the wake-ups can be coalesced to save power.
+     * @see IdleTimeoutEngine::setLatenessBudget()
+     */
+    void setLatenessBudget(int msecs);
+    int latenessBudget() const;
+    /**
+     * sets the lateness budget of the timeout @p timeout only (-1 to revert to the poller's).
+     */
+    void setLatenessBudget(int timeout, int msecs);
+    /**
+     * selects how the time the Mac spends asleep enters the idle time; the wake-up is
+     * picked up from NSWorkspace. @see IdleTimeoutEngine::SuspendPolicy
+     */
+    void setSuspendPolicy(IdleTimeoutEngine::SuspendPolicy policy);
+    /**
+     * switch the idle time polling engine to the specified interval in milliseconds
+     * or back to the default scheduling of the timer strategy.
+     * @param msecs : the desired polling interval in milliseconds, or -1 for the default
+     * algoritm.
+     * @returns true (this class supports a fixed interval with every strategy).
+     * @note setLatenessBudget() expresses what this is usually meant for (a bound on the
+     * detection delay) without polling more than needed.
+     */
+    bool setPollerResolution(int msecs);
+    /**
+     * query the current polling interval, which will be -1 for the default interval
+     * @returns true (this class supports changing the interval)
+     */
+    bool getPollerResolution(int &msecs);
+    /**
+     * selects what wakes up the detection. Only possible while it is not set up, i.e.
+     * before the first timeout is added or after they have all been removed.
+     * @returns false if the poller is in use or @p strategy is not available on OS X.
+     */
+    bool setTimerStrategy(IdleTimerStrategy strategy);
+    IdleTimerStrategy timerStrategy() const;
+    /**
+     * @returns the registered timeouts in ascending order, like timeouts() but without
+     * copying them; the view is valid until the next registration change.
+     */
+    IdleTimeoutList timeoutList() const;
+
 public Q_SLOTS:
     void addTimeout(int nextTimeout);
     void removeTimeout(int nextTimeout);
@@ -75,37 +144,21 @@ public Q_SLOTS:
     void stopCatchingIdleEvents();
     void simulateUserActivity();
 
-private Q_SLOTS:
-    void checkForIdle();
-    void detectedActivity();
-
-private:
-    /**
-     * Query IOKit for the current HIDIdleTime value, and return it. Also compares the current idle
-     * time to the registered list of timeouts, and emits a \c timeoutReached signal when
-     * a hit is found.
-     * @param allowEmits : should timeoutReached() signals be emitted?
-     * @param idle : returns the current true idle time (time without input events)
-     * @returns : the simulated idle time (time without input events and since the last
-     * call to simulateUserActivity).
-     */
-    int64_t poll(bool allowEmits, int64_t &idle);
+Q_SIGNALS:
     /**
-     * Query IOKit for the current HIDIdleTime value, and return it. Also compares the current idle
-     * time to the registered list of timeouts, and emits a \c timeoutReached signal when
-     * a hit is found.
-     * @param allowEmits : should timeoutReached() signals be emitted?
-     * @returns : the simulated idle time (time without input events and since the last
-     * call to simulateUserActivity).
+     * emitted after timeoutReached() with all the timeouts that were reached at the same
+     * time, in ascending order; most of the time that is a single one. Consumers that can
+     * handle them together connect to this signal instead of timeoutReached().
      */
-    int64_t poll(bool allowEmits);
-    void resumedFromIdle();
+    void timeoutsReached(const QList<int> &msecs);
+
+private Q_SLOTS:
     /**
-     * when the adaptive interval is used, this function reconfigures the idle polling
-     * timer as a function of the current idle time. The timer is stopped when no timeouts
-     * are to be monitored.
+     * emits the events queued by the detection thread (with the thread strategy).
      */
-    void kickTimer(int64_t idle);
+    void deliverEvents();
+
+private:
     /**
      * sets up the Cocoa global events filter.
      * @returns true in case of success
@@ -115,29 +168,61 @@ private:
      * takes down the Cocoa global events filter.
      */
     void additionalUnload();
-    void checkForIdleFunction();
-    QList<int> m_timeouts;
+    /**
+     * loads UpdateSystemActivity and looks up the IOHID service, if not done already.
+     * @returns true if the idle time can be queried
+     */
+    bool setUpIdleSource();
+    /**
+     * the second phase of the set-up: the detector and the event filter.
+     */
+    bool activate();
+    void deactivate();
+    /**
+     * creates the detector (and its timer) of the current strategy, with the settings
+     * made so far and the given timeouts.
+     */
+    void createDetector(const std::vector<int> &timeouts);
+    void destroyDetector();
     mach_port_t ioPort;
     io_iterator_t ioIterator;
     io_object_t ioObject;
-    dispatch_source_t m_idleDispatch;
-    bool m_idleDispatchRunning;
-    dispatch_time_t timerSet;
-    int m_minTimeout,
-        m_maxTimeout,
-        m_NTimeouts;
-    int m_lastTimeout,
-        m_nextTimeout;
-    int64_t m_realIdle,
-        m_idleOffset;
-    bool m_catch;
+    /**
+     * IOKit idle time source, clock and signal relay for the detector.
+     */
+    OSXIdleDispatcherBackend *m_backend;
+    /**
+     * the platform-independent timeout bookkeeping, woken up according to m_strategy.
+     */
+    IdleDetector *m_detector;
+    /**
+     * the timer of a detector that runs on this thread, or null.
+     */
+    IdleTimer *m_timer;
+    IdleTimerStrategy m_strategy;
+    /**
+     * classifies and coalesces the events seen by the Cocoa event filter.
+     */
+    ActivityFilter *m_activityFilter;
+    /**
+     * counts the timeout list and catching the idle event as consumers of the detection.
+     */
+    IdleActivation m_activation;
+    bool m_catching;
+    /**
+     * the settings, applied again to the detector of a new strategy.
+     */
+    int m_latenessBudget;
+    QMap<int, int> m_timeoutBudgets;
+    IdleTimeoutEngine::SuspendPolicy m_suspendPolicy;
+    int m_pollResolution;
     bool m_available;
     /**
      * instance of a class that "contains" the Cocoa global event filter.
      */
     QAbstractNativeEventFilter *m_nativeGrabber;
     friend class CocoaEventFilter;
-    friend class DispatchCallback;
+    friend class OSXIdleDispatcherBackend;
 };
 
 #endif /* MACPOLLER_H */
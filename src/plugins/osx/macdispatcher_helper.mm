@@ -43,19 +43,17 @@ public:
     {
         Q_UNUSED(eventType)
         Q_UNUSED(result)
-        Q_UNUSED(message)
-        if (poller->m_NTimeouts) {
-            poller->poll(true);
-        }
-        if (poller->m_catch) {
-            // don't call out of this function if unnecessary
-            poller->detectedActivity();
-        }
+        // the global monitor only hands us input events, but the application-wide filter
+        // sees every native event, including those that don't indicate user activity.
+        NSEvent *event = static_cast<NSEvent*>(message);
+        const bool isInput = event && (NSEventMaskFromType([event type]) & mask);
+        poller->m_activityFilter->event(isInput ? ActivityFilter::InputEvent : ActivityFilter::OtherEvent);
         return false;
     };
 
     OSXIdleDispatcher *poller;
     id m_monitorId;
+    id m_wakeObserver;
 };
 
 bool OSXIdleDispatcher::additionalSetUp()
@@ -66,6 +64,7 @@ bool OSXIdleDispatcher::additionalSetUp()
         // quick and dirty, no real point in going through a setter
         nativeGrabber->poller = this;
         nativeGrabber->m_monitorId = 0;
+        nativeGrabber->m_wakeObserver = 0;
         m_nativeGrabber = nativeGrabber;
         QCoreApplication::processEvents();
         @autoreleasepool {
@@ -73,6 +72,12 @@ bool OSXIdleDispatcher::additionalSetUp()
                 handler:^(NSEvent* event) { m_nativeGrabber->nativeEventFilter("NSEventFromGlobalMonitor", event, 0); }];
         }
         if (nativeGrabber->m_monitorId) {
+            @autoreleasepool {
+                // for the suspend policy: account for the sleep as soon as the Mac wakes up
+                nativeGrabber->m_wakeObserver = [[[NSWorkspace sharedWorkspace] notificationCenter]
+                    addObserverForName:NSWorkspaceDidWakeNotification object:nil queue:[NSOperationQueue mainQueue]
+                    usingBlock:^(NSNotification *) { m_detector->systemResumed(); }];
+            }
             qApp->installNativeEventFilter(m_nativeGrabber);
             QCoreApplication::processEvents();
             ret = true;
@@ -95,6 +100,11 @@ void OSXIdleDispatcher::additionalUnload()
                  [NSEvent removeMonitor:nativeGrabber->m_monitorId];
             }
         }
+        if (nativeGrabber->m_wakeObserver) {
+            @autoreleasepool {
+                [[[NSWorkspace sharedWorkspace] notificationCenter] removeObserver:nativeGrabber->m_wakeObserver];
+            }
+        }
         delete nativeGrabber;
         m_nativeGrabber = 0;
     }
@@ -0,0 +1,172 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "mactimers.h"
+
+#include <QTimer>
+
+#include <algorithm>
+
+QtIdleTimer::QtIdleTimer()
+    : m_timer(new QTimer)
+{
+    QObject::connect(m_timer, &QTimer::timeout, [this]() {
+        if (m_callback) {
+            m_callback();
+        }
+    });
+}
+
+QtIdleTimer::~QtIdleTimer()
+{
+    delete m_timer;
+}
+
+void QtIdleTimer::setCallback(const std::function<void()> &callback)
+{
+    m_callback = callback;
+}
+
+void QtIdleTimer::start(int64_t msecs)
+{
+    m_timer->setTimerType(msecs < 5 ? Qt::PreciseTimer : Qt::CoarseTimer);
+    if (m_timer->isActive()) {
+        m_timer->setInterval(int(msecs));
+    } else {
+        m_timer->start(int(msecs));
+    }
+}
+
+void QtIdleTimer::startAt(int64_t deadline, int64_t now, int64_t slack)
+{
+    // spend the slack on a coarser timer type. Those can also fire a little early, which
+    // the engine handles by re-arming for the remainder; the interval is lengthened
+    // so that the timer is not late by more than the slack.
+    int64_t interval = std::max(deadline - now, int64_t(0));
+    Qt::TimerType type = Qt::PreciseTimer;
+    if (slack >= 1000) {
+        // rounded to the nearest second
+        type = Qt::VeryCoarseTimer;
+        interval += 500;
+    } else if (interval >= 20 && slack * 9 >= interval) {
+        // within 5% of the interval
+        type = Qt::CoarseTimer;
+        interval += interval / 20;
+    }
+    m_timer->setTimerType(type);
+    if (m_timer->isActive()) {
+        m_timer->setInterval(int(interval));
+    } else {
+        m_timer->start(int(interval));
+    }
+}
+
+void QtIdleTimer::stop()
+{
+    m_timer->stop();
+}
+
+bool QtIdleTimer::isActive() const
+{
+    return m_timer->isActive();
+}
+
+int64_t QtIdleTimer::interval() const
+{
+    return m_timer->interval();
+}
+
+GcdIdleTimer::GcdIdleTimer(dispatch_time_t origin)
+    : m_source(dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_main_queue()))
+    , m_origin(origin)
+    , m_interval(0)
+    , m_active(false)
+    , m_repeating(false)
+{
+    dispatch_set_context(m_source, this);
+    dispatch_source_set_event_handler_f(m_source, &GcdIdleTimer::fired);
+    // a timer source is created suspended; it stays resumed and is disarmed instead
+    dispatch_source_set_timer(m_source, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+    dispatch_resume(m_source);
+}
+
+GcdIdleTimer::~GcdIdleTimer()
+{
+    dispatch_source_cancel(m_source);
+    dispatch_release(m_source);
+}
+
+void GcdIdleTimer::setCallback(const std::function<void()> &callback)
+{
+    m_callback = callback;
+}
+
+void GcdIdleTimer::fired(void *context)
+{
+    GcdIdleTimer *timer = static_cast<GcdIdleTimer*>(context);
+    if (!timer->m_active) {
+        // stopped after the source fired
+        return;
+    }
+    if (!timer->m_repeating) {
+        timer->m_active = false;
+    }
+    if (timer->m_callback) {
+        timer->m_callback();
+    }
+}
+
+void GcdIdleTimer::start(int64_t msecs)
+{
+    const uint64_t interval = uint64_t(std::max(msecs, int64_t(0))) * NSEC_PER_MSEC;
+    // the same leeway as the daemon's timerfd with 1% slack
+    dispatch_source_set_timer(m_source, dispatch_time(DISPATCH_TIME_NOW, int64_t(interval)),
+                              interval, uint64_t(msecs) * 10000);
+    m_interval = msecs;
+    m_active = true;
+    m_repeating = true;
+}
+
+void GcdIdleTimer::startAt(int64_t deadline, int64_t now, int64_t slack)
+{
+    // the deadline itself rather than the time remaining from now, so that the delay between
+    // the engine reading its clock and this call does not push the expiry back; a deadline
+    // already past fires at once
+    const dispatch_time_t when = dispatch_time(m_origin, std::max(deadline, int64_t(0)) * int64_t(NSEC_PER_MSEC));
+    dispatch_source_set_timer(m_source, when, DISPATCH_TIME_FOREVER,
+                              uint64_t(std::max(slack, int64_t(0))) * NSEC_PER_MSEC);
+    m_interval = std::max(deadline - now, int64_t(0));
+    m_active = true;
+    m_repeating = false;
+}
+
+void GcdIdleTimer::stop()
+{
+    dispatch_source_set_timer(m_source, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+    m_active = false;
+}
+
+bool GcdIdleTimer::isActive() const
+{
+    return m_active;
+}
+
+int64_t GcdIdleTimer::interval() const
+{
+    return m_interval;
+}
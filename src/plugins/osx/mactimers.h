@@ -0,0 +1,92 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef MACTIMERS_H
+#define MACTIMERS_H
+
+#include "idlebackend.h"
+
+#include <dispatch/dispatch.h>
+
+#include <functional>
+
+class QTimer;
+
+/**
+ * The IdleTimer of the Qt timer strategy: a repeating QTimer on the owner's thread.
+ * The timer type follows the precision the engine asks for: precise for short intervals,
+ * coarser when a deadline comes with enough slack.
+ */
+class QtIdleTimer : public IdleTimer
+{
+public:
+    QtIdleTimer();
+    ~QtIdleTimer();
+
+    /**
+     * @param callback : called on each expiry
+     */
+    void setCallback(const std::function<void()> &callback);
+
+    void start(int64_t msecs);
+    void startAt(int64_t deadline, int64_t now, int64_t slack);
+    void stop();
+    bool isActive() const;
+    int64_t interval() const;
+
+private:
+    QTimer *m_timer;
+    std::function<void()> m_callback;
+};
+
+/**
+ * The IdleTimer of the GCD strategy: a timer source on the main dispatch queue. Deadlines
+ * are handed to GCD as absolute dispatch times with the slack as leeway, so that the system
+ * can coalesce the wake-up with others; intervals get a leeway of 1% like the QTimer's
+ * CoarseTimer.
+ */
+class GcdIdleTimer : public IdleTimer
+{
+public:
+    /**
+     * @param origin : the dispatch time at which the engine's clock reads 0. The clock must
+     * count the mach_absolute_time() uptime in milliseconds, as QElapsedTimer does on OS X.
+     */
+    explicit GcdIdleTimer(dispatch_time_t origin);
+    ~GcdIdleTimer();
+
+    void setCallback(const std::function<void()> &callback);
+
+    void start(int64_t msecs);
+    void startAt(int64_t deadline, int64_t now, int64_t slack);
+    void stop();
+    bool isActive() const;
+    int64_t interval() const;
+
+private:
+    static void fired(void *context);
+
+    dispatch_source_t m_source;
+    dispatch_time_t m_origin;
+    std::function<void()> m_callback;
+    int64_t m_interval;
+    bool m_active;
+    bool m_repeating;
+};
+
+#endif /* MACTIMERS_H */
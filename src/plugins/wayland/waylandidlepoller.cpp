@@ -0,0 +1,132 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "logging.h"
+#include "waylandidlepoller.h"
+
+#include <QGuiApplication>
+#include <qpa/qplatformnativeinterface.h>
+
+class WaylandIdlePollerBackend : public IdleEventListener
+{
+public:
+    void timeoutReached(int msecs)
+    {
+        emit poller->timeoutReached(msecs);
+    }
+
+    void resumingFromIdle()
+    {
+        emit poller->resumingFromIdle();
+    }
+
+    WaylandIdlePoller *poller;
+};
+
+static wl_display *waylandDisplay()
+{
+    QPlatformNativeInterface *native = QGuiApplication::platformNativeInterface();
+    if (!native || !QGuiApplication::platformName().startsWith(QLatin1String("wayland"))) {
+        return 0;
+    }
+    return static_cast<wl_display*>(native->nativeResourceForIntegration(QByteArrayLiteral("wl_display")));
+}
+
+WaylandIdlePoller::WaylandIdlePoller(QObject *parent)
+    : AbstractSystemPoller(parent)
+    , m_backend(new WaylandIdlePollerBackend)
+    , m_notifications(0)
+    , m_available(true)
+    , m_warnedIdleTime(false)
+{
+    m_backend->poller = this;
+    m_notifications = new WaylandIdleNotifications(waylandDisplay(), m_backend, &m_clock);
+}
+
+WaylandIdlePoller::~WaylandIdlePoller()
+{
+    unloadPoller();
+    delete m_notifications;
+    delete m_backend;
+}
+
+bool WaylandIdlePoller::isAvailable()
+{
+    return m_available && m_notifications->initialise();
+}
+
+bool WaylandIdlePoller::setUpPoller()
+{
+    if (!m_notifications->initialise()) {
+        qCWarning(KIDLETIME) << "the compositor does not support the ext-idle-notify-v1 protocol";
+        m_available = false;
+        return false;
+    }
+    m_available = true;
+    return true;
+}
+
+void WaylandIdlePoller::unloadPoller()
+{
+    m_notifications->stopCatchingIdleEvents();
+}
+
+QList<int> WaylandIdlePoller::timeouts() const
+{
+    const std::vector<int> timeouts = m_notifications->timeouts();
+    QList<int> list;
+    list.reserve(int(timeouts.size()));
+    for (std::vector<int>::const_iterator it = timeouts.begin(); it != timeouts.end(); ++it) {
+        list.append(*it);
+    }
+    return list;
+}
+
+void WaylandIdlePoller::addTimeout(int nextTimeout)
+{
+    m_notifications->addTimeout(nextTimeout);
+}
+
+void WaylandIdlePoller::removeTimeout(int timeout)
+{
+    m_notifications->removeTimeout(timeout);
+}
+
+int WaylandIdlePoller::forcePollRequest()
+{
+    if (!m_warnedIdleTime) {
+        qCWarning(KIDLETIME) << "ext-idle-notify-v1 does not expose the current idle time; it is estimated from the idle notifications";
+        m_warnedIdleTime = true;
+    }
+    return m_notifications->idleTime();
+}
+
+void WaylandIdlePoller::catchIdleEvent()
+{
+    m_notifications->catchIdleEvent();
+}
+
+void WaylandIdlePoller::stopCatchingIdleEvents()
+{
+    m_notifications->stopCatchingIdleEvents();
+}
+
+void WaylandIdlePoller::simulateUserActivity()
+{
+    qCWarning(KIDLETIME) << "ext-idle-notify-v1 does not allow resetting the idle time";
+}
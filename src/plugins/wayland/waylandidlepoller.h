@@ -0,0 +1,72 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef WAYLANDIDLEPOLLER_H
+#define WAYLANDIDLEPOLLER_H
+
+#include "abstractsystempoller.h"
+#include "monotonicclock.h"
+#include "waylandidlenotifications.h"
+
+class WaylandIdlePollerBackend;
+
+/**
+ * A Wayland backend (plugin) implementation for KIdleTime built on the compositor's
+ * ext-idle-notify-v1 protocol: every timeout is a notification object for which the
+ * compositor itself reports "idled" and "resumed" (@see WaylandIdleNotifications).
+ * The events are dispatched by Qt's own Wayland event loop; the plugin uses no timer
+ * and never polls. The protocol offers no way to query or reset the idle time:
+ * forcePollRequest() returns an estimate from the last notification events, and
+ * simulateUserActivity() is not supported.
+ */
+class WaylandIdlePoller: public AbstractSystemPoller
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "org.kde.kidletime.AbstractSystemPoller" FILE "wayland.json")
+    Q_INTERFACES(AbstractSystemPoller)
+
+public:
+    WaylandIdlePoller(QObject *parent = 0);
+    virtual ~WaylandIdlePoller();
+
+    bool isAvailable();
+    bool setUpPoller();
+    void unloadPoller();
+
+public Q_SLOTS:
+    void addTimeout(int nextTimeout);
+    void removeTimeout(int nextTimeout);
+    QList<int> timeouts() const;
+    int forcePollRequest();
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+    void simulateUserActivity();
+
+private:
+    /**
+     * signal relay for the notifications.
+     */
+    WaylandIdlePollerBackend *m_backend;
+    MonotonicClock m_clock;
+    WaylandIdleNotifications *m_notifications;
+    bool m_available;
+    bool m_warnedIdleTime;
+    friend class WaylandIdlePollerBackend;
+};
+
+#endif /* WAYLANDIDLEPOLLER_H */
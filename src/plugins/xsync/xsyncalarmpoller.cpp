@@ -0,0 +1,150 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "logging.h"
+#include "xsyncalarmpoller.h"
+
+#include <QCoreApplication>
+#include <QX11Info>
+
+class XSyncAlarmPollerBackend : public IdleEventListener
+{
+public:
+    void timeoutReached(int msecs)
+    {
+        emit poller->timeoutReached(msecs);
+    }
+
+    void resumingFromIdle()
+    {
+        emit poller->resumingFromIdle();
+    }
+
+    XSyncAlarmPoller *poller;
+};
+
+class XcbEventFilter : public QAbstractNativeEventFilter
+{
+public:
+    bool nativeEventFilter(const QByteArray &eventType, void *message, long *result)
+    {
+        Q_UNUSED(result)
+        if (eventType == "xcb_generic_event_t") {
+            // alarm notifications are of no interest to anyone else
+            return alarms->handleEvent(static_cast<xcb_generic_event_t*>(message));
+        }
+        return false;
+    }
+
+    XSyncIdleAlarms *alarms;
+};
+
+XSyncAlarmPoller::XSyncAlarmPoller(QObject *parent)
+    : AbstractSystemPoller(parent)
+    , m_backend(new XSyncAlarmPollerBackend)
+    , m_alarms(0)
+    , m_nativeGrabber(0)
+    , m_available(true)
+{
+    m_backend->poller = this;
+    m_alarms = new XSyncIdleAlarms(QX11Info::connection(), m_backend);
+}
+
+XSyncAlarmPoller::~XSyncAlarmPoller()
+{
+    unloadPoller();
+    delete m_alarms;
+    delete m_backend;
+}
+
+bool XSyncAlarmPoller::isAvailable()
+{
+    return m_available && QX11Info::isPlatformX11() && m_alarms->initialise();
+}
+
+bool XSyncAlarmPoller::setUpPoller()
+{
+    // May already be init'ed.
+    if (m_nativeGrabber) {
+        return true;
+    }
+    if (!m_alarms->initialise()) {
+        qCWarning(KIDLETIME) << "the X server does not provide the SYNC extension's IDLETIME counter";
+        m_available = false;
+        return false;
+    }
+    XcbEventFilter *nativeGrabber = new XcbEventFilter;
+    nativeGrabber->alarms = m_alarms;
+    m_nativeGrabber = nativeGrabber;
+    qApp->installNativeEventFilter(m_nativeGrabber);
+    m_available = true;
+    return true;
+}
+
+void XSyncAlarmPoller::unloadPoller()
+{
+    if (m_nativeGrabber) {
+        qApp->removeNativeEventFilter(m_nativeGrabber);
+        delete m_nativeGrabber;
+        m_nativeGrabber = 0;
+    }
+}
+
+QList<int> XSyncAlarmPoller::timeouts() const
+{
+    const std::vector<int> timeouts = m_alarms->timeouts();
+    QList<int> list;
+    list.reserve(int(timeouts.size()));
+    for (std::vector<int>::const_iterator it = timeouts.begin(); it != timeouts.end(); ++it) {
+        list.append(*it);
+    }
+    return list;
+}
+
+void XSyncAlarmPoller::addTimeout(int nextTimeout)
+{
+    m_alarms->addTimeout(nextTimeout);
+}
+
+void XSyncAlarmPoller::removeTimeout(int timeout)
+{
+    m_alarms->removeTimeout(timeout);
+}
+
+int XSyncAlarmPoller::forcePollRequest()
+{
+    int64_t idle = 0;
+    m_alarms->queryIdleTime(idle);
+    return int(idle);
+}
+
+void XSyncAlarmPoller::catchIdleEvent()
+{
+    m_alarms->catchIdleEvent();
+}
+
+void XSyncAlarmPoller::stopCatchingIdleEvents()
+{
+    m_alarms->stopCatchingIdleEvents();
+}
+
+void XSyncAlarmPoller::simulateUserActivity()
+{
+    // this resets IDLETIME on the server, so the alarms behave as after real input
+    m_alarms->resetIdleTime();
+}
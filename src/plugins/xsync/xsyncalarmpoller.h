@@ -0,0 +1,73 @@
+/* This file is part of the KDE libraries
+   Copyright (C) 2026 The KIdleTime authors
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef XSYNCALARMPOLLER_H
+#define XSYNCALARMPOLLER_H
+
+#include "abstractsystempoller.h"
+#include "xsyncidlealarms.h"
+
+#include <QAbstractNativeEventFilter>
+
+class XSyncAlarmPollerBackend;
+
+/**
+ * An X11 backend (plugin) implementation for KIdleTime that lets the X server do all
+ * the work: every timeout is an alarm on the SYNC extension's IDLETIME counter, and
+ * resuming from idle is signalled by a negative-transition alarm on the same counter
+ * (@see XSyncIdleAlarms). The alarm notifications arrive as ordinary X events through
+ * a native event filter; the plugin uses no timer and never polls.
+ */
+class XSyncAlarmPoller: public AbstractSystemPoller
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "org.kde.kidletime.AbstractSystemPoller" FILE "xcb.json")
+    Q_INTERFACES(AbstractSystemPoller)
+
+public:
+    XSyncAlarmPoller(QObject *parent = 0);
+    virtual ~XSyncAlarmPoller();
+
+    bool isAvailable();
+    bool setUpPoller();
+    void unloadPoller();
+
+public Q_SLOTS:
+    void addTimeout(int nextTimeout);
+    void removeTimeout(int nextTimeout);
+    QList<int> timeouts() const;
+    int forcePollRequest();
+    void catchIdleEvent();
+    void stopCatchingIdleEvents();
+    void simulateUserActivity();
+
+private:
+    /**
+     * signal relay for the alarms.
+     */
+    XSyncAlarmPollerBackend *m_backend;
+    XSyncIdleAlarms *m_alarms;
+    /**
+     * instance of a class that "contains" the xcb native event filter.
+     */
+    QAbstractNativeEventFilter *m_nativeGrabber;
+    bool m_available;
+    friend class XSyncAlarmPollerBackend;
+};
+
+#endif /* XSYNCALARMPOLLER_H */